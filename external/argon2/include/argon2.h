@@ -455,6 +455,12 @@ ARGON2_PUBLIC size_t argon2_encodedlen(uint32_t t_cost, uint32_t m_cost,
  */
 ARGON2_PUBLIC void argon2_select_impl(FILE *out, const char *prefix);
 
+/**
+ * Returns the name of the implementation picked by argon2_select_impl, or
+ * "(default)" if it has not been called or found nothing better.
+ */
+ARGON2_PUBLIC const char *argon2_selected_impl_name(void);
+
 /* signals support for passing preallocated memory: */
 #define ARGON2_PREALLOCATED_MEMORY
 
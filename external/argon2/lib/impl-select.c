@@ -118,3 +118,8 @@ void argon2_select_impl(FILE *out, const char *prefix)
     }
     select_impl(out, prefix);
 }
+
+const char *argon2_selected_impl_name(void)
+{
+    return selected_argon_impl.name;
+}
@@ -22,14 +22,24 @@ namespace CryptoNote
             const uint64_t writeBufferMB,
             const uint64_t readCacheMB,
             const uint64_t maxFileSizeMB,
-            const bool enableDbCompression) :
+            const bool enableDbCompression,
+            const uint64_t keyImageCacheMB,
+            const uint64_t rawBlockCacheMB,
+            const uint64_t rawBlockBlockSizeKB,
+            const uint64_t bloomFilterBitsPerKey,
+            const bool enableBlobFiles) :
             dataDir(dataDirectory),
             backgroundThreadsCount(backgroundThreads),
             maxOpenFiles(openFiles),
             writeBufferSize(writeBufferMB * 1024 * 1024),
             readCacheSize(readCacheMB * 1024 * 1024),
             maxFileSize(maxFileSizeMB * 1024 * 1024),
-            compressionEnabled(enableDbCompression)
+            compressionEnabled(enableDbCompression),
+            keyImageCacheSize(keyImageCacheMB * 1024 * 1024),
+            rawBlockCacheSize(rawBlockCacheMB * 1024 * 1024),
+            rawBlockBlockSize(rawBlockBlockSizeKB * 1024),
+            bloomBitsPerKey(bloomFilterBitsPerKey),
+            blobFilesEnabled(enableBlobFiles)
         {
         }
 
@@ -46,6 +56,25 @@ namespace CryptoNote
         uint64_t maxFileSize;
 
         bool compressionEnabled;
+
+        /* The options below are only used by RocksDB, which keeps each key
+           prefix in its own column family */
+
+        /* Block cache for the spent key image families, separate from readCacheSize */
+        uint64_t keyImageCacheSize;
+
+        /* Block cache for the raw block family, separate from readCacheSize */
+        uint64_t rawBlockCacheSize;
+
+        uint64_t rawBlockBlockSize;
+
+        /* Bloom filter bits per key for the families looked up by hash. Zero
+           disables the filters. */
+        uint64_t bloomBitsPerKey;
+
+        /* Keeps raw blocks in RocksDB blob files rather than in the table
+           files */
+        bool blobFilesEnabled;
     };
 
     class IDataBase
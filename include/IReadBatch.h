@@ -6,17 +6,46 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 namespace CryptoNote
 {
+    /* Every key in [begin, end), in key order, or in reverse key order. A limit
+       of zero reads the whole range. */
+    struct RawKeyRange
+    {
+        std::string begin;
+
+        std::string end;
+
+        size_t limit = 0;
+
+        bool reverse = false;
+    };
+
     class IReadBatch
     {
       public:
         virtual std::vector<std::string> getRawKeys() const = 0;
 
-        virtual void submitRawResult(const std::vector<std::string> &values, const std::vector<bool> &resultStates) = 0;
+        /* The values only point into the database's read buffers, and are only
+           valid until this returns */
+        virtual void
+            submitRawResult(const std::vector<std::string_view> &values, const std::vector<bool> &resultStates) = 0;
+
+        virtual std::vector<RawKeyRange> getRawKeyRanges() const
+        {
+            return {};
+        }
+
+        /* Called after submitRawResult, with the key value pairs found in each
+           of the ranges from getRawKeyRanges */
+        virtual void
+            submitRawRangeResult(const std::vector<std::vector<std::pair<std::string, std::string>>> &keyValues)
+        {
+        }
     };
 
 } // namespace CryptoNote
@@ -18,3 +18,24 @@ Crypto::Hash CryptoNote::getBinaryArrayHash(const BinaryArray &binaryArray)
     getBinaryArrayHash(binaryArray, hash);
     return hash;
 }
+
+std::vector<Crypto::Hash> CryptoNote::getBinaryArrayHashes(const std::vector<BinaryArray> &binaryArrays)
+{
+    std::vector<const void *> data;
+    std::vector<size_t> lengths;
+
+    data.reserve(binaryArrays.size());
+    lengths.reserve(binaryArrays.size());
+
+    for (const auto &binaryArray : binaryArrays)
+    {
+        data.push_back(binaryArray.data());
+        lengths.push_back(binaryArray.size());
+    }
+
+    std::vector<Crypto::Hash> hashes(binaryArrays.size());
+
+    Crypto::cn_fast_hash_multi(data.data(), lengths.data(), data.size(), reinterpret_cast<char *>(hashes.data()));
+
+    return hashes;
+}
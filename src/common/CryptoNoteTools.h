@@ -22,6 +22,9 @@ namespace CryptoNote
 
     Crypto::Hash getBinaryArrayHash(const BinaryArray &binaryArray);
 
+    /* The hash of each binary array, hashing several at once where the CPU allows */
+    std::vector<Crypto::Hash> getBinaryArrayHashes(const std::vector<BinaryArray> &binaryArrays);
+
     template<class T> bool getObjectBinarySize(const T &object, size_t &size)
     {
         BinaryArray ba;
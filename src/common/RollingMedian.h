@@ -0,0 +1,117 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <set>
+
+namespace Common
+{
+    /* The median of the last windowSize values pushed, kept up to date in
+       O(log n) per push, rather than sorting the window on every read.
+       Returns the same value as medianValue over the window. */
+    template<class T> class RollingMedian
+    {
+      public:
+        explicit RollingMedian(size_t windowSize): windowSize(windowSize) {}
+
+        void push(T value)
+        {
+            values.push_back(value);
+            insert(value);
+
+            if (values.size() > windowSize)
+            {
+                erase(values.front());
+                values.pop_front();
+            }
+        }
+
+        T median() const
+        {
+            if (lower.empty())
+            {
+                return T();
+            }
+
+            if (lower.size() > upper.size())
+            {
+                return *lower.rbegin();
+            }
+
+            return (*lower.rbegin() + *upper.begin()) / 2;
+        }
+
+        size_t size() const
+        {
+            return values.size();
+        }
+
+        void clear()
+        {
+            values.clear();
+            lower.clear();
+            upper.clear();
+        }
+
+      private:
+        void insert(T value)
+        {
+            if (lower.empty() || value <= *lower.rbegin())
+            {
+                lower.insert(value);
+            }
+            else
+            {
+                upper.insert(value);
+            }
+
+            rebalance();
+        }
+
+        void erase(T value)
+        {
+            if (value <= *lower.rbegin())
+            {
+                lower.erase(lower.find(value));
+            }
+            else
+            {
+                upper.erase(upper.find(value));
+            }
+
+            rebalance();
+        }
+
+        /* Keeps lower the same size as upper, or one larger, so the median is
+           at the top of lower, or between it and the bottom of upper */
+        void rebalance()
+        {
+            if (lower.size() > upper.size() + 1)
+            {
+                upper.insert(*lower.rbegin());
+                lower.erase(std::prev(lower.end()));
+            }
+            else if (upper.size() > lower.size())
+            {
+                lower.insert(*upper.begin());
+                upper.erase(upper.begin());
+            }
+        }
+
+        size_t windowSize;
+
+        /* In push order, so the oldest can be dropped */
+        std::deque<T> values;
+
+        /* The smaller half of the window */
+        std::multiset<T> lower;
+
+        /* The larger half of the window */
+        std::multiset<T> upper;
+    };
+} // namespace Common
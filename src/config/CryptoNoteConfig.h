@@ -221,6 +221,11 @@ namespace CryptoNote
            to help curtail fusion transaction spam. */
         const size_t FUSION_TX_MAX_POOL_COUNT = 70;
 
+        /* The maximum amount of transactions we remember as having had their
+           ring signatures verified when they were added to the pool. Blocks
+           containing these transactions do not have to verify them again. */
+        const size_t VERIFIED_TRANSACTION_CACHE_SIZE = 10000;
+
         const size_t NORMAL_TX_MAX_OUTPUT_COUNT_V1 = 90;
 
         const size_t NORMAL_TX_MAX_OUTPUT_COUNT_V1_HEIGHT = 2200000;
@@ -324,6 +329,20 @@ namespace CryptoNote
             {BLOCK_MAJOR_VERSION_6, Crypto::chukwa_slow_hash_v1} /* UPGRADE_HEIGHT_V6 */
     };
 
+    /* The block versions whose proof of work can hash several nonces at once,
+       used by the miner. Versions missing from here are hashed one at a time
+       with HASHING_ALGORITHMS_BY_BLOCK_VERSION. */
+    const std::unordered_map<
+        uint8_t,
+        std::function<void(const void *const *data, size_t length, Crypto::Hash *hashes, size_t count)>>
+        MULTI_HASHING_ALGORITHMS_BY_BLOCK_VERSION = {
+            {BLOCK_MAJOR_VERSION_1, Crypto::cn_slow_hash_v0_multi},
+            {BLOCK_MAJOR_VERSION_2, Crypto::cn_slow_hash_v0_multi},
+            {BLOCK_MAJOR_VERSION_3, Crypto::cn_slow_hash_v0_multi},
+            {BLOCK_MAJOR_VERSION_4, Crypto::cn_lite_slow_hash_v1_multi},
+            {BLOCK_MAJOR_VERSION_5, Crypto::cn_turtle_lite_slow_hash_v2_multi}
+    };
+
     const size_t BLOCKS_IDS_SYNCHRONIZING_DEFAULT_COUNT = 10000; // by default, blocks ids count in synchronizing
     const uint64_t BLOCKS_SYNCHRONIZING_DEFAULT_COUNT = 100; // by default, blocks count in blocks downloading
     const size_t COMMAND_RPC_GET_BLOCKS_FAST_MAX_COUNT = 1000;
@@ -370,6 +389,10 @@ namespace CryptoNote
     const uint64_t ROCKSDB_READ_BUFFER_MB = 256; // 256 MB
     const uint64_t ROCKSDB_MAX_OPEN_FILES = 125; // 125 files
     const uint64_t ROCKSDB_BACKGROUND_THREADS = 4; // 4 DB threads
+    const uint64_t ROCKSDB_KEY_IMAGE_CACHE_MB = 128; // 128 MB
+    const uint64_t ROCKSDB_RAW_BLOCK_CACHE_MB = 64; // 64 MB
+    const uint64_t ROCKSDB_RAW_BLOCK_BLOCK_SIZE_KB = 64; // 64 KB
+    const uint64_t ROCKSDB_BLOOM_BITS_PER_KEY = 10; // ~1% false positives
 
     const uint64_t LEVELDB_WRITE_BUFFER_MB = 64; // 64 MB
     const uint64_t LEVELDB_READ_BUFFER_MB = 64; // 64 MB
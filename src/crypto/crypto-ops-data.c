@@ -3,6 +3,8 @@
 //
 // Please see the included LICENSE file for more information.
 
+#if !defined(CRYPTO_FE_RADIX_51)
+
 #include "crypto-ops.h"
 
 #include <stdint.h>
@@ -860,3 +862,5 @@ const fe fe_fffb4 = {
     -8444712,
     3212926,
     6885324}; /* sqrt(sqrt(-1) * A * (A + 2)) */
+
+#endif
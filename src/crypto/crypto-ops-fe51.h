@@ -0,0 +1,313 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+/*
+Field arithmetic mod 2^255 - 19 with five 51 bit limbs, using 64x64 -> 128 bit
+multiplication. A drop in replacement for the ref10 fe_* functions in
+crypto-ops.c, selected with CRYPTO_FE_RADIX_51. Only included from
+crypto-ops.c.
+
+Every function leaves its result weakly reduced: each limb is below
+2^51 + 2^15. fe_mul and fe_sq rely on this to keep their intermediate
+products within 128 bits.
+*/
+
+#pragma once
+
+#if !defined(__SIZEOF_INT128__)
+#error "CRYPTO_FE_RADIX_51 requires a compiler with 128 bit integer support"
+#endif
+
+typedef unsigned __int128 fe_uint128;
+
+static const uint64_t fe_mask51 = (((uint64_t)1) << 51) - 1;
+
+static uint64_t load_8(const unsigned char *in)
+{
+    uint64_t result = 0;
+    int i;
+
+    for (i = 7; i >= 0; i--)
+    {
+        result = (result << 8) | in[i];
+    }
+
+    return result;
+}
+
+static void store_8(unsigned char *out, uint64_t in)
+{
+    int i;
+
+    for (i = 0; i < 8; i++)
+    {
+        out[i] = (unsigned char)in;
+        in >>= 8;
+    }
+}
+
+/* Carries the top bits of each limb into the next, wrapping the top limb
+   around multiplied by 19 */
+static void fe_carry(fe h)
+{
+    const uint64_t c0 = h[0] >> 51;
+    const uint64_t c1 = h[1] >> 51;
+    const uint64_t c2 = h[2] >> 51;
+    const uint64_t c3 = h[3] >> 51;
+    const uint64_t c4 = h[4] >> 51;
+
+    h[0] = (h[0] & fe_mask51) + c4 * 19;
+    h[1] = (h[1] & fe_mask51) + c0;
+    h[2] = (h[2] & fe_mask51) + c1;
+    h[3] = (h[3] & fe_mask51) + c2;
+    h[4] = (h[4] & fe_mask51) + c3;
+}
+
+/*
+h = 0
+*/
+
+static void fe_0(fe h)
+{
+    h[0] = 0;
+    h[1] = 0;
+    h[2] = 0;
+    h[3] = 0;
+    h[4] = 0;
+}
+
+/*
+h = 1
+*/
+
+static void fe_1(fe h)
+{
+    h[0] = 1;
+    h[1] = 0;
+    h[2] = 0;
+    h[3] = 0;
+    h[4] = 0;
+}
+
+/*
+h = f + g
+Can overlap h with f or g.
+*/
+
+static void fe_add(fe h, const fe f, const fe g)
+{
+    h[0] = f[0] + g[0];
+    h[1] = f[1] + g[1];
+    h[2] = f[2] + g[2];
+    h[3] = f[3] + g[3];
+    h[4] = f[4] + g[4];
+
+    fe_carry(h);
+}
+
+/*
+h = f - g
+Can overlap h with f or g.
+*/
+
+static void fe_sub(fe h, const fe f, const fe g)
+{
+    /* Add 2p first, so the limbs can't go negative */
+    h[0] = (f[0] + 0xFFFFFFFFFFFDAULL) - g[0];
+    h[1] = (f[1] + 0xFFFFFFFFFFFFEULL) - g[1];
+    h[2] = (f[2] + 0xFFFFFFFFFFFFEULL) - g[2];
+    h[3] = (f[3] + 0xFFFFFFFFFFFFEULL) - g[3];
+    h[4] = (f[4] + 0xFFFFFFFFFFFFEULL) - g[4];
+
+    fe_carry(h);
+}
+
+/*
+h = -f
+*/
+
+static void fe_neg(fe h, const fe f)
+{
+    fe zero;
+
+    fe_0(zero);
+    fe_sub(h, zero, f);
+}
+
+/*
+Replace (f,g) with (g,g) if b == 1;
+replace (f,g) with (f,g) if b == 0.
+
+Preconditions: b in {0,1}.
+*/
+
+static void fe_cmov(fe f, const fe g, unsigned int b)
+{
+    const uint64_t mask = (uint64_t)0 - (uint64_t)b;
+
+    f[0] ^= (f[0] ^ g[0]) & mask;
+    f[1] ^= (f[1] ^ g[1]) & mask;
+    f[2] ^= (f[2] ^ g[2]) & mask;
+    f[3] ^= (f[3] ^ g[3]) & mask;
+    f[4] ^= (f[4] ^ g[4]) & mask;
+}
+
+/*
+h = f
+*/
+
+static void fe_copy(fe h, const fe f)
+{
+    h[0] = f[0];
+    h[1] = f[1];
+    h[2] = f[2];
+    h[3] = f[3];
+    h[4] = f[4];
+}
+
+/* Reduces the 128 bit column sums of a product or square to a weakly
+   reduced field element */
+static void fe_reduce_wide(fe h, fe_uint128 r0, fe_uint128 r1, fe_uint128 r2, fe_uint128 r3, fe_uint128 r4)
+{
+    const uint64_t c0 = (uint64_t)(r0 >> 51);
+    const uint64_t c1 = (uint64_t)(r1 >> 51);
+    const uint64_t c2 = (uint64_t)(r2 >> 51);
+    const uint64_t c3 = (uint64_t)(r3 >> 51);
+    const uint64_t c4 = (uint64_t)(r4 >> 51);
+
+    h[0] = ((uint64_t)r0 & fe_mask51) + c4 * 19;
+    h[1] = ((uint64_t)r1 & fe_mask51) + c0;
+    h[2] = ((uint64_t)r2 & fe_mask51) + c1;
+    h[3] = ((uint64_t)r3 & fe_mask51) + c2;
+    h[4] = ((uint64_t)r4 & fe_mask51) + c3;
+
+    fe_carry(h);
+}
+
+/*
+h = f * g
+Can overlap h with f or g.
+*/
+
+static void fe_mul(fe h, const fe f, const fe g)
+{
+    const uint64_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+    const uint64_t g0 = g[0], g1 = g[1], g2 = g[2], g3 = g[3], g4 = g[4];
+
+    /* 2^255 = 19, so limbs which overflow the top wrap around times 19 */
+    const uint64_t g1_19 = g1 * 19;
+    const uint64_t g2_19 = g2 * 19;
+    const uint64_t g3_19 = g3 * 19;
+    const uint64_t g4_19 = g4 * 19;
+
+    const fe_uint128 r0 = (fe_uint128)f0 * g0 + (fe_uint128)f1 * g4_19 + (fe_uint128)f2 * g3_19
+                          + (fe_uint128)f3 * g2_19 + (fe_uint128)f4 * g1_19;
+
+    const fe_uint128 r1 = (fe_uint128)f0 * g1 + (fe_uint128)f1 * g0 + (fe_uint128)f2 * g4_19
+                          + (fe_uint128)f3 * g3_19 + (fe_uint128)f4 * g2_19;
+
+    const fe_uint128 r2 = (fe_uint128)f0 * g2 + (fe_uint128)f1 * g1 + (fe_uint128)f2 * g0
+                          + (fe_uint128)f3 * g4_19 + (fe_uint128)f4 * g3_19;
+
+    const fe_uint128 r3 = (fe_uint128)f0 * g3 + (fe_uint128)f1 * g2 + (fe_uint128)f2 * g1
+                          + (fe_uint128)f3 * g0 + (fe_uint128)f4 * g4_19;
+
+    const fe_uint128 r4 = (fe_uint128)f0 * g4 + (fe_uint128)f1 * g3 + (fe_uint128)f2 * g2
+                          + (fe_uint128)f3 * g1 + (fe_uint128)f4 * g0;
+
+    fe_reduce_wide(h, r0, r1, r2, r3, r4);
+}
+
+/*
+h = f * f
+Can overlap h with f.
+*/
+
+static void fe_sq(fe h, const fe f)
+{
+    const uint64_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+
+    const uint64_t f0_2 = f0 * 2;
+    const uint64_t f1_2 = f1 * 2;
+    const uint64_t f1_38 = f1 * 38;
+    const uint64_t f2_38 = f2 * 38;
+    const uint64_t f3_38 = f3 * 38;
+    const uint64_t f3_19 = f3 * 19;
+    const uint64_t f4_19 = f4 * 19;
+
+    const fe_uint128 r0 = (fe_uint128)f0 * f0 + (fe_uint128)f1_38 * f4 + (fe_uint128)f2_38 * f3;
+
+    const fe_uint128 r1 = (fe_uint128)f0_2 * f1 + (fe_uint128)f2_38 * f4 + (fe_uint128)f3_19 * f3;
+
+    const fe_uint128 r2 = (fe_uint128)f0_2 * f2 + (fe_uint128)f1 * f1 + (fe_uint128)f3_38 * f4;
+
+    const fe_uint128 r3 = (fe_uint128)f0_2 * f3 + (fe_uint128)f1_2 * f2 + (fe_uint128)f4_19 * f4;
+
+    const fe_uint128 r4 = (fe_uint128)f0_2 * f4 + (fe_uint128)f1_2 * f3 + (fe_uint128)f2 * f2;
+
+    fe_reduce_wide(h, r0, r1, r2, r3, r4);
+}
+
+/*
+h = 2 * f * f
+Can overlap h with f.
+*/
+
+static void fe_sq2(fe h, const fe f)
+{
+    fe_sq(h, f);
+    fe_add(h, h, h);
+}
+
+/*
+Reads a little endian field element, ignoring the top bit.
+*/
+
+static void fe_frombytes(fe h, const unsigned char *s)
+{
+    h[0] = load_8(s) & fe_mask51;
+    h[1] = (load_8(s + 6) >> 3) & fe_mask51;
+    h[2] = (load_8(s + 12) >> 6) & fe_mask51;
+    h[3] = (load_8(s + 19) >> 1) & fe_mask51;
+    h[4] = (load_8(s + 24) >> 12) & fe_mask51;
+}
+
+/*
+Writes the canonical little endian encoding of h, the unique value in
+[0, p) equal to h mod p.
+*/
+
+static void fe_tobytes(unsigned char *s, const fe h)
+{
+    fe t;
+    uint64_t q;
+
+    fe_copy(t, h);
+    fe_carry(t);
+
+    /* t < 2^255 + 2^15, so q is 1 if t >= p, and 0 otherwise */
+    q = (t[0] + 19) >> 51;
+    q = (t[1] + q) >> 51;
+    q = (t[2] + q) >> 51;
+    q = (t[3] + q) >> 51;
+    q = (t[4] + q) >> 51;
+
+    /* t - q * p = t + 19 * q - q * 2^255 */
+    t[0] += 19 * q;
+
+    t[1] += t[0] >> 51;
+    t[0] &= fe_mask51;
+    t[2] += t[1] >> 51;
+    t[1] &= fe_mask51;
+    t[3] += t[2] >> 51;
+    t[2] &= fe_mask51;
+    t[4] += t[3] >> 51;
+    t[3] &= fe_mask51;
+    t[4] &= fe_mask51;
+
+    store_8(s, t[0] | (t[1] << 51));
+    store_8(s + 8, (t[1] >> 13) | (t[2] << 38));
+    store_8(s + 16, (t[2] >> 26) | (t[3] << 25));
+    store_8(s + 24, (t[3] >> 39) | (t[4] << 12));
+}
@@ -47,6 +47,12 @@ static uint64_t load_4(const unsigned char *in)
     return result;
 }
 
+#if defined(CRYPTO_FE_RADIX_51)
+
+#include "crypto-ops-fe51.h"
+
+#else
+
 /* From fe_0.c */
 
 /*
@@ -240,6 +246,8 @@ static void fe_copy(fe h, const fe f)
     h[9] = f9;
 }
 
+#endif
+
 /* From fe_invert.c */
 
 static void fe_invert(fe out, const fe z)
@@ -339,6 +347,8 @@ static int fe_isnonzero(const fe f)
            + 1;
 }
 
+#if !defined(CRYPTO_FE_RADIX_51)
+
 /* From fe_mul.c */
 
 /*
@@ -1216,6 +1226,81 @@ static void fe_tobytes(unsigned char *s, const fe h)
     s[31] = h9 >> 18;
 }
 
+/* From fe_frombytes.c */
+
+/*
+Ignores top bit of h.
+*/
+
+static void fe_frombytes(fe h, const unsigned char *s)
+{
+    int64_t h0 = load_4(s);
+    int64_t h1 = load_3(s + 4) << 6;
+    int64_t h2 = load_3(s + 7) << 5;
+    int64_t h3 = load_3(s + 10) << 3;
+    int64_t h4 = load_3(s + 13) << 2;
+    int64_t h5 = load_4(s + 16);
+    int64_t h6 = load_3(s + 20) << 7;
+    int64_t h7 = load_3(s + 23) << 5;
+    int64_t h8 = load_3(s + 26) << 4;
+    int64_t h9 = (load_3(s + 29) & 8388607) << 2;
+    int64_t carry0;
+    int64_t carry1;
+    int64_t carry2;
+    int64_t carry3;
+    int64_t carry4;
+    int64_t carry5;
+    int64_t carry6;
+    int64_t carry7;
+    int64_t carry8;
+    int64_t carry9;
+
+    carry9 = (h9 + (int64_t)(1 << 24)) >> 25;
+    h0 += carry9 * 19;
+    h9 -= carry9 << 25;
+    carry1 = (h1 + (int64_t)(1 << 24)) >> 25;
+    h2 += carry1;
+    h1 -= carry1 << 25;
+    carry3 = (h3 + (int64_t)(1 << 24)) >> 25;
+    h4 += carry3;
+    h3 -= carry3 << 25;
+    carry5 = (h5 + (int64_t)(1 << 24)) >> 25;
+    h6 += carry5;
+    h5 -= carry5 << 25;
+    carry7 = (h7 + (int64_t)(1 << 24)) >> 25;
+    h8 += carry7;
+    h7 -= carry7 << 25;
+
+    carry0 = (h0 + (int64_t)(1 << 25)) >> 26;
+    h1 += carry0;
+    h0 -= carry0 << 26;
+    carry2 = (h2 + (int64_t)(1 << 25)) >> 26;
+    h3 += carry2;
+    h2 -= carry2 << 26;
+    carry4 = (h4 + (int64_t)(1 << 25)) >> 26;
+    h5 += carry4;
+    h4 -= carry4 << 26;
+    carry6 = (h6 + (int64_t)(1 << 25)) >> 26;
+    h7 += carry6;
+    h6 -= carry6 << 26;
+    carry8 = (h8 + (int64_t)(1 << 25)) >> 26;
+    h9 += carry8;
+    h8 -= carry8 << 26;
+
+    h[0] = (int32_t)h0;
+    h[1] = (int32_t)h1;
+    h[2] = (int32_t)h2;
+    h[3] = (int32_t)h3;
+    h[4] = (int32_t)h4;
+    h[5] = (int32_t)h5;
+    h[6] = (int32_t)h6;
+    h[7] = (int32_t)h7;
+    h[8] = (int32_t)h8;
+    h[9] = (int32_t)h9;
+}
+
+#endif
+
 /* From ge_add.c */
 
 void ge_add(ge_p1p1 *r, const ge_p3 *p, const ge_cached *q)
@@ -1381,81 +1466,22 @@ int ge_frombytes_vartime(ge_p3 *h, const unsigned char *s)
     fe v;
     fe vxx;
     fe check;
+    int i;
 
-    /* From fe_frombytes.c */
-
-    int64_t h0 = load_4(s);
-    int64_t h1 = load_3(s + 4) << 6;
-    int64_t h2 = load_3(s + 7) << 5;
-    int64_t h3 = load_3(s + 10) << 3;
-    int64_t h4 = load_3(s + 13) << 2;
-    int64_t h5 = load_4(s + 16);
-    int64_t h6 = load_3(s + 20) << 7;
-    int64_t h7 = load_3(s + 23) << 5;
-    int64_t h8 = load_3(s + 26) << 4;
-    int64_t h9 = (load_3(s + 29) & 8388607) << 2;
-    int64_t carry0;
-    int64_t carry1;
-    int64_t carry2;
-    int64_t carry3;
-    int64_t carry4;
-    int64_t carry5;
-    int64_t carry6;
-    int64_t carry7;
-    int64_t carry8;
-    int64_t carry9;
-
-    /* Validate the number to be canonical */
-    if (h9 == 33554428 && h8 == 268435440 && h7 == 536870880 && h6 == 2147483520 && h5 == 4294967295 && h4 == 67108860
-        && h3 == 134217720 && h2 == 536870880 && h1 == 1073741760 && h0 >= 4294967277)
+    /* Validate the number to be canonical, ie. less than 2^255 - 19 */
+    if (s[0] >= 0xed && (s[31] & 0x7f) == 0x7f)
     {
-        return -1;
-    }
-
-    carry9 = (h9 + (int64_t)(1 << 24)) >> 25;
-    h0 += carry9 * 19;
-    h9 -= carry9 << 25;
-    carry1 = (h1 + (int64_t)(1 << 24)) >> 25;
-    h2 += carry1;
-    h1 -= carry1 << 25;
-    carry3 = (h3 + (int64_t)(1 << 24)) >> 25;
-    h4 += carry3;
-    h3 -= carry3 << 25;
-    carry5 = (h5 + (int64_t)(1 << 24)) >> 25;
-    h6 += carry5;
-    h5 -= carry5 << 25;
-    carry7 = (h7 + (int64_t)(1 << 24)) >> 25;
-    h8 += carry7;
-    h7 -= carry7 << 25;
-
-    carry0 = (h0 + (int64_t)(1 << 25)) >> 26;
-    h1 += carry0;
-    h0 -= carry0 << 26;
-    carry2 = (h2 + (int64_t)(1 << 25)) >> 26;
-    h3 += carry2;
-    h2 -= carry2 << 26;
-    carry4 = (h4 + (int64_t)(1 << 25)) >> 26;
-    h5 += carry4;
-    h4 -= carry4 << 26;
-    carry6 = (h6 + (int64_t)(1 << 25)) >> 26;
-    h7 += carry6;
-    h6 -= carry6 << 26;
-    carry8 = (h8 + (int64_t)(1 << 25)) >> 26;
-    h9 += carry8;
-    h8 -= carry8 << 26;
+        for (i = 1; i < 31 && s[i] == 0xff; i++)
+        {
+        }
 
-    h->Y[0] = (int32_t)h0;
-    h->Y[1] = (int32_t)h1;
-    h->Y[2] = (int32_t)h2;
-    h->Y[3] = (int32_t)h3;
-    h->Y[4] = (int32_t)h4;
-    h->Y[5] = (int32_t)h5;
-    h->Y[6] = (int32_t)h6;
-    h->Y[7] = (int32_t)h7;
-    h->Y[8] = (int32_t)h8;
-    h->Y[9] = (int32_t)h9;
+        if (i == 31)
+        {
+            return -1;
+        }
+    }
 
-    /* End fe_frombytes.c */
+    fe_frombytes(h->Y, s);
 
     fe_1(h->Z);
     fe_sq(u, h->Y);
@@ -2147,6 +2173,60 @@ void sc_reduce(unsigned char *s)
 
 /* New code */
 
+/*
+Encodes count points at once. Converting a point to bytes needs the inverse
+of its Z coordinate, so rather than performing count field inversions, we use
+Montgomery's trick: invert the product of every Z once, and recover the
+individual inverses with three multiplications each.
+
+s must have room for count * 32 bytes, and scratch for count field elements.
+*/
+
+void ge_tobytes_batch(unsigned char *s, const ge_p2 *h, fe *scratch, size_t count)
+{
+    fe *products = scratch;
+    fe inverse;
+    fe recip;
+    fe x;
+    fe y;
+    size_t i;
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    /* products[i] = Z_0 * Z_1 * ... * Z_i */
+    fe_copy(products[0], h[0].Z);
+
+    for (i = 1; i < count; i++)
+    {
+        fe_mul(products[i], products[i - 1], h[i].Z);
+    }
+
+    /* inverse = 1 / (Z_0 * ... * Z_(count - 1)) */
+    fe_invert(inverse, products[count - 1]);
+
+    for (i = count - 1; i > 0; i--)
+    {
+        /* 1 / Z_i = (Z_0 * ... * Z_(i - 1)) / (Z_0 * ... * Z_i) */
+        fe_mul(recip, inverse, products[i - 1]);
+
+        /* Strip Z_i from the inverse for the next iteration */
+        fe_mul(inverse, inverse, h[i].Z);
+
+        fe_mul(x, h[i].X, recip);
+        fe_mul(y, h[i].Y, recip);
+        fe_tobytes(s + i * 32, y);
+        s[i * 32 + 31] ^= fe_isnegative(x) << 7;
+    }
+
+    fe_mul(x, h[0].X, inverse);
+    fe_mul(y, h[0].Y, inverse);
+    fe_tobytes(s, y);
+    s[31] ^= fe_isnegative(x) << 7;
+}
+
 static void fe_divpowm1(fe r, const fe u, const fe v)
 {
     fe v3, uv7, t0, t1, t2;
@@ -2236,13 +2316,13 @@ static void ge_cached_cmov(ge_cached *t, const ge_cached *u, unsigned char b)
 }
 
 /* Assumes that a[31] <= 127 */
-void ge_scalarmult(ge_p2 *r, const unsigned char *a, const ge_p3 *A)
+/* Recodes the scalar a into 64 signed radix 16 digits, for use with
+   ge_scalarmult_recoded. Lets a scalar used for many multiplications be
+   recoded once. */
+
+void ge_scalarmult_recode(signed char *e, const unsigned char *a)
 {
-    signed char e[64];
     int carry, carry2, i;
-    ge_cached Ai[8]; /* 1 * A, 2 * A, ..., 8 * A */
-    ge_p1p1 t;
-    ge_p3 u;
 
     carry = 0; /* 0..1 */
     for (i = 0; i < 31; i++)
@@ -2257,6 +2337,22 @@ void ge_scalarmult(ge_p2 *r, const unsigned char *a, const ge_p3 *A)
     carry2 = (carry + 8) >> 4; /* 0..8 */
     e[62] = carry - (carry2 << 4); /* -8..7 */
     e[63] = carry2; /* 0..8 */
+}
+
+void ge_scalarmult(ge_p2 *r, const unsigned char *a, const ge_p3 *A)
+{
+    signed char e[64];
+
+    ge_scalarmult_recode(e, a);
+    ge_scalarmult_recoded(r, e, A);
+}
+
+void ge_scalarmult_recoded(ge_p2 *r, const signed char *e, const ge_p3 *A)
+{
+    int i;
+    ge_cached Ai[8]; /* 1 * A, 2 * A, ..., 8 * A */
+    ge_p1p1 t;
+    ge_p3 u;
 
     ge_p3_to_cached(&Ai[0], A);
     for (i = 0; i < 7; i++)
@@ -2926,73 +3022,9 @@ void ge_fromfe_frombytes_vartime(ge_p2 *r, const unsigned char *s)
     fe u, v, w, x, y, z;
     unsigned char sign;
 
-    /* From fe_frombytes.c */
-
-    int64_t h0 = load_4(s);
-    int64_t h1 = load_3(s + 4) << 6;
-    int64_t h2 = load_3(s + 7) << 5;
-    int64_t h3 = load_3(s + 10) << 3;
-    int64_t h4 = load_3(s + 13) << 2;
-    int64_t h5 = load_4(s + 16);
-    int64_t h6 = load_3(s + 20) << 7;
-    int64_t h7 = load_3(s + 23) << 5;
-    int64_t h8 = load_3(s + 26) << 4;
-    int64_t h9 = load_3(s + 29) << 2;
-    int64_t carry0;
-    int64_t carry1;
-    int64_t carry2;
-    int64_t carry3;
-    int64_t carry4;
-    int64_t carry5;
-    int64_t carry6;
-    int64_t carry7;
-    int64_t carry8;
-    int64_t carry9;
-
-    carry9 = (h9 + (int64_t)(1 << 24)) >> 25;
-    h0 += carry9 * 19;
-    h9 -= carry9 << 25;
-    carry1 = (h1 + (int64_t)(1 << 24)) >> 25;
-    h2 += carry1;
-    h1 -= carry1 << 25;
-    carry3 = (h3 + (int64_t)(1 << 24)) >> 25;
-    h4 += carry3;
-    h3 -= carry3 << 25;
-    carry5 = (h5 + (int64_t)(1 << 24)) >> 25;
-    h6 += carry5;
-    h5 -= carry5 << 25;
-    carry7 = (h7 + (int64_t)(1 << 24)) >> 25;
-    h8 += carry7;
-    h7 -= carry7 << 25;
-
-    carry0 = (h0 + (int64_t)(1 << 25)) >> 26;
-    h1 += carry0;
-    h0 -= carry0 << 26;
-    carry2 = (h2 + (int64_t)(1 << 25)) >> 26;
-    h3 += carry2;
-    h2 -= carry2 << 26;
-    carry4 = (h4 + (int64_t)(1 << 25)) >> 26;
-    h5 += carry4;
-    h4 -= carry4 << 26;
-    carry6 = (h6 + (int64_t)(1 << 25)) >> 26;
-    h7 += carry6;
-    h6 -= carry6 << 26;
-    carry8 = (h8 + (int64_t)(1 << 25)) >> 26;
-    h9 += carry8;
-    h8 -= carry8 << 26;
-
-    u[0] = (int32_t)h0;
-    u[1] = (int32_t)h1;
-    u[2] = (int32_t)h2;
-    u[3] = (int32_t)h3;
-    u[4] = (int32_t)h4;
-    u[5] = (int32_t)h5;
-    u[6] = (int32_t)h6;
-    u[7] = (int32_t)h7;
-    u[8] = (int32_t)h8;
-    u[9] = (int32_t)h9;
-
-    /* End fe_frombytes.c */
+    /* Unlike fe_frombytes, the top bit counts: 2^255 = 19 (mod p) */
+    fe_frombytes(u, s);
+    u[0] += 19 * (s[31] >> 7);
 
     fe_sq2(v, u); /* 2 * u^2 */
     fe_1(w);
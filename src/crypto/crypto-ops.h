@@ -1,10 +1,16 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 /* From fe.h */
 
+#if defined(CRYPTO_FE_RADIX_51)
+/* Five 51 bit limbs, see crypto-ops-fe51.h */
+typedef uint64_t fe[5];
+#else
 typedef int32_t fe[10];
+#endif
 
 /* From ge.h */
 
@@ -116,6 +122,12 @@ void sc_reduce(unsigned char *);
 
 void ge_scalarmult(ge_p2 *, const unsigned char *, const ge_p3 *);
 
+void ge_scalarmult_recode(signed char *, const unsigned char *);
+
+void ge_scalarmult_recoded(ge_p2 *, const signed char *, const ge_p3 *);
+
+void ge_tobytes_batch(unsigned char *, const ge_p2 *, fe *, size_t);
+
 void ge_double_scalarmult_precomp_vartime(
     ge_p2 *,
     const unsigned char *,
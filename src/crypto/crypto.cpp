@@ -9,15 +9,19 @@
 
 #include "common/Varint.h"
 #include "hash.h"
+#include "point-cache.h"
 #include "random.h"
 
+#include <algorithm>
 #include <alloca.h>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace Crypto
@@ -89,6 +93,73 @@ namespace Crypto
         return rng;
     }
 
+    /* fe is an array type, so can't be stored in a vector directly */
+    typedef std::array<std::remove_extent_t<fe>, std::extent_v<fe>> FieldElement;
+
+    /* Enough for every ring member in several days worth of blocks. Each
+       entry takes roughly 200 bytes. */
+    static const size_t POINT_CACHE_SIZE = 65536;
+
+    static PointCache decompressedKeys(POINT_CACHE_SIZE);
+
+    static PointCache hashedKeys(POINT_CACHE_SIZE);
+
+    /* ge_frombytes_vartime, looking in the cache first. Only used for ring
+       members, which are verified again and again. Keys which are usually
+       seen once, like transaction keys being scanned, decompress directly so
+       they don't push ring members out of the cache. */
+    static bool decompress_key(const PublicKey &key, ge_p3 &point)
+    {
+        if (decompressedKeys.get(key, point))
+        {
+            return true;
+        }
+
+        if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char *>(&key)) != 0)
+        {
+            return false;
+        }
+
+        decompressedKeys.add(key, point);
+
+        return true;
+    }
+
+    static void hash_to_ec(const PublicKey &key, ge_p3 &res)
+    {
+        Hash h;
+        ge_p2 point;
+        ge_p1p1 point2;
+        cn_fast_hash(std::addressof(key), sizeof(PublicKey), h);
+        ge_fromfe_frombytes_vartime(&point, reinterpret_cast<const unsigned char *>(&h));
+        ge_mul8(&point2, &point);
+        ge_p1p1_to_p3(&res, &point2);
+    }
+
+    /* hash_to_ec, looking in the cache first */
+    static void hash_to_ec_cached(const PublicKey &key, ge_p3 &res)
+    {
+        if (hashedKeys.get(key, res))
+        {
+            return;
+        }
+
+        hash_to_ec(key, res);
+
+        hashedKeys.add(key, res);
+    }
+
+    std::tuple<PointCacheStatistics, PointCacheStatistics> crypto_ops::getPointCacheStatistics()
+    {
+        return {decompressedKeys.getStatistics(), hashedKeys.getStatistics()};
+    }
+
+    void crypto_ops::clearPointCaches()
+    {
+        decompressedKeys.clear();
+        hashedKeys.clear();
+    }
+
     bool crypto_ops::check_key(const PublicKey &key)
     {
         ge_p3 point;
@@ -124,6 +195,69 @@ namespace Crypto
         return true;
     }
 
+    bool crypto_ops::generateKeyDerivations(
+        const std::vector<PublicKey> &publicKeys,
+        const SecretKey &secretKey,
+        std::vector<KeyDerivation> &derivations,
+        std::vector<bool> &results)
+    {
+        assert(sc_check(reinterpret_cast<const unsigned char *>(&secretKey)) == 0);
+
+        derivations.assign(publicKeys.size(), KeyDerivation());
+        results.assign(publicKeys.size(), true);
+
+        /* The secret key is the same for every multiplication, so only recode it once */
+        signed char e[64];
+
+        ge_scalarmult_recode(e, reinterpret_cast<const unsigned char *>(&secretKey));
+
+        /* Invalid keys leave their point as the identity, so they don't break
+           the shared inversion */
+        ge_p2 identity {};
+        identity.Y[0] = 1;
+        identity.Z[0] = 1;
+
+        std::vector<ge_p2> points(publicKeys.size(), identity);
+
+        bool allValid = true;
+
+        for (size_t i = 0; i < publicKeys.size(); i++)
+        {
+            ge_p3 point;
+            ge_p1p1 point2;
+
+            if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char *>(&publicKeys[i])) != 0)
+            {
+                results[i] = false;
+                allValid = false;
+                continue;
+            }
+
+            ge_scalarmult_recoded(&points[i], e, &point);
+            ge_mul8(&point2, &points[i]);
+            ge_p1p1_to_p2(&points[i], &point2);
+        }
+
+        /* Encode every derivation with a single field inversion */
+        std::vector<FieldElement> scratch(points.size());
+
+        ge_tobytes_batch(
+            reinterpret_cast<unsigned char *>(derivations.data()),
+            points.data(),
+            reinterpret_cast<fe *>(scratch.data()),
+            points.size());
+
+        for (size_t i = 0; i < publicKeys.size(); i++)
+        {
+            if (!results[i])
+            {
+                std::fill(std::begin(derivations[i].data), std::end(derivations[i].data), 0);
+            }
+        }
+
+        return allValid;
+    }
+
     void
         crypto_ops::derivation_to_scalar(const KeyDerivation &derivation, size_t output_index, EllipticCurveScalar &res)
     {
@@ -410,16 +544,6 @@ namespace Crypto
         return sc_isnonzero(reinterpret_cast<unsigned char *>(&c)) == 0;
     }
 
-    static void hash_to_ec(const PublicKey &key, ge_p3 &res)
-    {
-        Hash h;
-        ge_p2 point;
-        ge_p1p1 point2;
-        cn_fast_hash(std::addressof(key), sizeof(PublicKey), h);
-        ge_fromfe_frombytes_vartime(&point, reinterpret_cast<const unsigned char *>(&h));
-        ge_mul8(&point2, &point);
-        ge_p1p1_to_p3(&res, &point2);
-    }
 
     KeyImage crypto_ops::scalarmultKey(const KeyImage &P, const KeyImage &a)
     {
@@ -664,7 +788,7 @@ namespace Crypto
                 return false;
             }
 
-            if (ge_frombytes_vartime(&tmp3, reinterpret_cast<const unsigned char *>(&pubs[i])) != 0)
+            if (!decompress_key(pubs[i], tmp3))
             {
                 return false;
             }
@@ -677,7 +801,7 @@ namespace Crypto
 
             ge_tobytes(reinterpret_cast<unsigned char *>(&buf->ab[i].a), &tmp2);
 
-            hash_to_ec(pubs[i], tmp3);
+            hash_to_ec_cached(pubs[i], tmp3);
 
             ge_double_scalarmult_precomp_vartime(
                 &tmp2,
@@ -704,6 +828,165 @@ namespace Crypto
         return sc_isnonzero(reinterpret_cast<unsigned char *>(&h)) == 0;
     }
 
+    bool crypto_ops::checkRingSignatures(
+        const std::vector<RingSignatureToCheck> &ringSignatures,
+        std::vector<bool> &results)
+    {
+        results.assign(ringSignatures.size(), true);
+
+        /* Each ring member contributes two commitments, stored in the same
+           order as they are hashed: a0, b0, a1, b1, ... */
+        size_t totalPoints = 0;
+
+        for (const auto &ringSignature : ringSignatures)
+        {
+            totalPoints += 2 * ringSignature.publicKeys.size();
+        }
+
+        /* Invalid signatures leave their points as the identity, so they
+           don't break the shared inversion */
+        ge_p2 identity {};
+        identity.Y[0] = 1;
+        identity.Z[0] = 1;
+
+        std::vector<ge_p2> points(totalPoints, identity);
+
+        std::vector<EllipticCurveScalar> sums(ringSignatures.size());
+
+        size_t offset = 0;
+
+        for (size_t i = 0; i < ringSignatures.size(); i++)
+        {
+            const auto &pubs = ringSignatures[i].publicKeys;
+            const auto &signatures = ringSignatures[i].signatures;
+
+            ge_p2 *const ringPoints = &points[offset];
+
+            offset += 2 * pubs.size();
+
+            ge_p3 image_unp;
+
+            ge_dsmp image_pre;
+
+            if (signatures.size() < pubs.size()
+                || ge_frombytes_vartime(&image_unp, reinterpret_cast<const unsigned char *>(&ringSignatures[i].keyImage))
+                       != 0)
+            {
+                results[i] = false;
+                continue;
+            }
+
+            ge_dsm_precomp(image_pre, &image_unp);
+
+            if (ge_check_subgroup_precomp_vartime(image_pre) != 0)
+            {
+                results[i] = false;
+                continue;
+            }
+
+            sc_0(reinterpret_cast<unsigned char *>(&sums[i]));
+
+            for (size_t j = 0; j < pubs.size(); j++)
+            {
+                ge_p3 tmp3;
+
+                if (sc_check(reinterpret_cast<const unsigned char *>(&signatures[j])) != 0
+                    || sc_check(reinterpret_cast<const unsigned char *>(&signatures[j]) + 32) != 0
+                    || !decompress_key(pubs[j], tmp3))
+                {
+                    results[i] = false;
+                    break;
+                }
+
+                ge_double_scalarmult_base_vartime(
+                    &ringPoints[2 * j],
+                    reinterpret_cast<const unsigned char *>(&signatures[j]),
+                    &tmp3,
+                    reinterpret_cast<const unsigned char *>(&signatures[j]) + 32);
+
+                hash_to_ec_cached(pubs[j], tmp3);
+
+                ge_double_scalarmult_precomp_vartime(
+                    &ringPoints[2 * j + 1],
+                    reinterpret_cast<const unsigned char *>(&signatures[j]) + 32,
+                    &tmp3,
+                    reinterpret_cast<const unsigned char *>(&signatures[j]),
+                    image_pre);
+
+                sc_add(
+                    reinterpret_cast<unsigned char *>(&sums[i]),
+                    reinterpret_cast<unsigned char *>(&sums[i]),
+                    reinterpret_cast<const unsigned char *>(&signatures[j]));
+            }
+
+            /* Don't leave a partially computed ring in the batch */
+            if (!results[i])
+            {
+                std::fill(ringPoints, ringPoints + 2 * pubs.size(), identity);
+            }
+        }
+
+        /* Encode every commitment with a single field inversion */
+        std::vector<EllipticCurvePoint> encoded(totalPoints);
+
+        std::vector<FieldElement> scratch(totalPoints);
+
+        ge_tobytes_batch(
+            reinterpret_cast<unsigned char *>(encoded.data()),
+            points.data(),
+            reinterpret_cast<fe *>(scratch.data()),
+            totalPoints);
+
+        bool allValid = true;
+
+        offset = 0;
+
+        for (size_t i = 0; i < ringSignatures.size(); i++)
+        {
+            const size_t ringSize = ringSignatures[i].publicKeys.size();
+
+            const EllipticCurvePoint *const ringEncoded = &encoded[offset];
+
+            offset += 2 * ringSize;
+
+            if (results[i])
+            {
+                std::vector<uint8_t> buffer(rs_comm_size(ringSize));
+
+                rs_comm *const buf = reinterpret_cast<rs_comm *>(buffer.data());
+
+                buf->h = ringSignatures[i].prefixHash;
+
+                std::memcpy(buf->ab, ringEncoded, 2 * ringSize * sizeof(EllipticCurvePoint));
+
+                EllipticCurveScalar h;
+
+                hash_to_scalar(buf, rs_comm_size(ringSize), h);
+
+                sc_sub(
+                    reinterpret_cast<unsigned char *>(&h),
+                    reinterpret_cast<unsigned char *>(&h),
+                    reinterpret_cast<unsigned char *>(&sums[i]));
+
+                results[i] = sc_isnonzero(reinterpret_cast<unsigned char *>(&h)) == 0;
+            }
+
+            /* The batch failed for this signature - confirm with the individual check */
+            if (!results[i] && ringSignatures[i].signatures.size() >= ringSize)
+            {
+                results[i] = checkRingSignature(
+                    ringSignatures[i].prefixHash,
+                    ringSignatures[i].keyImage,
+                    ringSignatures[i].publicKeys,
+                    ringSignatures[i].signatures);
+            }
+
+            allValid = allValid && results[i];
+        }
+
+        return allValid;
+    }
+
     void crypto_ops::generateViewFromSpend(const Crypto::SecretKey &spend, Crypto::SecretKey &viewSecret)
     {
         /* If we don't need the pub key */
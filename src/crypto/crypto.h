@@ -13,11 +13,37 @@
 #include <cstddef>
 #include <limits>
 #include <mutex>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
 namespace Crypto
 {
+    /* A ring signature to verify as part of a batch */
+    struct RingSignatureToCheck
+    {
+        const Hash &prefixHash;
+
+        const KeyImage &keyImage;
+
+        const std::vector<PublicKey> &publicKeys;
+
+        const std::vector<Signature> &signatures;
+    };
+
+    /* Hit and miss counts of a cache of decompressed public keys */
+    struct PointCacheStatistics
+    {
+        uint64_t hits = 0;
+
+        uint64_t misses = 0;
+
+        uint64_t evictions = 0;
+
+        /* Number of points currently cached */
+        size_t size = 0;
+    };
+
     class crypto_ops
     {
         crypto_ops();
@@ -189,6 +215,37 @@ namespace Crypto
             const std::vector<PublicKey> pubs,
             const std::vector<Signature> signatures);
 
+        /* Statistics for the cache of decompressed public keys, and the cache
+           of public keys hashed to a point. Both are only used by the ring
+           signature checks. */
+        static std::tuple<PointCacheStatistics, PointCacheStatistics> getPointCacheStatistics();
+
+        /* Empties both caches and resets their statistics */
+        static void clearPointCaches();
+
+        /* Verifies many ring signatures at once, for example every input in a
+           block. Produces the same results as calling checkRingSignature() on
+           each one, but shares the cost of encoding the ring commitments.
+           Returns true if every signature is valid, and fills in results with
+           the validity of each signature. */
+        static bool checkRingSignatures(
+            const std::vector<RingSignatureToCheck> &ringSignatures,
+            std::vector<bool> &results);
+
+        /* Computes the key derivation of each public key with the same secret
+           key, for example every transaction public key in a range of blocks
+           with a wallet's private view key. Produces the same derivations as
+           calling generate_key_derivation() on each key, but recodes the secret
+           key once and shares the field inversion between every derivation.
+           Returns true if every public key is valid, and fills in results with
+           whether each derivation succeeded. The derivations of invalid keys
+           are zeroed. */
+        static bool generateKeyDerivations(
+            const std::vector<PublicKey> &publicKeys,
+            const SecretKey &secretKey,
+            std::vector<KeyDerivation> &derivations,
+            std::vector<bool> &results);
+
         static void generateViewFromSpend(const Crypto::SecretKey &spend, Crypto::SecretKey &viewSecret);
 
         static void generateViewFromSpend(
@@ -0,0 +1,122 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "hash.h"
+
+#include <cstdlib>
+#include <stdexcept>
+
+namespace
+{
+    /* Owns the calling thread's Argon2 memory, and frees it, along with the
+       CryptoNight scratchpad, when the thread exits */
+    struct ThreadMemory
+    {
+        uint8_t *argon2Memory = nullptr;
+
+        size_t argon2MemorySize = 0;
+
+        /* Set by the first use on each thread, which also arranges for the
+           destructor to run when the thread exits */
+        bool cleanupRegistered = false;
+
+        ~ThreadMemory()
+        {
+            free();
+        }
+
+        void free()
+        {
+            std::free(argon2Memory);
+
+            argon2Memory = nullptr;
+            argon2MemorySize = 0;
+
+            Crypto::slow_hash_free_state();
+        }
+
+        /* Returns memory of at least size bytes, reusing the existing memory if possible */
+        uint8_t *reserveArgon2(const size_t size)
+        {
+            if (argon2MemorySize < size)
+            {
+                std::free(argon2Memory);
+
+                argon2Memory = static_cast<uint8_t *>(std::malloc(size));
+                argon2MemorySize = argon2Memory == nullptr ? 0 : size;
+            }
+
+            return argon2Memory;
+        }
+    };
+
+    thread_local ThreadMemory threadMemory;
+} // namespace
+
+namespace Crypto
+{
+    void slow_hash_register_thread_cleanup(void)
+    {
+        threadMemory.cleanupRegistered = true;
+    }
+
+    void HashingContext::reserve(const uint32_t cnPageSize, const uint32_t argon2MemoryKiB)
+    {
+        slow_hash_allocate_state(cnPageSize);
+
+        threadMemory.reserveArgon2(argon2_memory_size(argon2MemoryKiB, 1));
+    }
+
+    void HashingContext::release()
+    {
+        threadMemory.free();
+    }
+
+    bool HashingContext::usingHugePages()
+    {
+        return slow_hash_uses_huge_pages() != 0;
+    }
+
+    void HashingContext::argon2id(
+        const void *data,
+        const size_t length,
+        const uint8_t *salt,
+        const size_t saltLength,
+        uint8_t *hash,
+        const size_t hashLength,
+        const uint32_t iterations,
+        const uint32_t memoryKiB,
+        const uint32_t threads)
+    {
+        /* The first time we hash, make sure the Argon2 library has picked
+           the fastest implementation this CPU supports */
+        hash_select_impl();
+
+        const size_t memorySize = argon2_memory_size(memoryKiB, threads);
+
+        uint8_t *memory = threadMemory.reserveArgon2(memorySize);
+
+        if (memory == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        argon2_context context {};
+
+        context.out = hash;
+        context.outlen = static_cast<uint32_t>(hashLength);
+        context.pwd = static_cast<uint8_t *>(const_cast<void *>(data));
+        context.pwdlen = static_cast<uint32_t>(length);
+        context.salt = const_cast<uint8_t *>(salt);
+        context.saltlen = static_cast<uint32_t>(saltLength);
+        context.t_cost = iterations;
+        context.m_cost = memoryKiB;
+        context.lanes = threads;
+        context.threads = threads;
+        context.flags = ARGON2_DEFAULT_FLAGS;
+        context.version = ARGON2_VERSION_NUMBER;
+
+        argon2_ctx_mem(&context, Argon2_id, memory, memorySize);
+    }
+} // namespace Crypto
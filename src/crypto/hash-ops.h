@@ -61,6 +61,12 @@ enum
 
 void cn_fast_hash(const void *data, size_t length, char *hash);
 
+/* cn_fast_hash of count independent messages, writing HASH_SIZE bytes per
+   message to hashes. Uses the multi-buffer Keccak, which hashes several
+   messages per permutation, when this CPU has one. hashes must not overlap
+   the messages. */
+void cn_fast_hash_multi(const void *const *data, const size_t *lengths, size_t count, char *hashes);
+
 void cn_slow_hash(
     const void *data,
     size_t length,
@@ -72,6 +78,78 @@ void cn_slow_hash(
     uint32_t scratchpad,
     uint32_t iterations);
 
+/* cn_slow_hash of count inputs which are all length bytes long, writing
+   HASH_SIZE bytes per input to hashes. With AES-NI the inputs are hashed
+   several at a time with their main loops interleaved, which needs a
+   scratchpad per input being hashed together. */
+void cn_slow_hash_multi(
+    const void *const *data,
+    size_t length,
+    char *hashes,
+    size_t count,
+    int light,
+    int variant,
+    int prehashed,
+    uint32_t page_size,
+    uint32_t scratchpad,
+    uint32_t iterations);
+
+/* Allocates the calling thread's CryptoNight scratchpad, if it doesn't
+   already have one of at least page_size bytes. The scratchpad is kept
+   between calls to cn_slow_hash, and is only freed by slow_hash_free_state */
+void slow_hash_allocate_state(uint32_t page_size);
+
+void slow_hash_free_state(void);
+
+/* Frees the calling thread's scratchpad when the thread exits. Called by
+   slow_hash_allocate_state, and defined in hash-context.cpp, as only C++
+   can run code on thread exit portably */
+void slow_hash_register_thread_cleanup(void);
+
+int slow_hash_uses_huge_pages(void);
+
+/* Instruction set extensions which both the CPU and the OS support */
+enum
+{
+    CPU_FEATURE_SSE2 = 1 << 0,
+    CPU_FEATURE_AES = 1 << 1,
+    CPU_FEATURE_AVX2 = 1 << 2,
+    CPU_FEATURE_AVX512F = 1 << 3
+};
+
+/* The implementation of each hashing kernel picked for this machine */
+struct hash_impl
+{
+    /* Bitmask of CPU_FEATURE_* values */
+    uint32_t cpu_features;
+
+    /* Non zero if cn_slow_hash uses the AES instructions rather than
+       software AES */
+    int cn_slow_hash_aes;
+
+    /* The Keccak-f[1600] permutation used by keccak and cn_fast_hash */
+    void (*keccakf)(uint64_t st[25], int rounds);
+
+    /* The permutation used by cn_fast_hash_multi, run on keccakf_lanes
+       interleaved states at once, or NULL if there is no multi-buffer
+       implementation for this CPU */
+    void (*keccakf_multi)(uint64_t *st, int rounds);
+
+    int keccakf_lanes;
+
+    /* Human readable names, for logging and benchmarks */
+    const char *cn_slow_hash_name;
+    const char *argon2_name;
+    const char *keccak_name;
+    const char *keccak_multi_name;
+};
+
+/* Detects the CPU features and picks an implementation of cn_slow_hash,
+   Argon2 and Keccak, the first time it is called, and returns the same
+   selection on every later call. Safe to call from any thread. Call it at
+   startup so the first hash doesn't pay for the selection. */
+const struct hash_impl *hash_select_impl(void);
+
 void hash_extra_blake(const void *data, size_t length, char *hash);
 
 void hash_extra_groestl(const void *data, size_t length, char *hash);
@@ -0,0 +1,272 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "hash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+extern "C"
+{
+#include "keccak.h"
+}
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace
+{
+    /* How many permutations to time each Keccak implementation over */
+    const int KECCAK_BENCHMARK_PERMUTATIONS = 256;
+
+    /* How many times to repeat the timing, keeping the fastest run, so one
+       unlucky context switch doesn't decide the result */
+    const int KECCAK_BENCHMARK_RUNS = 3;
+
+    std::once_flag implSelected;
+
+    Crypto::hash_impl selectedImpl;
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define HASH_SELECT_X86
+
+    void cpuid(int info[4], const int leaf)
+    {
+        __cpuidex(info, leaf, 0);
+    }
+
+    uint64_t xgetbv()
+    {
+        return _xgetbv(0);
+    }
+#elif defined(__x86_64__) || defined(__i386__)
+#define HASH_SELECT_X86
+
+    void cpuid(int info[4], const int leaf)
+    {
+        unsigned int a, b, c, d;
+
+        __cpuid_count(leaf, 0, a, b, c, d);
+
+        info[0] = static_cast<int>(a);
+        info[1] = static_cast<int>(b);
+        info[2] = static_cast<int>(c);
+        info[3] = static_cast<int>(d);
+    }
+
+    uint64_t xgetbv()
+    {
+        uint32_t eax, edx;
+
+        __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+    }
+#endif
+
+    uint32_t detectCpuFeatures()
+    {
+        uint32_t features = 0;
+
+#if defined(HASH_SELECT_X86)
+        int info[4];
+
+        cpuid(info, 0);
+
+        const int maxLeaf = info[0];
+
+        if (maxLeaf < 1)
+        {
+            return features;
+        }
+
+        cpuid(info, 1);
+
+        if (info[3] & (1 << 26))
+        {
+            features |= Crypto::CPU_FEATURE_SSE2;
+        }
+
+        if (info[2] & (1 << 25))
+        {
+            features |= Crypto::CPU_FEATURE_AES;
+        }
+
+        /* The CPU supporting AVX isn't enough, the OS also has to save the
+           wider registers on a context switch */
+        const bool osxsave = info[2] & (1 << 27);
+        const bool avx = info[2] & (1 << 28);
+
+        const uint64_t xcr0 = osxsave ? xgetbv() : 0;
+
+        const bool ymmEnabled = (xcr0 & 0x06) == 0x06;
+        const bool zmmEnabled = (xcr0 & 0xE6) == 0xE6;
+
+        if (maxLeaf < 7)
+        {
+            return features;
+        }
+
+        cpuid(info, 7);
+
+        if (avx && ymmEnabled && (info[1] & (1 << 5)))
+        {
+            features |= Crypto::CPU_FEATURE_AVX2;
+        }
+
+        if (zmmEnabled && (info[1] & (1 << 16)))
+        {
+            features |= Crypto::CPU_FEATURE_AVX512F;
+        }
+#endif
+
+        return features;
+    }
+
+    bool forceSoftwareAes()
+    {
+        const char *env = std::getenv("TURTLECOIN_USE_SOFTWARE_AES");
+
+        return env != nullptr && std::strcmp(env, "0") != 0 && std::strcmp(env, "no") != 0;
+    }
+
+    void selectSlowHash(Crypto::hash_impl &impl)
+    {
+#if !defined NO_AES && (defined(__x86_64__) || (defined(_MSC_VER) && defined(_WIN64)))
+        impl.cn_slow_hash_aes = (impl.cpu_features & Crypto::CPU_FEATURE_AES) && !forceSoftwareAes();
+        impl.cn_slow_hash_name = impl.cn_slow_hash_aes ? "AES-NI" : "Software AES";
+#elif !defined NO_AES && defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+        impl.cn_slow_hash_aes = 1;
+        impl.cn_slow_hash_name = "ARMv8 Crypto";
+#else
+        impl.cn_slow_hash_aes = 0;
+        impl.cn_slow_hash_name = "Portable";
+#endif
+    }
+
+    std::chrono::steady_clock::duration benchmarkKeccak(void (*keccakf)(uint64_t st[25], int rounds))
+    {
+        uint64_t state[25] = {};
+
+        auto best = std::chrono::steady_clock::duration::max();
+
+        for (int run = 0; run < KECCAK_BENCHMARK_RUNS; run++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int i = 0; i < KECCAK_BENCHMARK_PERMUTATIONS; i++)
+            {
+                keccakf(state, KECCAK_ROUNDS);
+            }
+
+            best = std::min(best, std::chrono::steady_clock::now() - start);
+        }
+
+        return best;
+    }
+
+    /* Both implementations compute the same permutation, so just take
+       whichever this CPU and compiler run faster */
+    void selectKeccak(Crypto::hash_impl &impl)
+    {
+        if (benchmarkKeccak(keccakf_unrolled) <= benchmarkKeccak(keccakf_generic))
+        {
+            impl.keccakf = keccakf_unrolled;
+            impl.keccak_name = "Unrolled";
+        }
+        else
+        {
+            impl.keccakf = keccakf_generic;
+            impl.keccak_name = "Generic";
+        }
+    }
+
+    void selectKeccakMulti(Crypto::hash_impl &impl)
+    {
+        impl.keccakf_multi = nullptr;
+        impl.keccakf_lanes = 1;
+        impl.keccak_multi_name = "None";
+
+#if defined(KECCAK_MULTI_X86)
+        if (impl.cpu_features & Crypto::CPU_FEATURE_AVX512F)
+        {
+            impl.keccakf_multi = keccakf_x8_avx512;
+            impl.keccakf_lanes = 8;
+            impl.keccak_multi_name = "AVX-512F x8";
+        }
+        else if (impl.cpu_features & Crypto::CPU_FEATURE_AVX2)
+        {
+            impl.keccakf_multi = keccakf_x4_avx2;
+            impl.keccakf_lanes = 4;
+            impl.keccak_multi_name = "AVX2 x4";
+        }
+#endif
+    }
+
+    void selectArgon2(Crypto::hash_impl &impl)
+    {
+        /* Argon2 benchmarks each of the implementations the CPU supports */
+        argon2_select_impl(nullptr, nullptr);
+
+        const char *name = argon2_selected_impl_name();
+
+        impl.argon2_name = std::strcmp(name, "(default)") == 0 ? "Portable" : name;
+    }
+
+    void selectImpl()
+    {
+        selectedImpl.cpu_features = detectCpuFeatures();
+
+        selectSlowHash(selectedImpl);
+        selectKeccak(selectedImpl);
+        selectKeccakMulti(selectedImpl);
+        selectArgon2(selectedImpl);
+    }
+} // namespace
+
+namespace Crypto
+{
+    extern "C" const hash_impl *hash_select_impl(void)
+    {
+        std::call_once(implSelected, selectImpl);
+
+        return &selectedImpl;
+    }
+
+    std::vector<std::tuple<std::string, std::string>> getHashImplementations()
+    {
+        const hash_impl *impl = hash_select_impl();
+
+        std::string features;
+
+        const std::tuple<uint32_t, const char *> featureNames[] = {
+            {CPU_FEATURE_SSE2, "SSE2"},
+            {CPU_FEATURE_AES, "AES"},
+            {CPU_FEATURE_AVX2, "AVX2"},
+            {CPU_FEATURE_AVX512F, "AVX-512F"},
+        };
+
+        for (const auto &[feature, name] : featureNames)
+        {
+            if (impl->cpu_features & feature)
+            {
+                features += features.empty() ? name : std::string(" ") + name;
+            }
+        }
+
+        return {
+            {"CPU Features", features.empty() ? "None" : features},
+            {"CryptoNight", impl->cn_slow_hash_name},
+            {"Argon2", impl->argon2_name},
+            {"Keccak", impl->keccak_name},
+            {"Keccak (multi-buffer)", impl->keccak_multi_name},
+        };
+    }
+} // namespace Crypto
@@ -26,3 +26,8 @@ void cn_fast_hash(const void *data, size_t length, char *hash)
     hash_process(&state, data, length);
     memcpy(hash, &state, HASH_SIZE);
 }
+
+void cn_fast_hash_multi(const void *const *data, const size_t *lengths, size_t count, char *hashes)
+{
+    keccak1600_multi((const uint8_t *const *)data, lengths, count, (uint8_t *)hashes, HASH_SIZE);
+}
@@ -11,6 +11,9 @@
 
 #include <CryptoTypes.h>
 #include <stddef.h>
+#include <string>
+#include <tuple>
+#include <vector>
 
 // Standard Cryptonight Definitions
 #define CN_PAGE_SIZE 2097152
@@ -66,7 +69,44 @@ namespace Crypto
     #include "hash-ops.h"
     }
 
-    static bool argon2_optimization_selected = false;
+    /* The detected CPU features, and the implementation hash_select_impl
+       picked for each hashing kernel, as (name, value) pairs for display */
+    std::vector<std::tuple<std::string, std::string>> getHashImplementations();
+
+    /*
+      Per thread memory used by the memory hard hash functions
+    */
+
+    /* The CryptoNight scratchpad and the Argon2 memory used by Chukwa are
+       allocated the first time a thread hashes, and are then kept and reused
+       by every following hash on that thread, rather than being allocated
+       and freed for every hash. The memory is freed when a thread which called
+       reserve() or hashed with Chukwa exits, or when release() is called. */
+    class HashingContext
+    {
+      public:
+        /* Allocate this thread's memory up front, so the first hash doesn't pay for it */
+        static void reserve(const uint32_t cnPageSize = CN_PAGE_SIZE, const uint32_t argon2MemoryKiB = CHUKWA_MEMORY_V2);
+
+        /* Free this thread's memory. It will be allocated again if the
+           thread hashes again. */
+        static void release();
+
+        /* Whether this thread's CryptoNight scratchpad is backed by huge pages */
+        static bool usingHugePages();
+
+        /* Argon2id hash using this thread's Argon2 memory */
+        static void argon2id(
+            const void *data,
+            const size_t length,
+            const uint8_t *salt,
+            const size_t saltLength,
+            uint8_t *hash,
+            const size_t hashLength,
+            const uint32_t iterations,
+            const uint32_t memoryKiB,
+            const uint32_t threads);
+    };
 
     /*
       Cryptonight hash functions
@@ -318,6 +358,56 @@ namespace Crypto
             CN_TURTLE_ITERATIONS);
     }
 
+    /*
+      Multi input versions of the proof of work hashes, used by the miner to
+      hash several nonces at once. Each hashes count inputs of the same length
+      into hashes, which must have room for count hashes.
+    */
+    inline void cn_slow_hash_v0_multi(const void *const *data, size_t length, Hash *hashes, size_t count)
+    {
+        cn_slow_hash_multi(
+            data,
+            length,
+            reinterpret_cast<char *>(hashes),
+            count,
+            0,
+            0,
+            0,
+            CN_PAGE_SIZE,
+            CN_SCRATCHPAD,
+            CN_ITERATIONS);
+    }
+
+    inline void cn_lite_slow_hash_v1_multi(const void *const *data, size_t length, Hash *hashes, size_t count)
+    {
+        cn_slow_hash_multi(
+            data,
+            length,
+            reinterpret_cast<char *>(hashes),
+            count,
+            1,
+            1,
+            0,
+            CN_LITE_PAGE_SIZE,
+            CN_LITE_SCRATCHPAD,
+            CN_LITE_ITERATIONS);
+    }
+
+    inline void cn_turtle_lite_slow_hash_v2_multi(const void *const *data, size_t length, Hash *hashes, size_t count)
+    {
+        cn_slow_hash_multi(
+            data,
+            length,
+            reinterpret_cast<char *>(hashes),
+            count,
+            1,
+            2,
+            0,
+            CN_TURTLE_PAGE_SIZE,
+            CN_TURTLE_SCRATCHPAD,
+            CN_TURTLE_ITERATIONS);
+    }
+
     // CryptoNight Soft Shell
     inline void cn_soft_shell_slow_hash_v0(const void *data, size_t length, Hash &hash, uint32_t height)
     {
@@ -381,19 +471,8 @@ namespace Crypto
         uint8_t salt[CHUKWA_SALTLEN];
         memcpy(salt, data, sizeof(salt));
 
-        /* If this is the first time we've called this hash function then
-           we need to have the Argon2 library check to see if any of the
-           available CPU instruction sets are going to help us out */
-        if (!argon2_optimization_selected)
-        {
-            /* Call the library quick benchmark test to set which CPU
-               instruction sets will be used */
-            argon2_select_impl(NULL, NULL);
-
-            argon2_optimization_selected = true;
-        }
-
-        argon2id_hash_raw(iterations, memory, threads, data, length, salt, CHUKWA_SALTLEN, hash.data, CHUKWA_HASHLEN);
+        HashingContext::argon2id(
+            data, length, salt, CHUKWA_SALTLEN, hash.data, CHUKWA_HASHLEN, iterations, memory, threads);
     }
 
     inline void chukwa_slow_hash_v1(const void *data, size_t length, Hash &hash)
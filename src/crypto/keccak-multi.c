@@ -0,0 +1,370 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+// Multi-buffer Keccak. Hashes several independent messages at once, by
+// running the Keccak-f[1600] permutation on the states of 4 (AVX2) or 8
+// (AVX-512F) messages side by side in vector registers.
+
+#include "hash-ops.h"
+#include "keccak.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// The largest number of interleaved states any implementation permutes
+#define KECCAK_MAX_LANES 8
+
+// Bytes absorbed per permutation, as used by keccak1600
+#define KECCAK_RATE 136
+
+// Marks a lane with no message left to hash
+#define KECCAK_LANE_IDLE ((size_t)-1)
+
+extern const uint64_t keccakf_rndc[24];
+
+#if defined(KECCAK_MULTI_X86)
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#define KECCAK_TARGET(x)
+#else
+#define KECCAK_TARGET(x) __attribute__((target(x)))
+#endif
+
+#define XOR256(a, b) _mm256_xor_si256(a, b)
+#define XOR5_256(a, b, c, d, e) XOR256(XOR256(XOR256(XOR256(a, b), c), d), e)
+#define ROTL256(x, y) _mm256_or_si256(_mm256_slli_epi64(x, y), _mm256_srli_epi64(x, 64 - (y)))
+#define CHI256(a, b, c) _mm256_xor_si256(a, _mm256_andnot_si256(b, c))
+
+KECCAK_TARGET("avx2") void keccakf_x4_avx2(uint64_t *st, int rounds)
+{
+    int i, round;
+    __m256i a[25], b[25], c0, c1, c2, c3, c4, d0, d1, d2, d3, d4;
+
+    for (i = 0; i < 25; i++)
+    {
+        a[i] = _mm256_loadu_si256((const __m256i *)(st + 4 * i));
+    }
+
+    for (round = 0; round < rounds; round++)
+    {
+        // Theta
+        c0 = XOR5_256(a[0], a[5], a[10], a[15], a[20]);
+        c1 = XOR5_256(a[1], a[6], a[11], a[16], a[21]);
+        c2 = XOR5_256(a[2], a[7], a[12], a[17], a[22]);
+        c3 = XOR5_256(a[3], a[8], a[13], a[18], a[23]);
+        c4 = XOR5_256(a[4], a[9], a[14], a[19], a[24]);
+
+        d0 = XOR256(c4, ROTL256(c1, 1));
+        d1 = XOR256(c0, ROTL256(c2, 1));
+        d2 = XOR256(c1, ROTL256(c3, 1));
+        d3 = XOR256(c2, ROTL256(c4, 1));
+        d4 = XOR256(c3, ROTL256(c0, 1));
+
+        // Rho Pi
+        b[0] = XOR256(a[0], d0);
+        b[1] = ROTL256(XOR256(a[6], d1), 44);
+        b[2] = ROTL256(XOR256(a[12], d2), 43);
+        b[3] = ROTL256(XOR256(a[18], d3), 21);
+        b[4] = ROTL256(XOR256(a[24], d4), 14);
+        b[5] = ROTL256(XOR256(a[3], d3), 28);
+        b[6] = ROTL256(XOR256(a[9], d4), 20);
+        b[7] = ROTL256(XOR256(a[10], d0), 3);
+        b[8] = ROTL256(XOR256(a[16], d1), 45);
+        b[9] = ROTL256(XOR256(a[22], d2), 61);
+        b[10] = ROTL256(XOR256(a[1], d1), 1);
+        b[11] = ROTL256(XOR256(a[7], d2), 6);
+        b[12] = ROTL256(XOR256(a[13], d3), 25);
+        b[13] = ROTL256(XOR256(a[19], d4), 8);
+        b[14] = ROTL256(XOR256(a[20], d0), 18);
+        b[15] = ROTL256(XOR256(a[4], d4), 27);
+        b[16] = ROTL256(XOR256(a[5], d0), 36);
+        b[17] = ROTL256(XOR256(a[11], d1), 10);
+        b[18] = ROTL256(XOR256(a[17], d2), 15);
+        b[19] = ROTL256(XOR256(a[23], d3), 56);
+        b[20] = ROTL256(XOR256(a[2], d2), 62);
+        b[21] = ROTL256(XOR256(a[8], d3), 55);
+        b[22] = ROTL256(XOR256(a[14], d4), 39);
+        b[23] = ROTL256(XOR256(a[15], d0), 41);
+        b[24] = ROTL256(XOR256(a[21], d1), 2);
+
+        //  Chi
+        a[0] = CHI256(b[0], b[1], b[2]);
+        a[1] = CHI256(b[1], b[2], b[3]);
+        a[2] = CHI256(b[2], b[3], b[4]);
+        a[3] = CHI256(b[3], b[4], b[0]);
+        a[4] = CHI256(b[4], b[0], b[1]);
+
+        a[5] = CHI256(b[5], b[6], b[7]);
+        a[6] = CHI256(b[6], b[7], b[8]);
+        a[7] = CHI256(b[7], b[8], b[9]);
+        a[8] = CHI256(b[8], b[9], b[5]);
+        a[9] = CHI256(b[9], b[5], b[6]);
+
+        a[10] = CHI256(b[10], b[11], b[12]);
+        a[11] = CHI256(b[11], b[12], b[13]);
+        a[12] = CHI256(b[12], b[13], b[14]);
+        a[13] = CHI256(b[13], b[14], b[10]);
+        a[14] = CHI256(b[14], b[10], b[11]);
+
+        a[15] = CHI256(b[15], b[16], b[17]);
+        a[16] = CHI256(b[16], b[17], b[18]);
+        a[17] = CHI256(b[17], b[18], b[19]);
+        a[18] = CHI256(b[18], b[19], b[15]);
+        a[19] = CHI256(b[19], b[15], b[16]);
+
+        a[20] = CHI256(b[20], b[21], b[22]);
+        a[21] = CHI256(b[21], b[22], b[23]);
+        a[22] = CHI256(b[22], b[23], b[24]);
+        a[23] = CHI256(b[23], b[24], b[20]);
+        a[24] = CHI256(b[24], b[20], b[21]);
+
+        //  Iota
+        a[0] = XOR256(a[0], _mm256_set1_epi64x((long long)keccakf_rndc[round]));
+    }
+
+    for (i = 0; i < 25; i++)
+    {
+        _mm256_storeu_si256((__m256i *)(st + 4 * i), a[i]);
+    }
+}
+
+// 0x96 and 0xD2 are the truth tables of a ^ b ^ c and a ^ (~b & c)
+#define XOR512(a, b) _mm512_xor_si512(a, b)
+#define XOR5_512(a, b, c, d, e) _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a, b, c, 0x96), d, e, 0x96)
+#define ROTL512(x, y) _mm512_rol_epi64(x, y)
+#define CHI512(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0xD2)
+
+KECCAK_TARGET("avx512f") void keccakf_x8_avx512(uint64_t *st, int rounds)
+{
+    int i, round;
+    __m512i a[25], b[25], c0, c1, c2, c3, c4, d0, d1, d2, d3, d4;
+
+    for (i = 0; i < 25; i++)
+    {
+        a[i] = _mm512_loadu_si512((const void *)(st + 8 * i));
+    }
+
+    for (round = 0; round < rounds; round++)
+    {
+        // Theta
+        c0 = XOR5_512(a[0], a[5], a[10], a[15], a[20]);
+        c1 = XOR5_512(a[1], a[6], a[11], a[16], a[21]);
+        c2 = XOR5_512(a[2], a[7], a[12], a[17], a[22]);
+        c3 = XOR5_512(a[3], a[8], a[13], a[18], a[23]);
+        c4 = XOR5_512(a[4], a[9], a[14], a[19], a[24]);
+
+        d0 = XOR512(c4, ROTL512(c1, 1));
+        d1 = XOR512(c0, ROTL512(c2, 1));
+        d2 = XOR512(c1, ROTL512(c3, 1));
+        d3 = XOR512(c2, ROTL512(c4, 1));
+        d4 = XOR512(c3, ROTL512(c0, 1));
+
+        // Rho Pi
+        b[0] = XOR512(a[0], d0);
+        b[1] = ROTL512(XOR512(a[6], d1), 44);
+        b[2] = ROTL512(XOR512(a[12], d2), 43);
+        b[3] = ROTL512(XOR512(a[18], d3), 21);
+        b[4] = ROTL512(XOR512(a[24], d4), 14);
+        b[5] = ROTL512(XOR512(a[3], d3), 28);
+        b[6] = ROTL512(XOR512(a[9], d4), 20);
+        b[7] = ROTL512(XOR512(a[10], d0), 3);
+        b[8] = ROTL512(XOR512(a[16], d1), 45);
+        b[9] = ROTL512(XOR512(a[22], d2), 61);
+        b[10] = ROTL512(XOR512(a[1], d1), 1);
+        b[11] = ROTL512(XOR512(a[7], d2), 6);
+        b[12] = ROTL512(XOR512(a[13], d3), 25);
+        b[13] = ROTL512(XOR512(a[19], d4), 8);
+        b[14] = ROTL512(XOR512(a[20], d0), 18);
+        b[15] = ROTL512(XOR512(a[4], d4), 27);
+        b[16] = ROTL512(XOR512(a[5], d0), 36);
+        b[17] = ROTL512(XOR512(a[11], d1), 10);
+        b[18] = ROTL512(XOR512(a[17], d2), 15);
+        b[19] = ROTL512(XOR512(a[23], d3), 56);
+        b[20] = ROTL512(XOR512(a[2], d2), 62);
+        b[21] = ROTL512(XOR512(a[8], d3), 55);
+        b[22] = ROTL512(XOR512(a[14], d4), 39);
+        b[23] = ROTL512(XOR512(a[15], d0), 41);
+        b[24] = ROTL512(XOR512(a[21], d1), 2);
+
+        //  Chi
+        a[0] = CHI512(b[0], b[1], b[2]);
+        a[1] = CHI512(b[1], b[2], b[3]);
+        a[2] = CHI512(b[2], b[3], b[4]);
+        a[3] = CHI512(b[3], b[4], b[0]);
+        a[4] = CHI512(b[4], b[0], b[1]);
+
+        a[5] = CHI512(b[5], b[6], b[7]);
+        a[6] = CHI512(b[6], b[7], b[8]);
+        a[7] = CHI512(b[7], b[8], b[9]);
+        a[8] = CHI512(b[8], b[9], b[5]);
+        a[9] = CHI512(b[9], b[5], b[6]);
+
+        a[10] = CHI512(b[10], b[11], b[12]);
+        a[11] = CHI512(b[11], b[12], b[13]);
+        a[12] = CHI512(b[12], b[13], b[14]);
+        a[13] = CHI512(b[13], b[14], b[10]);
+        a[14] = CHI512(b[14], b[10], b[11]);
+
+        a[15] = CHI512(b[15], b[16], b[17]);
+        a[16] = CHI512(b[16], b[17], b[18]);
+        a[17] = CHI512(b[17], b[18], b[19]);
+        a[18] = CHI512(b[18], b[19], b[15]);
+        a[19] = CHI512(b[19], b[15], b[16]);
+
+        a[20] = CHI512(b[20], b[21], b[22]);
+        a[21] = CHI512(b[21], b[22], b[23]);
+        a[22] = CHI512(b[22], b[23], b[24]);
+        a[23] = CHI512(b[23], b[24], b[20]);
+        a[24] = CHI512(b[24], b[20], b[21]);
+
+        //  Iota
+        a[0] = XOR512(a[0], _mm512_set1_epi64((long long)keccakf_rndc[round]));
+    }
+
+    for (i = 0; i < 25; i++)
+    {
+        _mm512_storeu_si512((void *)(st + 8 * i), a[i]);
+    }
+}
+
+#endif
+
+// Zeroes the state of lane, and starts absorbing the next message into it
+static void keccak_load_lane(
+    uint64_t *st,
+    int lanes,
+    int lane,
+    const uint8_t **data,
+    size_t *remaining,
+    size_t *message,
+    const uint8_t *const *in,
+    const size_t *inlen,
+    size_t count,
+    size_t *next)
+{
+    int i;
+
+    for (i = 0; i < 25; i++)
+    {
+        st[i * lanes + lane] = 0;
+    }
+
+    if (*next < count)
+    {
+        data[lane] = in[*next];
+        remaining[lane] = inlen[*next];
+        message[lane] = (*next)++;
+    }
+    else
+    {
+        message[lane] = KECCAK_LANE_IDLE;
+    }
+}
+
+void keccak1600_multi(const uint8_t *const *in, const size_t *inlen, size_t count, uint8_t *md, size_t mdlen)
+{
+    const struct hash_impl *impl = hash_select_impl();
+    const int lanes = impl->keccakf_lanes;
+
+    uint64_t st[25 * KECCAK_MAX_LANES];
+    uint64_t word;
+    uint8_t temp[KECCAK_RATE];
+
+    const uint8_t *data[KECCAK_MAX_LANES];
+    size_t remaining[KECCAK_MAX_LANES];
+    size_t message[KECCAK_MAX_LANES];
+    int finished[KECCAK_MAX_LANES];
+
+    size_t i, next = 0, active = 0;
+    int lane;
+
+    // Nothing to interleave with
+    if (impl->keccakf_multi == NULL || count < 2)
+    {
+        uint64_t state[25];
+
+        for (i = 0; i < count; i++)
+        {
+            keccak1600(in[i], (int)inlen[i], (uint8_t *)state);
+            memcpy(md + i * mdlen, state, mdlen);
+        }
+
+        return;
+    }
+
+    for (lane = 0; lane < lanes; lane++)
+    {
+        keccak_load_lane(st, lanes, lane, data, remaining, message, in, inlen, count, &next);
+    }
+
+    active = count < (size_t)lanes ? count : (size_t)lanes;
+
+    // Absorb one block of every lane's message per permutation. When a
+    // message is done, its lane is refilled with the next message, so
+    // messages of different lengths still keep every lane busy.
+    while (active > 0)
+    {
+        for (lane = 0; lane < lanes; lane++)
+        {
+            const uint8_t *block;
+
+            if (message[lane] == KECCAK_LANE_IDLE)
+            {
+                continue;
+            }
+
+            if (remaining[lane] >= KECCAK_RATE)
+            {
+                block = data[lane];
+                data[lane] += KECCAK_RATE;
+                remaining[lane] -= KECCAK_RATE;
+                finished[lane] = 0;
+            }
+            else
+            {
+                // last block and padding, as in keccak
+                memcpy(temp, data[lane], remaining[lane]);
+                temp[remaining[lane]] = 1;
+                memset(temp + remaining[lane] + 1, 0, KECCAK_RATE - remaining[lane] - 1);
+                temp[KECCAK_RATE - 1] |= 0x80;
+                block = temp;
+                finished[lane] = 1;
+            }
+
+            for (i = 0; i < KECCAK_RATE / 8; i++)
+            {
+                memcpy(&word, block + i * 8, 8);
+                st[i * lanes + lane] ^= word;
+            }
+        }
+
+        impl->keccakf_multi(st, KECCAK_ROUNDS);
+
+        for (lane = 0; lane < lanes; lane++)
+        {
+            if (message[lane] == KECCAK_LANE_IDLE || !finished[lane])
+            {
+                continue;
+            }
+
+            for (i = 0; i * 8 < mdlen; i++)
+            {
+                const size_t bytes = mdlen - i * 8 < 8 ? mdlen - i * 8 : 8;
+
+                word = st[i * lanes + lane];
+                memcpy(md + message[lane] * mdlen + i * 8, &word, bytes);
+            }
+
+            keccak_load_lane(st, lanes, lane, data, remaining, message, in, inlen, count, &next);
+
+            if (message[lane] == KECCAK_LANE_IDLE)
+            {
+                active--;
+            }
+        }
+    }
+}
@@ -20,7 +20,7 @@ const int keccakf_piln[24] = {10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23,
 
 // update the state with given number of rounds
 
-void keccakf(uint64_t st[25], int rounds)
+void keccakf_generic(uint64_t st[25], int rounds)
 {
     int i, j, round;
     uint64_t t, bc[5];
@@ -70,6 +70,97 @@ void keccakf(uint64_t st[25], int rounds)
     }
 }
 
+// the same permutation with each round fully unrolled, so the lane indexes
+// and rotation amounts are constants rather than table lookups
+
+void keccakf_unrolled(uint64_t st[25], int rounds)
+{
+    int round;
+    uint64_t c0, c1, c2, c3, c4, d0, d1, d2, d3, d4, b[25];
+
+    for (round = 0; round < rounds; round++)
+    {
+        // Theta
+        c0 = st[0] ^ st[5] ^ st[10] ^ st[15] ^ st[20];
+        c1 = st[1] ^ st[6] ^ st[11] ^ st[16] ^ st[21];
+        c2 = st[2] ^ st[7] ^ st[12] ^ st[17] ^ st[22];
+        c3 = st[3] ^ st[8] ^ st[13] ^ st[18] ^ st[23];
+        c4 = st[4] ^ st[9] ^ st[14] ^ st[19] ^ st[24];
+
+        d0 = c4 ^ ROTL64(c1, 1);
+        d1 = c0 ^ ROTL64(c2, 1);
+        d2 = c1 ^ ROTL64(c3, 1);
+        d3 = c2 ^ ROTL64(c4, 1);
+        d4 = c3 ^ ROTL64(c0, 1);
+
+        // Rho Pi
+        b[0] = st[0] ^ d0;
+        b[1] = ROTL64(st[6] ^ d1, 44);
+        b[2] = ROTL64(st[12] ^ d2, 43);
+        b[3] = ROTL64(st[18] ^ d3, 21);
+        b[4] = ROTL64(st[24] ^ d4, 14);
+        b[5] = ROTL64(st[3] ^ d3, 28);
+        b[6] = ROTL64(st[9] ^ d4, 20);
+        b[7] = ROTL64(st[10] ^ d0, 3);
+        b[8] = ROTL64(st[16] ^ d1, 45);
+        b[9] = ROTL64(st[22] ^ d2, 61);
+        b[10] = ROTL64(st[1] ^ d1, 1);
+        b[11] = ROTL64(st[7] ^ d2, 6);
+        b[12] = ROTL64(st[13] ^ d3, 25);
+        b[13] = ROTL64(st[19] ^ d4, 8);
+        b[14] = ROTL64(st[20] ^ d0, 18);
+        b[15] = ROTL64(st[4] ^ d4, 27);
+        b[16] = ROTL64(st[5] ^ d0, 36);
+        b[17] = ROTL64(st[11] ^ d1, 10);
+        b[18] = ROTL64(st[17] ^ d2, 15);
+        b[19] = ROTL64(st[23] ^ d3, 56);
+        b[20] = ROTL64(st[2] ^ d2, 62);
+        b[21] = ROTL64(st[8] ^ d3, 55);
+        b[22] = ROTL64(st[14] ^ d4, 39);
+        b[23] = ROTL64(st[15] ^ d0, 41);
+        b[24] = ROTL64(st[21] ^ d1, 2);
+
+        //  Chi
+        st[0] = b[0] ^ (~b[1] & b[2]);
+        st[1] = b[1] ^ (~b[2] & b[3]);
+        st[2] = b[2] ^ (~b[3] & b[4]);
+        st[3] = b[3] ^ (~b[4] & b[0]);
+        st[4] = b[4] ^ (~b[0] & b[1]);
+
+        st[5] = b[5] ^ (~b[6] & b[7]);
+        st[6] = b[6] ^ (~b[7] & b[8]);
+        st[7] = b[7] ^ (~b[8] & b[9]);
+        st[8] = b[8] ^ (~b[9] & b[5]);
+        st[9] = b[9] ^ (~b[5] & b[6]);
+
+        st[10] = b[10] ^ (~b[11] & b[12]);
+        st[11] = b[11] ^ (~b[12] & b[13]);
+        st[12] = b[12] ^ (~b[13] & b[14]);
+        st[13] = b[13] ^ (~b[14] & b[10]);
+        st[14] = b[14] ^ (~b[10] & b[11]);
+
+        st[15] = b[15] ^ (~b[16] & b[17]);
+        st[16] = b[16] ^ (~b[17] & b[18]);
+        st[17] = b[17] ^ (~b[18] & b[19]);
+        st[18] = b[18] ^ (~b[19] & b[15]);
+        st[19] = b[19] ^ (~b[15] & b[16]);
+
+        st[20] = b[20] ^ (~b[21] & b[22]);
+        st[21] = b[21] ^ (~b[22] & b[23]);
+        st[22] = b[22] ^ (~b[23] & b[24]);
+        st[23] = b[23] ^ (~b[24] & b[20]);
+        st[24] = b[24] ^ (~b[20] & b[21]);
+
+        //  Iota
+        st[0] ^= keccakf_rndc[round];
+    }
+}
+
+void keccakf(uint64_t st[25], int rounds)
+{
+    hash_select_impl()->keccakf(st, rounds);
+}
+
 // compute a keccak hash (md) of given byte length from "in"
 typedef uint64_t state_t[25];
 
@@ -4,6 +4,7 @@
 #ifndef KECCAK_H
 #define KECCAK_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -18,9 +19,29 @@
 // compute a keccak hash (md) of given byte length from "in"
 int keccak(const uint8_t *in, int inlen, uint8_t *md, int mdlen);
 
-// update the state
+// update the state, using the implementation picked by hash_select_impl
 void keccakf(uint64_t st[25], int norounds);
 
+// the individual implementations keccakf picks from
+void keccakf_generic(uint64_t st[25], int norounds);
+
+void keccakf_unrolled(uint64_t st[25], int norounds);
+
 void keccak1600(const uint8_t *in, int inlen, uint8_t *md);
 
+// keccak1600 of count independent messages, writing the first mdlen bytes
+// of each state to md. Several messages are hashed at once when
+// hash_select_impl found a multi-buffer permutation for this CPU
+void keccak1600_multi(const uint8_t *const *in, const size_t *inlen, size_t count, uint8_t *md, size_t mdlen);
+
+#if defined(__x86_64__) || defined(__i386__) || (defined(_MSC_VER) && defined(_M_X64))
+#define KECCAK_MULTI_X86
+
+// update 4 or 8 interleaved states at once: word i of state n is
+// st[i * 4 + n] or st[i * 8 + n]
+void keccakf_x4_avx2(uint64_t *st, int norounds);
+
+void keccakf_x8_avx512(uint64_t *st, int norounds);
+#endif
+
 #endif
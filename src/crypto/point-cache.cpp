@@ -0,0 +1,99 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "point-cache.h"
+
+#include <algorithm>
+
+namespace Crypto
+{
+    PointCache::PointCache(const size_t maxSize): m_maxShardSize(std::max<size_t>(maxSize / SHARD_COUNT, 1)) {}
+
+    PointCache::Shard &PointCache::getShard(const PublicKey &key)
+    {
+        /* Keys are uniformly distributed, so any byte will do. Use a
+           different one from the map hash so each shard's buckets fill evenly. */
+        return m_shards[key.data[31] % SHARD_COUNT];
+    }
+
+    bool PointCache::get(const PublicKey &key, ge_p3 &point)
+    {
+        Shard &shard = getShard(key);
+
+        std::scoped_lock<std::mutex> lock(shard.mutex);
+
+        const auto it = shard.points.find(key);
+
+        if (it == shard.points.end())
+        {
+            shard.misses++;
+            return false;
+        }
+
+        shard.hits++;
+
+        point = it->second;
+
+        return true;
+    }
+
+    void PointCache::add(const PublicKey &key, const ge_p3 &point)
+    {
+        Shard &shard = getShard(key);
+
+        std::scoped_lock<std::mutex> lock(shard.mutex);
+
+        /* Another thread got here first */
+        if (shard.points.find(key) != shard.points.end())
+        {
+            return;
+        }
+
+        if (shard.order.size() < m_maxShardSize)
+        {
+            shard.order.push_back(key);
+        }
+        else
+        {
+            shard.points.erase(shard.order[shard.next]);
+            shard.order[shard.next] = key;
+            shard.next = (shard.next + 1) % m_maxShardSize;
+            shard.evictions++;
+        }
+
+        shard.points.emplace(key, point);
+    }
+
+    void PointCache::clear()
+    {
+        for (auto &shard : m_shards)
+        {
+            std::scoped_lock<std::mutex> lock(shard.mutex);
+
+            shard.points.clear();
+            shard.order.clear();
+            shard.next = 0;
+            shard.hits = 0;
+            shard.misses = 0;
+            shard.evictions = 0;
+        }
+    }
+
+    PointCacheStatistics PointCache::getStatistics()
+    {
+        PointCacheStatistics statistics;
+
+        for (auto &shard : m_shards)
+        {
+            std::scoped_lock<std::mutex> lock(shard.mutex);
+
+            statistics.hits += shard.hits;
+            statistics.misses += shard.misses;
+            statistics.evictions += shard.evictions;
+            statistics.size += shard.points.size();
+        }
+
+        return statistics;
+    }
+} // namespace Crypto
@@ -0,0 +1,72 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "crypto.h"
+
+#include <array>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Crypto
+{
+    extern "C"
+    {
+#include "crypto-ops.h"
+    }
+
+    /* A bounded, thread safe map of public keys to curve points derived from
+       them. Ring members are picked as decoys over and over again, so rather
+       than decompressing the same key for every ring it appears in, we keep
+       the result around.
+
+       The cache is split into shards, each with its own lock, so concurrent
+       validation threads rarely wait on each other. Each shard evicts its
+       oldest entry once full. Only valid points should be added. */
+    class PointCache
+    {
+      public:
+        explicit PointCache(const size_t maxSize);
+
+        /* Returns true and fills in point if the key is cached */
+        bool get(const PublicKey &key, ge_p3 &point);
+
+        void add(const PublicKey &key, const ge_p3 &point);
+
+        /* Empties the cache and resets its statistics */
+        void clear();
+
+        PointCacheStatistics getStatistics();
+
+      private:
+        struct Shard
+        {
+            std::mutex mutex;
+
+            std::unordered_map<PublicKey, ge_p3> points;
+
+            /* Keys in insertion order, used as a ring buffer for eviction */
+            std::vector<PublicKey> order;
+
+            /* The next slot in order to overwrite, once the shard is full */
+            size_t next = 0;
+
+            uint64_t hits = 0;
+
+            uint64_t misses = 0;
+
+            uint64_t evictions = 0;
+        };
+
+        static constexpr size_t SHARD_COUNT = 16;
+
+        Shard &getShard(const PublicKey &key);
+
+        const size_t m_maxShardSize;
+
+        std::array<Shard, SHARD_COUNT> m_shards;
+    };
+} // namespace Crypto
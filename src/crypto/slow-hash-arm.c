@@ -12,7 +12,7 @@
 
 #include "slow-hash-common.h"
 
-void slow_hash_allocate_state(void)
+void slow_hash_allocate_state(uint32_t page_size)
 {
     // Do nothing, this is just to maintain compatibility with the upgraded slow-hash.c
     return;
@@ -24,6 +24,12 @@ void slow_hash_free_state(void)
     return;
 }
 
+int slow_hash_uses_huge_pages(void)
+{
+    // As above
+    return 0;
+}
+
 #if defined(__GNUC__)
 #define RDATA_ALIGN16 __attribute__((aligned(16)))
 #define STATIC static
@@ -631,4 +637,27 @@ void cn_slow_hash(
 
 #endif /* defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO) */
 
+/* There are no interleaved kernels for this implementation, so just hash each
+   input in turn */
+void cn_slow_hash_multi(
+    const void *const *data,
+    size_t length,
+    char *hashes,
+    size_t count,
+    int light,
+    int variant,
+    int prehashed,
+    uint32_t page_size,
+    uint32_t scratchpad,
+    uint32_t iterations)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        cn_slow_hash(
+            data[i], length, hashes + i * HASH_SIZE, light, variant, prehashed, page_size, scratchpad, iterations);
+    }
+}
+
 #endif
@@ -36,6 +36,7 @@
 #define RDATA_ALIGN16 __attribute__((aligned(16)))
 #endif
 #else
+#include <stdatomic.h>
 #include <sys/mman.h>
 #include <wmmintrin.h>
 #define STATIC static
@@ -120,17 +121,41 @@ THREADV uint8_t *hp_state = NULL;
 
 THREADV int hp_allocated = 0;
 
+/* The size of this thread's scratchpad, which is kept between hashes */
+THREADV uint32_t hp_size = 0;
+
+/* Set once a huge page allocation has failed, so we don't keep paying for
+ * a failing mmap every time a thread allocates its scratchpad. Every hashing
+ * thread reads and writes it, so it is only accessed atomically. */
 #if defined(_MSC_VER)
-#define cpuid(info, x) __cpuidex(info, x, 0)
+static volatile long hp_unavailable = 0;
+
+STATIC INLINE int huge_pages_unavailable(void)
+{
+    return InterlockedCompareExchange(&hp_unavailable, 0, 0) != 0;
+}
+
+STATIC INLINE void set_huge_pages_unavailable(void)
+{
+    InterlockedExchange(&hp_unavailable, 1);
+}
 #else
-void cpuid(int CPUInfo[4], int InfoType)
+static atomic_int hp_unavailable = 0;
+
+STATIC INLINE int huge_pages_unavailable(void)
+{
+    return atomic_load_explicit(&hp_unavailable, memory_order_relaxed);
+}
+
+STATIC INLINE void set_huge_pages_unavailable(void)
 {
-    ASM __volatile__("cpuid"
-                     : "=a"(CPUInfo[0]), "=b"(CPUInfo[1]), "=c"(CPUInfo[2]), "=d"(CPUInfo[3])
-                     : "a"(InfoType), "c"(0));
+    atomic_store_explicit(&hp_unavailable, 1, memory_order_relaxed);
 }
 #endif
 
+/* The size of a huge page. Huge page allocations are rounded up to this */
+#define HUGE_PAGE_SIZE 2097152
+
 /**
  * @brief a = (a xor b), where a and b point to 128 bit values
  */
@@ -146,52 +171,6 @@ STATIC INLINE void xor64(uint64_t *a, const uint64_t b)
     *a ^= b;
 }
 
-/**
- * @brief uses cpuid to determine if the CPU supports the AES instructions
- * @return true if the CPU supports AES, false otherwise
- */
-
-STATIC INLINE int force_software_aes(void)
-{
-    static int use = -1;
-
-    if (use != -1)
-    {
-        return use;
-    }
-
-    const char *env = getenv("TURTLECOIN_USE_SOFTWARE_AES");
-    if (!env)
-    {
-        use = 0;
-    }
-    else if (!strcmp(env, "0") || !strcmp(env, "no"))
-    {
-        use = 0;
-    }
-    else
-    {
-        use = 1;
-    }
-
-    return use;
-}
-
-STATIC INLINE int check_aes_hw(void)
-{
-    int cpuid_results[4];
-    static int supported = -1;
-
-    if (supported >= 0)
-    {
-        return supported;
-    }
-
-    cpuid(cpuid_results, 1);
-
-    return supported = cpuid_results[2] & (1 << 25);
-}
-
 STATIC INLINE void aes_256_assist1(__m128i *t1, __m128i *t2)
 {
     __m128i t4;
@@ -359,6 +338,53 @@ STATIC INLINE void
     }
 }
 
+/**
+ * @brief CryptoNight step 2 using AES-NI: fills the scratchpad by repeatedly encrypting <text>
+ *
+ * @param key the 256 bit AES key, taken from the Keccak state
+ * @param text the INIT_SIZE_BYTE bytes of the Keccak state to encrypt, updated in place
+ * @param scratchpad the scratchpad to fill, init_rounds * INIT_SIZE_BYTE bytes long
+ * @param init_rounds the number of INIT_SIZE_BYTE blocks in the scratchpad
+ */
+
+STATIC INLINE void aes_fill_scratchpad(const uint8_t *key, uint8_t *text, uint8_t *scratchpad, uint32_t init_rounds)
+{
+    RDATA_ALIGN16 uint8_t expandedKey[240];
+    size_t i;
+
+    aes_expand_key(key, expandedKey);
+
+    for (i = 0; i < init_rounds; i++)
+    {
+        aes_pseudo_round(text, text, expandedKey, INIT_SIZE_BLK);
+        memcpy(&scratchpad[i * INIT_SIZE_BYTE], text, INIT_SIZE_BYTE);
+    }
+}
+
+/**
+ * @brief CryptoNight step 4 using AES-NI: mixes the scratchpad back into <text>
+ *
+ * @param key the 256 bit AES key, taken from the Keccak state
+ * @param text the INIT_SIZE_BYTE bytes of the Keccak state to mix into, updated in place
+ * @param scratchpad the scratchpad, init_rounds * INIT_SIZE_BYTE bytes long
+ * @param init_rounds the number of INIT_SIZE_BYTE blocks in the scratchpad
+ */
+
+STATIC INLINE void
+    aes_mix_scratchpad(const uint8_t *key, uint8_t *text, const uint8_t *scratchpad, uint32_t init_rounds)
+{
+    RDATA_ALIGN16 uint8_t expandedKey[240];
+    size_t i;
+
+    aes_expand_key(key, expandedKey);
+
+    for (i = 0; i < init_rounds; i++)
+    {
+        // add the xor to the pseudo round
+        aes_pseudo_round_xor(text, text, expandedKey, &scratchpad[i * INIT_SIZE_BYTE], INIT_SIZE_BLK);
+    }
+}
+
 #if defined(_MSC_VER) || defined(__MINGW32__)
 
 BOOL SetLockPagesPrivilege(HANDLE hProcess, BOOL bEnable)
@@ -402,54 +428,82 @@ BOOL SetLockPagesPrivilege(HANDLE hProcess, BOOL bEnable)
 #endif
 
 /**
- * @brief allocate the 2MB scratch buffer using OS support for huge pages, if available
+ * @brief allocate the scratch buffer using OS support for huge pages, if available
+ *
+ * This function tries to allocate the scratch buffer using 2MB "huge pages"
+ * (instead of the usual 4KB page sizes) to reduce TLB misses during the
+ * random accesses to the scratch buffer.  This is one of the important speed
+ * optimizations needed to make CryptoNight faster.
  *
- * This function tries to allocate the 2MB scratch buffer using a single
- * 2MB "huge page" (instead of the usual 4KB page sizes) to reduce TLB misses
- * during the random accesses to the scratch buffer.  This is one of the
- * important speed optimizations needed to make CryptoNight faster.
+ * The buffer is kept for the lifetime of the thread (or until
+ * slow_hash_free_state is called) and reused by every following hash, so
+ * the allocation is only paid for once. It is only reallocated if a larger
+ * scratchpad is requested, and is freed when the thread exits.
  *
- * No parameters.  Updates a thread-local pointer, hp_state, to point to
- * the allocated buffer.
+ * Updates a thread-local pointer, hp_state, to point to the allocated buffer.
  */
 
 void slow_hash_allocate_state(uint32_t page_size)
 {
     if (hp_state != NULL)
     {
-        return;
+        if (hp_size >= page_size)
+        {
+            return;
+        }
+
+        slow_hash_free_state();
     }
 
+    /* Round up to a whole number of huge pages */
+    const uint32_t alloc_size = ((page_size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) * HUGE_PAGE_SIZE;
+
+    if (!huge_pages_unavailable())
+    {
 #if defined(_MSC_VER) || defined(__MINGW32__)
-    SetLockPagesPrivilege(GetCurrentProcess(), TRUE);
-    hp_state = (uint8_t *)VirtualAlloc(hp_state, page_size, MEM_LARGE_PAGES | MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        SetLockPagesPrivilege(GetCurrentProcess(), TRUE);
+        hp_state = (uint8_t *)VirtualAlloc(NULL, alloc_size, MEM_LARGE_PAGES | MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
 #else
 #if defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__DragonFly__) || defined(__NetBSD__)
-    hp_state = mmap(0, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, 0, 0);
+        hp_state = mmap(0, alloc_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, 0, 0);
 #else
-    hp_state = mmap(0, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, 0, 0);
+        hp_state = mmap(0, alloc_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, 0, 0);
 #endif
 
-    if (hp_state == MAP_FAILED)
-    {
-        hp_state = NULL;
-    }
+        if (hp_state == MAP_FAILED)
+        {
+            hp_state = NULL;
+        }
 #endif
 
-    hp_allocated = 1;
+        if (hp_state == NULL)
+        {
+            set_huge_pages_unavailable();
+        }
+    }
 
-    if (hp_state == NULL)
+    if (hp_state != NULL)
+    {
+        hp_allocated = 1;
+        hp_size = alloc_size;
+    }
+    else
     {
         hp_allocated = 0;
         hp_state = (uint8_t *)malloc(page_size);
+        hp_size = hp_state == NULL ? 0 : page_size;
     }
+
+    /* The scratchpad outlives this call, so make sure it is freed when the
+     * thread exits, whether or not the thread ever reserved it itself */
+    slow_hash_register_thread_cleanup();
 }
 
 /**
  *@brief frees the state allocated by slow_hash_allocate_state
  */
 
-void slow_hash_free_state(uint32_t page_size)
+void slow_hash_free_state(void)
 {
     if (hp_state == NULL)
     {
@@ -465,12 +519,22 @@ void slow_hash_free_state(uint32_t page_size)
 #if defined(_MSC_VER) || defined(__MINGW32__)
         VirtualFree(hp_state, 0, MEM_RELEASE);
 #else
-        munmap(hp_state, page_size);
+        munmap(hp_state, hp_size);
 #endif
     }
 
     hp_state = NULL;
     hp_allocated = 0;
+    hp_size = 0;
+}
+
+/**
+ * @brief whether the calling thread's scratch buffer is backed by huge pages
+ */
+
+int slow_hash_uses_huge_pages(void)
+{
+    return hp_state != NULL && hp_allocated;
 }
 
 /**
@@ -519,10 +583,8 @@ void cn_slow_hash(
     uint32_t aes_rounds = (iterations / 2);
     size_t lightFlag = (light ? 2 : 1);
 
-    RDATA_ALIGN16 uint8_t expandedKey[240]; /* These buffers are aligned to use later with SSE functions */
-
     uint8_t text[INIT_SIZE_BYTE];
-    RDATA_ALIGN16 uint64_t a[2];
+    RDATA_ALIGN16 uint64_t a[2]; /* These buffers are aligned to use later with SSE functions */
     RDATA_ALIGN16 uint64_t b[4];
     RDATA_ALIGN16 uint64_t c[2];
     union cn_slow_hash_state state;
@@ -532,7 +594,7 @@ void cn_slow_hash(
     size_t i, j;
     uint64_t *p = NULL;
     oaes_ctx *aes_ctx = NULL;
-    int useAes = !force_software_aes() && check_aes_hw();
+    int useAes = hash_select_impl()->cn_slow_hash_aes;
 
     static void (*const extra_hashes[4])(const void *, size_t, char *) = {
         hash_extra_blake, hash_extra_groestl, hash_extra_jh, hash_extra_skein};
@@ -559,13 +621,7 @@ void cn_slow_hash(
      */
     if (useAes)
     {
-        aes_expand_key(state.hs.b, expandedKey);
-
-        for (i = 0; i < init_rounds; i++)
-        {
-            aes_pseudo_round(text, text, expandedKey, INIT_SIZE_BLK);
-            memcpy(&hp_state[i * INIT_SIZE_BYTE], text, INIT_SIZE_BYTE);
-        }
+        aes_fill_scratchpad(state.hs.b, text, hp_state, init_rounds);
     }
     else
     {
@@ -624,13 +680,7 @@ void cn_slow_hash(
     memcpy(text, state.init, INIT_SIZE_BYTE);
     if (useAes)
     {
-        aes_expand_key(&state.hs.b[32], expandedKey);
-
-        for (i = 0; i < init_rounds; i++)
-        {
-            // add the xor to the pseudo round
-            aes_pseudo_round_xor(text, text, expandedKey, &hp_state[i * INIT_SIZE_BYTE], INIT_SIZE_BLK);
-        }
+        aes_mix_scratchpad(&state.hs.b[32], text, hp_state, init_rounds);
     }
     else
     {
@@ -656,7 +706,218 @@ void cn_slow_hash(
     memcpy(state.init, text, INIT_SIZE_BYTE);
     hash_permutation(&state.hs);
     extra_hashes[state.hs.b[0] & 3](&state, 200, hash);
-    slow_hash_free_state(page_size);
+}
+
+/* The state of one of the hashes cn_slow_hash_multi computes together */
+struct cn_slow_hash_way
+{
+    RDATA_ALIGN16 uint64_t a[2];
+    RDATA_ALIGN16 uint64_t b[4];
+    RDATA_ALIGN16 uint64_t c[2];
+    __m128i _b;
+    __m128i _b1;
+    uint64_t tweak1_2;
+    uint64_t division_result;
+    uint64_t sqrt_result;
+    uint8_t *hp_state;
+    uint8_t text[INIT_SIZE_BYTE];
+    union cn_slow_hash_state state;
+};
+
+/**
+ * @brief one iteration of CryptoNight step 3 for a single way of cn_slow_hash_multi
+ *
+ * Aliases the way's state to the names pre_aes and post_aes expect, so this
+ * is exactly the loop body of cn_slow_hash, run against that way's own
+ * scratchpad.
+ */
+
+STATIC INLINE void cn_slow_hash_way_round(struct cn_slow_hash_way *way, int variant, size_t lightFlag, uint32_t TOTALBLOCKS)
+{
+    uint8_t *hp_state = way->hp_state;
+    uint64_t *a = way->a;
+    uint64_t *b = way->b;
+    uint64_t *c = way->c;
+    const uint64_t tweak1_2 = way->tweak1_2;
+    uint64_t division_result = way->division_result;
+    uint64_t sqrt_result = way->sqrt_result;
+    __m128i _a, _c;
+    __m128i _b = way->_b;
+    __m128i _b1 = way->_b1;
+    uint64_t hi, lo;
+    uint64_t *p;
+    size_t j;
+
+    pre_aes();
+    _c = _mm_aesenc_si128(_c, _a);
+    post_aes();
+
+    way->_b = _b;
+    way->_b1 = _b1;
+    way->division_result = division_result;
+    way->sqrt_result = sqrt_result;
+}
+
+/**
+ * @brief computes <ways> CryptoNight hashes together, interleaving their main loops
+ *
+ * The main loop of a single hash is a chain of dependent scratchpad reads,
+ * AES rounds and multiplies, so most of its time is spent waiting on latency.
+ * Running an iteration of each way in turn gives the CPU independent work to
+ * overlap with that wait. Each way has its own scratchpad, so the thread's
+ * scratchpad is <ways> times the usual size.
+ *
+ * Only called with a constant <ways>, so the compiler can unroll the way
+ * loops.
+ */
+
+STATIC INLINE void cn_slow_hash_interleaved(
+    const void *const *data,
+    size_t length,
+    char *hashes,
+    const size_t ways,
+    int light,
+    int variant,
+    int prehashed,
+    uint32_t page_size,
+    uint32_t scratchpad,
+    uint32_t iterations)
+{
+    uint32_t TOTALBLOCKS = (page_size / AES_BLOCK_SIZE);
+    uint32_t init_rounds = (scratchpad / INIT_SIZE_BYTE);
+    uint32_t aes_rounds = (iterations / 2);
+    size_t lightFlag = (light ? 2 : 1);
+
+    struct cn_slow_hash_way way[4];
+
+    size_t i, w;
+
+    static void (*const extra_hashes[4])(const void *, size_t, char *) = {
+        hash_extra_blake, hash_extra_groestl, hash_extra_jh, hash_extra_skein};
+
+    slow_hash_allocate_state(ways * page_size);
+
+    if (variant == 1)
+    {
+        VARIANT1_CHECK();
+    }
+
+    /* Steps 1 and 2 for each way, see cn_slow_hash */
+    for (w = 0; w < ways; w++)
+    {
+        struct cn_slow_hash_way *const s = &way[w];
+
+        s->hp_state = hp_state + w * page_size;
+
+        if (prehashed)
+        {
+            memcpy(&s->state.hs, data[w], length);
+        }
+        else
+        {
+            hash_process(&s->state.hs, data[w], length);
+        }
+
+        memcpy(s->text, s->state.init, INIT_SIZE_BYTE);
+
+        s->tweak1_2 =
+            (variant == 1) ? (s->state.hs.w[24] ^ (*((const uint64_t *)(((const uint8_t *)data[w]) + 35)))) : 0;
+
+        s->division_result = 0;
+        s->sqrt_result = 0;
+
+        if (variant == 2)
+        {
+            s->b[2] = s->state.hs.w[8] ^ s->state.hs.w[10];
+            s->b[3] = s->state.hs.w[9] ^ s->state.hs.w[11];
+            s->division_result = s->state.hs.w[12];
+            s->sqrt_result = s->state.hs.w[13];
+        }
+
+        aes_fill_scratchpad(s->state.hs.b, s->text, s->hp_state, init_rounds);
+
+        s->a[0] = U64(&s->state.k[0])[0] ^ U64(&s->state.k[32])[0];
+        s->a[1] = U64(&s->state.k[0])[1] ^ U64(&s->state.k[32])[1];
+        s->b[0] = U64(&s->state.k[16])[0] ^ U64(&s->state.k[48])[0];
+        s->b[1] = U64(&s->state.k[16])[1] ^ U64(&s->state.k[48])[1];
+
+        s->_b = _mm_load_si128(R128(s->b));
+        s->_b1 = _mm_load_si128(R128(s->b) + 1);
+    }
+
+    /* Step 3, alternating between the ways every iteration */
+    for (i = 0; i < aes_rounds; i++)
+    {
+        for (w = 0; w < ways; w++)
+        {
+            cn_slow_hash_way_round(&way[w], variant, lightFlag, TOTALBLOCKS);
+        }
+    }
+
+    /* Steps 4 and 5 for each way */
+    for (w = 0; w < ways; w++)
+    {
+        struct cn_slow_hash_way *const s = &way[w];
+
+        memcpy(s->text, s->state.init, INIT_SIZE_BYTE);
+        aes_mix_scratchpad(&s->state.hs.b[32], s->text, s->hp_state, init_rounds);
+
+        memcpy(s->state.init, s->text, INIT_SIZE_BYTE);
+        hash_permutation(&s->state.hs);
+        extra_hashes[s->state.hs.b[0] & 3](&s->state, 200, hashes + w * HASH_SIZE);
+    }
+}
+
+/**
+ * @brief computes the CryptoNight hashes of <count> inputs of the same length
+ *
+ * Gives the same results as calling cn_slow_hash on each input, but with
+ * AES-NI hashes them four, then two at a time with cn_slow_hash_interleaved.
+ *
+ * @param data the <count> inputs to hash
+ * @param length the length in bytes of each input
+ * @param hashes a buffer of <count> * HASH_SIZE bytes in which the hashes will be stored
+ */
+void cn_slow_hash_multi(
+    const void *const *data,
+    size_t length,
+    char *hashes,
+    size_t count,
+    int light,
+    int variant,
+    int prehashed,
+    uint32_t page_size,
+    uint32_t scratchpad,
+    uint32_t iterations)
+{
+    if (hash_select_impl()->cn_slow_hash_aes)
+    {
+        while (count >= 4)
+        {
+            cn_slow_hash_interleaved(
+                data, length, hashes, 4, light, variant, prehashed, page_size, scratchpad, iterations);
+
+            data += 4;
+            hashes += 4 * HASH_SIZE;
+            count -= 4;
+        }
+
+        if (count >= 2)
+        {
+            cn_slow_hash_interleaved(
+                data, length, hashes, 2, light, variant, prehashed, page_size, scratchpad, iterations);
+
+            data += 2;
+            hashes += 2 * HASH_SIZE;
+            count -= 2;
+        }
+    }
+
+    for (; count > 0; count--)
+    {
+        cn_slow_hash(*data++, length, hashes, light, variant, prehashed, page_size, scratchpad, iterations);
+        hashes += HASH_SIZE;
+    }
 }
 
 #endif
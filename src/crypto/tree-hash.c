@@ -10,6 +10,23 @@
 #include <stddef.h>
 #include <string.h>
 
+/* Hashes each of the count adjacent pairs of hashes in pairs into out,
+   several pairs at a time */
+static void tree_hash_layer(const char (*pairs)[HASH_SIZE], size_t count, char (*out)[HASH_SIZE])
+{
+    const void **data = alloca(count * sizeof(*data));
+    size_t *lengths = alloca(count * sizeof(*lengths));
+    size_t i;
+
+    for (i = 0; i < count; ++i)
+    {
+        data[i] = pairs[2 * i];
+        lengths[i] = 2 * HASH_SIZE;
+    }
+
+    cn_fast_hash_multi(data, lengths, count, (char *)out);
+}
+
 void tree_hash(const char (*hashes)[HASH_SIZE], size_t count, char *root_hash)
 {
     assert(count > 0);
@@ -23,28 +40,29 @@ void tree_hash(const char (*hashes)[HASH_SIZE], size_t count, char *root_hash)
     }
     else
     {
-        size_t i, j;
+        size_t i;
         size_t cnt = count - 1;
         char(*ints)[HASH_SIZE];
+        char(*next)[HASH_SIZE];
+        char(*swap)[HASH_SIZE];
         for (i = 1; i < 8 * sizeof(size_t); i <<= 1)
         {
             cnt |= cnt >> i;
         }
         cnt &= ~(cnt >> 1);
         ints = alloca(cnt * HASH_SIZE);
+        /* cn_fast_hash_multi can't hash in place, so each layer is written
+           to the other buffer */
+        next = alloca((cnt / 2) * HASH_SIZE);
         memcpy(ints, hashes, (2 * cnt - count) * HASH_SIZE);
-        for (i = 2 * cnt - count, j = 2 * cnt - count; j < cnt; i += 2, ++j)
-        {
-            cn_fast_hash(hashes[i], 2 * HASH_SIZE, ints[j]);
-        }
-        assert(i == count);
+        tree_hash_layer(hashes + 2 * cnt - count, count - cnt, ints + 2 * cnt - count);
         while (cnt > 2)
         {
             cnt >>= 1;
-            for (i = 0, j = 0; j < cnt; i += 2, ++j)
-            {
-                cn_fast_hash(ints[i], 2 * HASH_SIZE, ints[j]);
-            }
+            tree_hash_layer(ints, cnt, next);
+            swap = ints;
+            ints = next;
+            next = swap;
         }
         cn_fast_hash(ints[0], 2 * HASH_SIZE, root_hash);
     }
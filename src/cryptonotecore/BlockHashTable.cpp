@@ -0,0 +1,157 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "BlockHashTable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace CryptoNote
+{
+    namespace
+    {
+        const size_t MIN_SLOT_COUNT = 1024;
+
+        /* Block hashes are already evenly spread, so their first bytes will do */
+        size_t getHashSlot(const Crypto::Hash &blockHash, size_t slotCount)
+        {
+            uint64_t value;
+            std::memcpy(&value, blockHash.data, sizeof(value));
+            return static_cast<size_t>(value) & (slotCount - 1);
+        }
+    } // namespace
+
+    void BlockHashTable::push(const Crypto::Hash &blockHash)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+
+        if ((hashes.size() + 1) * 2 > slots.size())
+        {
+            rehash(std::max(MIN_SLOT_COUNT, slots.size() * 2));
+        }
+
+        hashes.push_back(blockHash);
+        slots[findSlot(blockHash)] = static_cast<uint32_t>(hashes.size());
+    }
+
+    /* Uses backward shift deletion, moving later entries of a probe run into
+       the freed slot, so lookups never need tombstones */
+    void BlockHashTable::truncate(uint32_t blockIndex)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+
+        const size_t mask = slots.size() - 1;
+
+        while (hashes.size() > blockIndex)
+        {
+            size_t freed = findSlot(hashes.back());
+            slots[freed] = 0;
+
+            for (size_t slot = (freed + 1) & mask; slots[slot] != 0; slot = (slot + 1) & mask)
+            {
+                const size_t home = getHashSlot(hashes[slots[slot] - 1], slots.size());
+
+                /* Only move an entry back if the freed slot is within its probe run */
+                if (((slot - home) & mask) >= ((slot - freed) & mask))
+                {
+                    slots[freed] = slots[slot];
+                    slots[slot] = 0;
+                    freed = slot;
+                }
+            }
+
+            hashes.pop_back();
+        }
+    }
+
+    void BlockHashTable::load(const std::vector<Crypto::Hash> &blockHashes)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+
+        hashes = blockHashes;
+
+        size_t slotCount = MIN_SLOT_COUNT;
+
+        while (slotCount < hashes.size() * 2)
+        {
+            slotCount *= 2;
+        }
+
+        rehash(slotCount);
+    }
+
+    boost::optional<uint32_t> BlockHashTable::find(const Crypto::Hash &blockHash) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+
+        if (slots.empty())
+        {
+            return boost::none;
+        }
+
+        const uint32_t entry = slots[findSlot(blockHash)];
+
+        if (entry == 0)
+        {
+            return boost::none;
+        }
+
+        return entry - 1;
+    }
+
+    Crypto::Hash BlockHashTable::getBlockHash(uint32_t blockIndex) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+
+        return hashes.at(blockIndex);
+    }
+
+    std::vector<Crypto::Hash> BlockHashTable::getBlockHashes(uint32_t startIndex, size_t maxCount) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+
+        if (startIndex >= hashes.size())
+        {
+            return {};
+        }
+
+        const size_t count = std::min(hashes.size() - startIndex, maxCount);
+
+        return {hashes.begin() + startIndex, hashes.begin() + startIndex + count};
+    }
+
+    size_t BlockHashTable::size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+
+        return hashes.size();
+    }
+
+    /* The slot holding blockHash, or the empty slot it would go in */
+    size_t BlockHashTable::findSlot(const Crypto::Hash &blockHash) const
+    {
+        const size_t mask = slots.size() - 1;
+
+        size_t slot = getHashSlot(blockHash, slots.size());
+
+        while (slots[slot] != 0 && hashes[slots[slot] - 1] != blockHash)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        return slot;
+    }
+
+    void BlockHashTable::rehash(size_t slotCount)
+    {
+        slots.assign(slotCount, 0);
+
+        for (size_t i = 0; i < hashes.size(); i++)
+        {
+            slots[findSlot(hashes[i])] = static_cast<uint32_t>(i + 1);
+        }
+    }
+} // namespace CryptoNote
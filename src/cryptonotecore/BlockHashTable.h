@@ -0,0 +1,54 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <CryptoNote.h>
+#include <boost/optional.hpp>
+#include <shared_mutex>
+#include <vector>
+
+namespace CryptoNote
+{
+    /* The hash of every block in the chain, by index, and an open addressing
+       table from hash back to index, so neither lookup needs the database.
+       Blocks are only ever added or removed at the top.
+
+       Blocks are pushed and removed on the P2P thread while the RPC threads
+       look them up, so every method takes the lock. */
+    class BlockHashTable
+    {
+      public:
+        void push(const Crypto::Hash &blockHash);
+
+        /* Removes every block from blockIndex up */
+        void truncate(uint32_t blockIndex);
+
+        /* Replaces the table with the given hashes, in block index order */
+        void load(const std::vector<Crypto::Hash> &blockHashes);
+
+        boost::optional<uint32_t> find(const Crypto::Hash &blockHash) const;
+
+        /* Throws std::out_of_range if there is no such block */
+        Crypto::Hash getBlockHash(uint32_t blockIndex) const;
+
+        /* Up to maxCount hashes from startIndex on */
+        std::vector<Crypto::Hash> getBlockHashes(uint32_t startIndex, size_t maxCount) const;
+
+        size_t size() const;
+
+      private:
+        size_t findSlot(const Crypto::Hash &blockHash) const;
+
+        void rehash(size_t slotCount);
+
+        mutable std::shared_mutex mutex;
+
+        std::vector<Crypto::Hash> hashes;
+
+        /* Block index + 1 of the block hashed to each slot, or 0 if empty. The
+           slot count is a power of two, and at least double the block count. */
+        std::vector<uint32_t> slots;
+    };
+} // namespace CryptoNote
@@ -6,14 +6,17 @@
 
 #include "BlockchainCache.h"
 
+#include "BlockchainUtils.h"
 #include "TransactionValidatiorState.h"
 #include "common/CryptoNoteTools.h"
+#include "common/Math.h"
 #include "common/ShuffleGenerator.h"
 #include "common/StdInputStream.h"
 #include "common/StdOutputStream.h"
 #include "common/TransactionExtra.h"
 #include "cryptonotecore/BlockchainStorage.h"
 #include "cryptonotecore/CryptoNoteBasicImpl.h"
+#include "cryptonotecore/WalletSyncRecord.h"
 #include "serialization/CryptoNoteSerialization.h"
 #include "serialization/SerializationOverloads.h"
 
@@ -806,6 +809,117 @@ namespace CryptoNote
         return blocks;
     }
 
+    /* Segments in memory only hold the few blocks of an alternative chain or
+       the top of the main one, so their records are made as they are asked for */
+    std::vector<WalletTypes::WalletBlockInfo>
+        BlockchainCache::getWalletSyncBlocks(const uint64_t startHeight, uint64_t endHeight) const
+    {
+        if (endHeight < startIndex)
+        {
+            return parent->getWalletSyncBlocks(startHeight, endHeight);
+        }
+
+        std::vector<WalletTypes::WalletBlockInfo> blocks;
+
+        if (startHeight < startIndex)
+        {
+            blocks = parent->getWalletSyncBlocks(startHeight, startIndex);
+        }
+
+        const uint64_t startOffset = std::max(startHeight, static_cast<uint64_t>(startIndex));
+
+        endHeight = std::min(endHeight, static_cast<uint64_t>(startIndex) + storage->getBlockCount());
+
+        for (uint64_t i = startOffset; i < endHeight; i++)
+        {
+            blocks.push_back(makeWalletBlockInfo(storage->getBlockByIndex(i - startIndex)));
+        }
+
+        return blocks;
+    }
+
+    std::vector<WalletTypes::WalletBlockInfo>
+        BlockchainCache::getNonEmptyWalletSyncBlocks(const uint64_t startHeight, const size_t blockCount) const
+    {
+        std::vector<WalletTypes::WalletBlockInfo> blocks;
+
+        if (startHeight < startIndex)
+        {
+            blocks = parent->getNonEmptyWalletSyncBlocks(startHeight, blockCount);
+
+            if (blocks.size() == blockCount)
+            {
+                return blocks;
+            }
+        }
+
+        const uint64_t storageBlockCount = storage->getBlockCount();
+
+        for (uint64_t i = std::max(startHeight, static_cast<uint64_t>(startIndex));
+             blocks.size() < blockCount && i < startIndex + storageBlockCount;
+             i++)
+        {
+            auto block = storage->getBlockByIndex(i - startIndex);
+
+            if (block.transactions.empty())
+            {
+                continue;
+            }
+
+            blocks.push_back(makeWalletBlockInfo(block));
+        }
+
+        return blocks;
+    }
+
+    std::vector<CachedBlockHeader> BlockchainCache::getBlockHeaders(uint32_t beginIndex, uint32_t endIndex) const
+    {
+        if (endIndex <= startIndex)
+        {
+            return parent->getBlockHeaders(beginIndex, endIndex);
+        }
+
+        std::vector<CachedBlockHeader> headers;
+
+        if (beginIndex < startIndex)
+        {
+            headers = parent->getBlockHeaders(beginIndex, startIndex);
+        }
+
+        endIndex = std::min(endIndex, getTopBlockIndex() + 1);
+
+        const auto &blockInfosByIndex = blockInfos.get<BlockIndexTag>();
+
+        for (uint32_t i = std::max(beginIndex, startIndex); i < endIndex; i++)
+        {
+            const auto &blockInfo = blockInfosByIndex.at(i - startIndex);
+
+            uint64_t previousCumulativeDifficulty = 0;
+
+            if (i > startIndex)
+            {
+                previousCumulativeDifficulty = blockInfosByIndex.at(i - startIndex - 1).cumulativeDifficulty;
+            }
+            else if (i > 0)
+            {
+                previousCumulativeDifficulty = parent->getCurrentCumulativeDifficulty(i - 1);
+            }
+
+            BlockTemplate block;
+
+            if (!fromBinaryArray(block, storage->getBlockByIndex(i - startIndex).block))
+            {
+                throw std::runtime_error("Failed to parse raw block");
+            }
+
+            const uint64_t difficulty = blockInfo.cumulativeDifficulty - previousCumulativeDifficulty;
+
+            headers.push_back(Utils::makeCachedBlockHeader(CachedBlock(block), blockInfo.blockSize, difficulty));
+        }
+
+        return headers;
+    }
+
     std::unordered_map<Crypto::Hash, std::vector<uint64_t>>
         BlockchainCache::getGlobalIndexes(const std::vector<Crypto::Hash> transactionHashes) const
     {
@@ -1093,6 +1207,36 @@ namespace CryptoNote
         return outputs;
     }
 
+    std::unordered_map<uint64_t, RandomOutputs> BlockchainCache::getRandomOutsByAmounts(
+        const std::vector<uint64_t> &amounts,
+        size_t count,
+        uint32_t blockIndex) const
+    {
+        std::unordered_map<uint64_t, RandomOutputs> result;
+
+        for (const auto amount : amounts)
+        {
+            RandomOutputs &outputs = result[amount];
+
+            outputs.globalIndexes = getRandomOutsByAmount(amount, count, blockIndex);
+
+            std::sort(outputs.globalIndexes.begin(), outputs.globalIndexes.end());
+
+            if (extractKeyOutputKeys(
+                    amount,
+                    blockIndex,
+                    {outputs.globalIndexes.data(), outputs.globalIndexes.size()},
+                    outputs.publicKeys)
+                != ExtractOutputKeysResult::SUCCESS)
+            {
+                logger(Logging::DEBUGGING) << "getRandomOutsByAmounts: failed to extract keys of amount " << amount;
+                outputs = {};
+            }
+        }
+
+        return result;
+    }
+
     ExtractOutputKeysResult BlockchainCache::extractKeyOutputKeys(
         uint64_t amount,
         uint32_t blockIndex,
@@ -1354,6 +1498,17 @@ namespace CryptoNote
         return getLastUnits(count, blockIndex, useGenesis, [](const CachedBlockInfo &cb) { return cb.blockSize; });
     }
 
+    uint64_t BlockchainCache::getLastBlocksSizesMedian(size_t count) const
+    {
+        return getLastBlocksSizesMedian(count, getTopBlockIndex(), skipGenesisBlock);
+    }
+
+    uint64_t BlockchainCache::getLastBlocksSizesMedian(size_t count, uint32_t blockIndex, UseGenesis useGenesis) const
+    {
+        auto sizes = getLastBlocksSizes(count, blockIndex, useGenesis);
+        return Common::medianValue(sizes);
+    }
+
     uint64_t BlockchainCache::getDifficultyForNextBlock() const
     {
         return getDifficultyForNextBlock(getTopBlockIndex());
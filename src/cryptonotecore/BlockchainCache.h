@@ -168,6 +168,10 @@ namespace CryptoNote
 
         std::vector<uint64_t> getLastBlocksSizes(size_t count, uint32_t blockIndex, UseGenesis) const override;
 
+        uint64_t getLastBlocksSizesMedian(size_t count) const override;
+
+        uint64_t getLastBlocksSizesMedian(size_t count, uint32_t blockIndex, UseGenesis) const override;
+
         std::vector<uint64_t>
             getLastCumulativeDifficulties(size_t count, uint32_t blockIndex, UseGenesis) const override;
 
@@ -251,6 +255,11 @@ namespace CryptoNote
         virtual std::vector<uint32_t>
             getRandomOutsByAmount(uint64_t amount, size_t count, uint32_t blockIndex) const override;
 
+        virtual std::unordered_map<uint64_t, RandomOutputs> getRandomOutsByAmounts(
+            const std::vector<uint64_t> &amounts,
+            size_t count,
+            uint32_t blockIndex) const override;
+
         virtual ExtractOutputKeysResult extractKeyOutputs(
             uint64_t amount,
             uint32_t blockIndex,
@@ -270,6 +279,14 @@ namespace CryptoNote
         virtual std::vector<RawBlock>
             getNonEmptyBlocks(const uint64_t startHeight, const size_t blockCount) const override;
 
+        virtual std::vector<WalletTypes::WalletBlockInfo>
+            getWalletSyncBlocks(const uint64_t startHeight, uint64_t endHeight) const override;
+
+        virtual std::vector<WalletTypes::WalletBlockInfo>
+            getNonEmptyWalletSyncBlocks(const uint64_t startHeight, const size_t blockCount) const override;
+
+        virtual std::vector<CachedBlockHeader> getBlockHeaders(uint32_t beginIndex, uint32_t endIndex) const override;
+
       private:
         struct BlockIndexTag
         {
@@ -9,9 +9,26 @@
 
 #include <boost/range/combine.hpp>
 #include <config/Constants.h>
+#include <limits>
 
 using namespace CryptoNote;
 
+namespace
+{
+    template<class Key> RawKeyRange makeKeyRange(const std::string &keyPrefix, const Key &begin, const Key &end)
+    {
+        RawKeyRange range;
+        range.begin = DB::serializeKey(keyPrefix, begin);
+        range.end = DB::serializeKey(keyPrefix, end);
+        return range;
+    }
+
+    uint32_t clampToBlockIndex(uint64_t height)
+    {
+        return static_cast<uint32_t>(std::min<uint64_t>(height, std::numeric_limits<uint32_t>::max()));
+    }
+} // namespace
+
 BlockchainReadBatch::BlockchainReadBatch() {}
 
 BlockchainReadBatch::~BlockchainReadBatch() {}
@@ -22,6 +39,16 @@ BlockchainReadBatch &BlockchainReadBatch::requestSpentKeyImagesByBlock(uint32_t
     return *this;
 }
 
+BlockchainReadBatch &BlockchainReadBatch::requestSpentKeyImagesByBlocks(uint32_t startIndex, uint32_t endIndex)
+{
+    if (startIndex < endIndex)
+    {
+        state.keyRanges.push_back(makeKeyRange(DB::BLOCK_INDEX_TO_KEY_IMAGE_PREFIX, startIndex, endIndex));
+    }
+
+    return *this;
+}
+
 BlockchainReadBatch &BlockchainReadBatch::requestBlockIndexBySpentKeyImage(const Crypto::KeyImage &keyImage)
 {
     state.blockIndexesBySpentKeyImages.emplace(keyImage, 0);
@@ -84,9 +111,10 @@ BlockchainReadBatch &BlockchainReadBatch::requestRawBlock(uint32_t blockIndex)
 
 BlockchainReadBatch &BlockchainReadBatch::requestRawBlocks(uint64_t startHeight, uint64_t endHeight)
 {
-    for (uint64_t i = startHeight; i < endHeight; i++)
+    if (startHeight < endHeight)
     {
-        state.rawBlocks.emplace(i, RawBlock());
+        state.keyRanges.push_back(makeKeyRange(
+            DB::BLOCK_INDEX_TO_RAW_BLOCK_PREFIX, clampToBlockIndex(startHeight), clampToBlockIndex(endHeight)));
     }
 
     return *this;
@@ -104,6 +132,27 @@ BlockchainReadBatch &BlockchainReadBatch::requestClosestTimestampBlockIndex(uint
     return *this;
 }
 
+BlockchainReadBatch &BlockchainReadBatch::requestClosestTimestampBlockIndexAtOrBefore(uint64_t timestamp)
+{
+    if (timestamp < std::numeric_limits<uint64_t>::max())
+    {
+        auto range = makeKeyRange(DB::CLOSEST_TIMESTAMP_BLOCK_INDEX_PREFIX, uint64_t(0), timestamp + 1);
+        range.limit = 1;
+        range.reverse = true;
+        state.keyRanges.push_back(range);
+    }
+
+    return *this;
+}
+
+BlockchainReadBatch &BlockchainReadBatch::requestClosestTimestampBlockIndexesFrom(uint64_t timestamp)
+{
+    state.keyRanges.push_back(makeKeyRange(
+        DB::CLOSEST_TIMESTAMP_BLOCK_INDEX_PREFIX, timestamp, std::numeric_limits<uint64_t>::max()));
+
+    return *this;
+}
+
 BlockchainReadBatch &BlockchainReadBatch::requestKeyOutputAmountsCount()
 {
     state.keyOutputAmountsCount.second = true;
@@ -131,6 +180,18 @@ BlockchainReadBatch &BlockchainReadBatch::requestBlockHashesByTimestamp(uint64_t
     return *this;
 }
 
+BlockchainReadBatch &
+    BlockchainReadBatch::requestBlockHashesByTimestamps(uint64_t timestampBegin, uint64_t timestampEnd)
+{
+    if (timestampBegin < timestampEnd)
+    {
+        state.keyRanges.push_back(
+            makeKeyRange(DB::TIMESTAMP_TO_BLOCKHASHES_PREFIX, timestampBegin, timestampEnd));
+    }
+
+    return *this;
+}
+
 BlockchainReadBatch &BlockchainReadBatch::requestTransactionsCount()
 {
     state.transactionsCount.second = true;
@@ -145,12 +206,69 @@ BlockchainReadBatch &BlockchainReadBatch::requestKeyOutputInfo(
     return *this;
 }
 
+BlockchainReadBatch &BlockchainReadBatch::requestKeyOutputRingMember(
+    IBlockchainCache::Amount amount,
+    IBlockchainCache::GlobalOutputIndex globalIndex)
+{
+    state.keyOutputRingMembers.emplace(std::make_pair(amount, globalIndex), KeyOutputRingMember {});
+    return *this;
+}
+
+BlockchainReadBatch &BlockchainReadBatch::requestWalletSyncRecord(uint32_t blockIndex)
+{
+    state.walletSyncRecords.emplace(blockIndex, WalletTypes::WalletBlockInfo());
+    return *this;
+}
+
+BlockchainReadBatch &BlockchainReadBatch::requestWalletSyncRecords(uint64_t startIndex, uint64_t endIndex)
+{
+    if (startIndex < endIndex)
+    {
+        state.keyRanges.push_back(makeKeyRange(
+            DB::BLOCK_INDEX_TO_WALLET_SYNC_RECORD_PREFIX,
+            clampToBlockIndex(startIndex),
+            clampToBlockIndex(endIndex)));
+    }
+
+    return *this;
+}
+
+BlockchainReadBatch &BlockchainReadBatch::requestNonEmptyBlockIndexes(uint64_t startIndex, size_t count)
+{
+    if (count > 0)
+    {
+        auto range = makeKeyRange(
+            DB::NON_EMPTY_BLOCK_INDEX_PREFIX, clampToBlockIndex(startIndex), std::numeric_limits<uint32_t>::max());
+        range.limit = count;
+        state.keyRanges.push_back(range);
+    }
+
+    return *this;
+}
+
+BlockchainReadBatch &BlockchainReadBatch::requestBlockHeader(uint32_t blockIndex)
+{
+    state.blockHeaders.emplace(blockIndex, CachedBlockHeader());
+    return *this;
+}
+
+BlockchainReadBatch &BlockchainReadBatch::requestBlockHeaders(uint32_t startIndex, uint32_t endIndex)
+{
+    if (startIndex < endIndex)
+    {
+        state.keyRanges.push_back(makeKeyRange(DB::BLOCK_INDEX_TO_BLOCK_HEADER_PREFIX, startIndex, endIndex));
+    }
+
+    return *this;
+}
+
 BlockchainReadResult BlockchainReadBatch::extractResult()
 {
     assert(resultSubmitted);
     auto st = std::move(state);
     state.lastBlockIndex = {0, false};
     state.keyOutputAmountsCount = {{}, false};
+    state.keyRanges.clear();
 
     resultSubmitted = false;
     return BlockchainReadResult(st);
@@ -176,6 +294,9 @@ std::vector<std::string> BlockchainReadBatch::getRawKeys() const
     DB::serializeKeys(rawKeys, DB::PAYMENT_ID_TO_TX_HASH_PREFIX, state.transactionHashesByPaymentIds);
     DB::serializeKeys(rawKeys, DB::TIMESTAMP_TO_BLOCKHASHES_PREFIX, state.blockHashesByTimestamp);
     DB::serializeKeys(rawKeys, DB::KEY_OUTPUT_KEY_PREFIX, state.keyOutputKeys);
+    DB::serializeKeys(rawKeys, DB::KEY_OUTPUT_RING_MEMBER_PREFIX, state.keyOutputRingMembers);
+    DB::serializeKeys(rawKeys, DB::BLOCK_INDEX_TO_WALLET_SYNC_RECORD_PREFIX, state.walletSyncRecords);
+    DB::serializeKeys(rawKeys, DB::BLOCK_INDEX_TO_BLOCK_HEADER_PREFIX, state.blockHeaders);
 
     if (state.lastBlockIndex.second)
     {
@@ -290,38 +411,112 @@ const KeyOutputKeyResult &BlockchainReadResult::getKeyOutputInfo() const
     return state.keyOutputKeys;
 }
 
-void BlockchainReadBatch::submitRawResult(const std::vector<std::string> &values, const std::vector<bool> &resultStates)
+const KeyOutputRingMemberResult &BlockchainReadResult::getKeyOutputRingMembers() const
+{
+    return state.keyOutputRingMembers;
+}
+
+const std::unordered_map<uint32_t, WalletTypes::WalletBlockInfo> &BlockchainReadResult::getWalletSyncRecords() const
+{
+    return state.walletSyncRecords;
+}
+
+const std::unordered_map<uint32_t, uint32_t> &BlockchainReadResult::getNonEmptyBlockTransactionCounts() const
+{
+    return state.nonEmptyBlockTransactionCounts;
+}
+
+const std::unordered_map<uint32_t, CachedBlockHeader> &BlockchainReadResult::getBlockHeaders() const
+{
+    return state.blockHeaders;
+}
+
+void BlockchainReadBatch::submitRawResult(
+    const std::vector<std::string_view> &values,
+    const std::vector<bool> &resultStates)
 {
     assert(state.size() == values.size());
     assert(values.size() == resultStates.size());
     auto range = boost::combine(values, resultStates);
     auto iter = range.begin();
 
-    DB::deserializeValues(state.spentKeyImagesByBlock, iter, DB::BLOCK_INDEX_TO_KEY_IMAGE_PREFIX);
-    DB::deserializeValues(state.blockIndexesBySpentKeyImages, iter, DB::KEY_IMAGE_TO_BLOCK_INDEX_PREFIX);
-    DB::deserializeValues(state.cachedTransactions, iter, DB::TRANSACTION_HASH_TO_TRANSACTION_INFO_PREFIX);
-    DB::deserializeValues(state.transactionHashesByBlocks, iter, DB::BLOCK_INDEX_TO_TX_HASHES_PREFIX);
-    DB::deserializeValues(state.cachedBlocks, iter, DB::BLOCK_INDEX_TO_BLOCK_INFO_PREFIX);
-    DB::deserializeValues(state.blockIndexesByBlockHashes, iter, DB::BLOCK_HASH_TO_BLOCK_INDEX_PREFIX);
-    DB::deserializeValues(state.keyOutputGlobalIndexesCountForAmounts, iter, DB::KEY_OUTPUT_AMOUNT_PREFIX);
-    DB::deserializeValues(state.keyOutputGlobalIndexesForAmounts, iter, DB::KEY_OUTPUT_AMOUNT_PREFIX);
-    DB::deserializeValues(state.rawBlocks, iter, DB::BLOCK_INDEX_TO_RAW_BLOCK_PREFIX);
-    DB::deserializeValues(state.closestTimestampBlockIndex, iter, DB::CLOSEST_TIMESTAMP_BLOCK_INDEX_PREFIX);
-    DB::deserializeValues(state.keyOutputAmounts, iter, DB::KEY_OUTPUT_AMOUNTS_COUNT_PREFIX);
-    DB::deserializeValues(state.transactionCountsByPaymentIds, iter, DB::PAYMENT_ID_TO_TX_HASH_PREFIX);
-    DB::deserializeValues(state.transactionHashesByPaymentIds, iter, DB::PAYMENT_ID_TO_TX_HASH_PREFIX);
-    DB::deserializeValues(state.blockHashesByTimestamp, iter, DB::TIMESTAMP_TO_BLOCKHASHES_PREFIX);
-    DB::deserializeValues(state.keyOutputKeys, iter, DB::KEY_OUTPUT_KEY_PREFIX);
-
-    DB::deserializeValue(state.lastBlockIndex, iter, DB::BLOCK_INDEX_TO_BLOCK_HASH_PREFIX);
-    DB::deserializeValue(state.keyOutputAmountsCount, iter, DB::KEY_OUTPUT_AMOUNTS_COUNT_PREFIX);
-    DB::deserializeValue(state.transactionsCount, iter, DB::TRANSACTION_HASH_TO_TRANSACTION_INFO_PREFIX);
+    DB::deserializeValues(state.spentKeyImagesByBlock, iter);
+    DB::deserializeValues(state.blockIndexesBySpentKeyImages, iter);
+    DB::deserializeValues(state.cachedTransactions, iter);
+    DB::deserializeValues(state.transactionHashesByBlocks, iter);
+    DB::deserializeValues(state.cachedBlocks, iter);
+    DB::deserializeValues(state.blockIndexesByBlockHashes, iter);
+    DB::deserializeValues(state.keyOutputGlobalIndexesCountForAmounts, iter);
+    DB::deserializeValues(state.keyOutputGlobalIndexesForAmounts, iter);
+    DB::deserializeValues(state.rawBlocks, iter);
+    DB::deserializeValues(state.closestTimestampBlockIndex, iter);
+    DB::deserializeValues(state.keyOutputAmounts, iter);
+    DB::deserializeValues(state.transactionCountsByPaymentIds, iter);
+    DB::deserializeValues(state.transactionHashesByPaymentIds, iter);
+    DB::deserializeValues(state.blockHashesByTimestamp, iter);
+    DB::deserializeValues(state.keyOutputKeys, iter);
+    DB::deserializeValues(state.keyOutputRingMembers, iter);
+    DB::deserializeValues(state.walletSyncRecords, iter);
+    DB::deserializeValues(state.blockHeaders, iter);
+
+    DB::deserializeValue(state.lastBlockIndex, iter);
+    DB::deserializeValue(state.keyOutputAmountsCount, iter);
+    DB::deserializeValue(state.transactionsCount, iter);
 
     assert(iter == range.end());
 
     resultSubmitted = true;
 }
 
+std::vector<RawKeyRange> BlockchainReadBatch::getRawKeyRanges() const
+{
+    return state.keyRanges;
+}
+
+void BlockchainReadBatch::submitRawRangeResult(
+    const std::vector<std::vector<std::pair<std::string, std::string>>> &keyValues)
+{
+    assert(keyValues.size() == state.keyRanges.size());
+
+    for (size_t i = 0; i < keyValues.size(); i++)
+    {
+        const std::string keyPrefix = state.keyRanges[i].begin.substr(0, 1);
+
+        if (keyPrefix == DB::BLOCK_INDEX_TO_RAW_BLOCK_PREFIX)
+        {
+            DB::deserializeRange(state.rawBlocks, keyValues[i], keyPrefix);
+        }
+        else if (keyPrefix == DB::BLOCK_INDEX_TO_KEY_IMAGE_PREFIX)
+        {
+            DB::deserializeRange(state.spentKeyImagesByBlock, keyValues[i], keyPrefix);
+        }
+        else if (keyPrefix == DB::CLOSEST_TIMESTAMP_BLOCK_INDEX_PREFIX)
+        {
+            DB::deserializeRange(state.closestTimestampBlockIndex, keyValues[i], keyPrefix);
+        }
+        else if (keyPrefix == DB::TIMESTAMP_TO_BLOCKHASHES_PREFIX)
+        {
+            DB::deserializeRange(state.blockHashesByTimestamp, keyValues[i], keyPrefix);
+        }
+        else if (keyPrefix == DB::BLOCK_INDEX_TO_WALLET_SYNC_RECORD_PREFIX)
+        {
+            DB::deserializeRange(state.walletSyncRecords, keyValues[i], keyPrefix);
+        }
+        else if (keyPrefix == DB::NON_EMPTY_BLOCK_INDEX_PREFIX)
+        {
+            DB::deserializeRange(state.nonEmptyBlockTransactionCounts, keyValues[i], keyPrefix);
+        }
+        else if (keyPrefix == DB::BLOCK_INDEX_TO_BLOCK_HEADER_PREFIX)
+        {
+            DB::deserializeRange(state.blockHeaders, keyValues[i], keyPrefix);
+        }
+        else
+        {
+            assert(false);
+        }
+    }
+}
+
 BlockchainReadState::BlockchainReadState(BlockchainReadState &&state):
     spentKeyImagesByBlock(std::move(state.spentKeyImagesByBlock)),
     blockIndexesBySpentKeyImages(std::move(state.blockIndexesBySpentKeyImages)),
@@ -334,13 +529,18 @@ BlockchainReadState::BlockchainReadState(BlockchainReadState &&state):
     rawBlocks(std::move(state.rawBlocks)),
     blockHashesByTimestamp(std::move(state.blockHashesByTimestamp)),
     keyOutputKeys(std::move(state.keyOutputKeys)),
+    keyOutputRingMembers(std::move(state.keyOutputRingMembers)),
+    walletSyncRecords(std::move(state.walletSyncRecords)),
+    nonEmptyBlockTransactionCounts(std::move(state.nonEmptyBlockTransactionCounts)),
+    blockHeaders(std::move(state.blockHeaders)),
     closestTimestampBlockIndex(std::move(state.closestTimestampBlockIndex)),
     lastBlockIndex(std::move(state.lastBlockIndex)),
     keyOutputAmountsCount(std::move(state.keyOutputAmountsCount)),
     keyOutputAmounts(std::move(state.keyOutputAmounts)),
     transactionCountsByPaymentIds(std::move(state.transactionCountsByPaymentIds)),
     transactionHashesByPaymentIds(std::move(state.transactionHashesByPaymentIds)),
-    transactionsCount(std::move(state.transactionsCount))
+    transactionsCount(std::move(state.transactionsCount)),
+    keyRanges(std::move(state.keyRanges))
 {
 }
 
@@ -351,6 +551,7 @@ size_t BlockchainReadState::size() const
            + keyOutputGlobalIndexesCountForAmounts.size() + keyOutputGlobalIndexesForAmounts.size() + rawBlocks.size()
            + closestTimestampBlockIndex.size() + keyOutputAmounts.size() + transactionCountsByPaymentIds.size()
            + transactionHashesByPaymentIds.size() + blockHashesByTimestamp.size() + keyOutputKeys.size()
+           + keyOutputRingMembers.size() + walletSyncRecords.size() + blockHeaders.size()
            + (lastBlockIndex.second ? 1 : 0) + (keyOutputAmountsCount.second ? 1 : 0)
            + (transactionsCount.second ? 1 : 0);
 }
@@ -46,6 +46,9 @@ namespace CryptoNote
     using KeyOutputKeyResult =
         std::unordered_map<std::pair<IBlockchainCache::Amount, IBlockchainCache::GlobalOutputIndex>, KeyOutputInfo>;
 
+    using KeyOutputRingMemberResult = std::
+        unordered_map<std::pair<IBlockchainCache::Amount, IBlockchainCache::GlobalOutputIndex>, KeyOutputRingMember>;
+
     struct BlockchainReadState
     {
         std::unordered_map<uint32_t, std::vector<Crypto::KeyImage>> spentKeyImagesByBlock;
@@ -79,12 +82,24 @@ namespace CryptoNote
 
         KeyOutputKeyResult keyOutputKeys;
 
+        KeyOutputRingMemberResult keyOutputRingMembers;
+
+        std::unordered_map<uint32_t, WalletTypes::WalletBlockInfo> walletSyncRecords;
+
+        /* Transactions besides the coinbase, by block index */
+        std::unordered_map<uint32_t, uint32_t> nonEmptyBlockTransactionCounts;
+
+        std::unordered_map<uint32_t, CachedBlockHeader> blockHeaders;
+
         std::pair<uint32_t, bool> lastBlockIndex = {0, false};
 
         std::pair<uint32_t, bool> keyOutputAmountsCount = {{}, false};
 
         std::pair<uint64_t, bool> transactionsCount = {0, false};
 
+        /* Read in key order, and merged into the maps above by their key prefix */
+        std::vector<RawKeyRange> keyRanges;
+
         BlockchainReadState() = default;
 
         BlockchainReadState(const BlockchainReadState &) = default;
@@ -139,6 +154,14 @@ namespace CryptoNote
 
         const KeyOutputKeyResult &getKeyOutputInfo() const;
 
+        const KeyOutputRingMemberResult &getKeyOutputRingMembers() const;
+
+        const std::unordered_map<uint32_t, WalletTypes::WalletBlockInfo> &getWalletSyncRecords() const;
+
+        const std::unordered_map<uint32_t, uint32_t> &getNonEmptyBlockTransactionCounts() const;
+
+        const std::unordered_map<uint32_t, CachedBlockHeader> &getBlockHeaders() const;
+
       private:
         BlockchainReadState state;
     };
@@ -152,6 +175,9 @@ namespace CryptoNote
 
         BlockchainReadBatch &requestSpentKeyImagesByBlock(uint32_t blockIndex);
 
+        /* The key images spent in each block in [startIndex, endIndex) */
+        BlockchainReadBatch &requestSpentKeyImagesByBlocks(uint32_t startIndex, uint32_t endIndex);
+
         BlockchainReadBatch &requestBlockIndexBySpentKeyImage(const Crypto::KeyImage &keyImage);
 
         BlockchainReadBatch &requestCachedTransaction(const Crypto::Hash &txHash);
@@ -177,6 +203,12 @@ namespace CryptoNote
 
         BlockchainReadBatch &requestClosestTimestampBlockIndex(uint64_t timestamp);
 
+        /* The latest closest timestamp block index stored at or before timestamp */
+        BlockchainReadBatch &requestClosestTimestampBlockIndexAtOrBefore(uint64_t timestamp);
+
+        /* Every closest timestamp block index stored at or after timestamp */
+        BlockchainReadBatch &requestClosestTimestampBlockIndexesFrom(uint64_t timestamp);
+
         BlockchainReadBatch &requestKeyOutputAmountsCount();
 
         BlockchainReadBatch &requestTransactionCountByPaymentId(const Crypto::Hash &paymentId);
@@ -186,14 +218,42 @@ namespace CryptoNote
 
         BlockchainReadBatch &requestBlockHashesByTimestamp(uint64_t timestamp);
 
+        /* Block hashes of every timestamp in [timestampBegin, timestampEnd) */
+        BlockchainReadBatch &requestBlockHashesByTimestamps(uint64_t timestampBegin, uint64_t timestampEnd);
+
         BlockchainReadBatch &requestTransactionsCount();
 
         BlockchainReadBatch &
             requestKeyOutputInfo(IBlockchainCache::Amount amount, IBlockchainCache::GlobalOutputIndex globalIndex);
 
+        BlockchainReadBatch &requestKeyOutputRingMember(
+            IBlockchainCache::Amount amount,
+            IBlockchainCache::GlobalOutputIndex globalIndex);
+
+        BlockchainReadBatch &requestWalletSyncRecord(uint32_t blockIndex);
+
+        /* The wallet sync records of every block in [startIndex, endIndex) */
+        BlockchainReadBatch &requestWalletSyncRecords(uint64_t startIndex, uint64_t endIndex);
+
+        /* The first count blocks at or after startIndex with transactions other
+           than the coinbase */
+        BlockchainReadBatch &requestNonEmptyBlockIndexes(uint64_t startIndex, size_t count);
+
+        BlockchainReadBatch &requestBlockHeader(uint32_t blockIndex);
+
+        /* The headers of every block in [startIndex, endIndex) */
+        BlockchainReadBatch &requestBlockHeaders(uint32_t startIndex, uint32_t endIndex);
+
         std::vector<std::string> getRawKeys() const override;
 
-        void submitRawResult(const std::vector<std::string> &values, const std::vector<bool> &resultStates) override;
+        void submitRawResult(
+            const std::vector<std::string_view> &values,
+            const std::vector<bool> &resultStates) override;
+
+        std::vector<RawKeyRange> getRawKeyRanges() const override;
+
+        void submitRawRangeResult(
+            const std::vector<std::vector<std::pair<std::string, std::string>>> &keyValues) override;
 
         BlockchainReadResult extractResult();
 
@@ -29,5 +29,37 @@ namespace CryptoNote
             return true;
         }
 
+        CachedBlockHeader makeCachedBlockHeader(const CachedBlock &block, uint64_t cumulativeSize, uint64_t difficulty)
+        {
+            const BlockTemplate &blockTemplate = block.getBlock();
+
+            CachedBlockHeader header;
+
+            header.majorVersion = blockTemplate.majorVersion;
+            header.minorVersion = blockTemplate.minorVersion;
+            header.timestamp = blockTemplate.timestamp;
+            header.previousBlockHash = blockTemplate.previousBlockHash;
+            header.nonce = blockTemplate.nonce;
+            header.blockHash = block.getBlockHash();
+            header.blockIndex = block.getBlockIndex();
+
+            /* The coinbase transaction is in both the blob and the cumulative size */
+            header.blockSize = getObjectBinarySize(blockTemplate) + cumulativeSize
+                               - getObjectBinarySize(blockTemplate.baseTransaction);
+
+            header.difficulty = difficulty;
+
+            header.reward = 0;
+
+            for (const auto &output : blockTemplate.baseTransaction.outputs)
+            {
+                header.reward += output.amount;
+            }
+
+            header.transactionCount = static_cast<uint32_t>(blockTemplate.transactionHashes.size() + 1);
+
+            return header;
+        }
+
     } // namespace Utils
 } // namespace CryptoNote
@@ -7,6 +7,7 @@
 
 #include "CachedTransaction.h"
 #include "CryptoNote.h"
+#include "IBlockchainCache.h"
 #include "common/CryptoNoteTools.h"
 
 #include <vector>
@@ -19,5 +20,9 @@ namespace CryptoNote
             const std::vector<BinaryArray> &binaryTransactions,
             std::vector<CachedTransaction> &transactions);
 
+        /* cumulativeSize is the size of the block's transactions, coinbase
+           included, as pushBlock is given it */
+        CachedBlockHeader makeCachedBlockHeader(const CachedBlock &block, uint64_t cumulativeSize, uint64_t difficulty);
+
     } // namespace Utils
 } // namespace CryptoNote
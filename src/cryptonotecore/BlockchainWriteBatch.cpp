@@ -126,6 +126,37 @@ BlockchainWriteBatch &BlockchainWriteBatch::insertKeyOutputInfo(
     return *this;
 }
 
+BlockchainWriteBatch &BlockchainWriteBatch::insertKeyOutputRingMember(
+    IBlockchainCache::Amount amount,
+    IBlockchainCache::GlobalOutputIndex globalIndex,
+    const KeyOutputRingMember &ringMember)
+{
+    rawDataToInsert.emplace_back(
+        DB::serialize(DB::KEY_OUTPUT_RING_MEMBER_PREFIX, std::make_pair(amount, globalIndex), ringMember));
+    return *this;
+}
+
+BlockchainWriteBatch &BlockchainWriteBatch::insertWalletSyncRecord(
+    uint32_t blockIndex,
+    const WalletTypes::WalletBlockInfo &walletSyncRecord)
+{
+    rawDataToInsert.emplace_back(
+        DB::serialize(DB::BLOCK_INDEX_TO_WALLET_SYNC_RECORD_PREFIX, blockIndex, walletSyncRecord));
+    return *this;
+}
+
+BlockchainWriteBatch &BlockchainWriteBatch::insertNonEmptyBlockIndex(uint32_t blockIndex, uint32_t transactionCount)
+{
+    rawDataToInsert.emplace_back(DB::serialize(DB::NON_EMPTY_BLOCK_INDEX_PREFIX, blockIndex, transactionCount));
+    return *this;
+}
+
+BlockchainWriteBatch &BlockchainWriteBatch::insertBlockHeader(uint32_t blockIndex, const CachedBlockHeader &header)
+{
+    rawDataToInsert.emplace_back(DB::serialize(DB::BLOCK_INDEX_TO_BLOCK_HEADER_PREFIX, blockIndex, header));
+    return *this;
+}
+
 BlockchainWriteBatch &
     BlockchainWriteBatch::removeSpentKeyImages(uint32_t blockIndex, const std::vector<Crypto::KeyImage> &spentKeyImages)
 {
@@ -209,6 +240,33 @@ BlockchainWriteBatch &BlockchainWriteBatch::removeKeyOutputInfo(
     return *this;
 }
 
+BlockchainWriteBatch &BlockchainWriteBatch::removeKeyOutputRingMember(
+    IBlockchainCache::Amount amount,
+    IBlockchainCache::GlobalOutputIndex globalIndex)
+{
+    rawKeysToRemove.emplace_back(
+        DB::serializeKey(DB::KEY_OUTPUT_RING_MEMBER_PREFIX, std::make_pair(amount, globalIndex)));
+    return *this;
+}
+
+BlockchainWriteBatch &BlockchainWriteBatch::removeWalletSyncRecord(uint32_t blockIndex)
+{
+    rawKeysToRemove.emplace_back(DB::serializeKey(DB::BLOCK_INDEX_TO_WALLET_SYNC_RECORD_PREFIX, blockIndex));
+    return *this;
+}
+
+BlockchainWriteBatch &BlockchainWriteBatch::removeNonEmptyBlockIndex(uint32_t blockIndex)
+{
+    rawKeysToRemove.emplace_back(DB::serializeKey(DB::NON_EMPTY_BLOCK_INDEX_PREFIX, blockIndex));
+    return *this;
+}
+
+BlockchainWriteBatch &BlockchainWriteBatch::removeBlockHeader(uint32_t blockIndex)
+{
+    rawKeysToRemove.emplace_back(DB::serializeKey(DB::BLOCK_INDEX_TO_BLOCK_HEADER_PREFIX, blockIndex));
+    return *this;
+}
+
 std::vector<std::pair<std::string, std::string>> BlockchainWriteBatch::extractRawDataToInsert()
 {
     return std::move(rawDataToInsert);
@@ -55,6 +55,18 @@ namespace CryptoNote
             IBlockchainCache::GlobalOutputIndex globalIndex,
             const KeyOutputInfo &outputInfo);
 
+        BlockchainWriteBatch &insertKeyOutputRingMember(
+            IBlockchainCache::Amount amount,
+            IBlockchainCache::GlobalOutputIndex globalIndex,
+            const KeyOutputRingMember &ringMember);
+
+        BlockchainWriteBatch &
+            insertWalletSyncRecord(uint32_t blockIndex, const WalletTypes::WalletBlockInfo &walletSyncRecord);
+
+        BlockchainWriteBatch &insertNonEmptyBlockIndex(uint32_t blockIndex, uint32_t transactionCount);
+
+        BlockchainWriteBatch &insertBlockHeader(uint32_t blockIndex, const CachedBlockHeader &header);
+
         BlockchainWriteBatch &
             removeSpentKeyImages(uint32_t blockIndex, const std::vector<Crypto::KeyImage> &spentKeyImages);
 
@@ -78,6 +90,15 @@ namespace CryptoNote
         BlockchainWriteBatch &
             removeKeyOutputInfo(IBlockchainCache::Amount amount, IBlockchainCache::GlobalOutputIndex globalIndex);
 
+        BlockchainWriteBatch &
+            removeKeyOutputRingMember(IBlockchainCache::Amount amount, IBlockchainCache::GlobalOutputIndex globalIndex);
+
+        BlockchainWriteBatch &removeWalletSyncRecord(uint32_t blockIndex);
+
+        BlockchainWriteBatch &removeNonEmptyBlockIndex(uint32_t blockIndex);
+
+        BlockchainWriteBatch &removeBlockHeader(uint32_t blockIndex);
+
         std::vector<std::pair<std::string, std::string>> extractRawDataToInsert() override;
 
         std::vector<std::string> extractRawKeysToRemove() override;
@@ -25,6 +25,12 @@ CachedTransaction::CachedTransaction(const BinaryArray &transactionBinaryArray):
     }
 }
 
+CachedTransaction::CachedTransaction(const BinaryArray &transactionBinaryArray, const Crypto::Hash &transactionHash):
+    CachedTransaction(transactionBinaryArray)
+{
+    this->transactionHash = transactionHash;
+}
+
 const Transaction &CachedTransaction::getTransaction() const
 {
     return transaction;
@@ -20,6 +20,10 @@ namespace CryptoNote
 
         explicit CachedTransaction(const BinaryArray &transactionBinaryArray);
 
+        /* For when the hash of the binary array has already been computed,
+           such as by getBinaryArrayHashes for a whole block */
+        CachedTransaction(const BinaryArray &transactionBinaryArray, const Crypto::Hash &transactionHash);
+
         const Transaction &getTransaction() const;
 
         const Crypto::Hash &getTransactionHash() const;
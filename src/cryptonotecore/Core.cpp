@@ -27,6 +27,7 @@
 #include <cryptonotecore/TransactionPoolCleaner.h>
 #include <cryptonotecore/UpgradeManager.h>
 #include <cryptonotecore/ValidateTransaction.h>
+#include <cryptonotecore/WalletSyncRecord.h>
 #include <cryptonoteprotocol/CryptoNoteProtocolHandlerCommon.h>
 #include <numeric>
 #include <set>
@@ -181,9 +182,8 @@ namespace CryptoNote
             uint64_t reward = 0;
             int64_t emissionChange = 0;
             auto alreadyGeneratedCoins = segment.getAlreadyGeneratedCoins(previousBlockIndex);
-            auto lastBlocksSizes =
-                segment.getLastBlocksSizes(currency.rewardBlocksWindow(), previousBlockIndex, addGenesisBlock);
-            auto blocksSizeMedian = Common::medianValue(lastBlocksSizes);
+            auto blocksSizeMedian =
+                segment.getLastBlocksSizesMedian(currency.rewardBlocksWindow(), previousBlockIndex, addGenesisBlock);
             if (!currency.getBlockReward(
                     cachedBlock.getBlock().majorVersion,
                     blocksSizeMedian,
@@ -246,7 +246,8 @@ namespace CryptoNote
         blockchainCacheFactory(std::move(blockchainCacheFactory)),
         mainChainStorage(std::move(mainchainStorage)),
         initialized(false),
-        m_transactionValidationThreadPool(transactionValidationThreads)
+        m_transactionValidationThreadPool(transactionValidationThreads),
+        m_verifiedTransactions(CryptoNote::parameters::VERIFIED_TRANSACTION_CACHE_SIZE)
     {
         upgradeManager->addMajorBlockVersion(BLOCK_MAJOR_VERSION_2, currency.upgradeHeight(BLOCK_MAJOR_VERSION_2));
         upgradeManager->addMajorBlockVersion(BLOCK_MAJOR_VERSION_3, currency.upgradeHeight(BLOCK_MAJOR_VERSION_3));
@@ -380,6 +381,33 @@ namespace CryptoNote
         return restoreBlockTemplate(segment, blockIndex);
     }
 
+    std::vector<CachedBlockHeader> Core::getBlockHeaders(uint32_t beginIndex, uint32_t endIndex) const
+    {
+        assert(!chainsStorage.empty());
+        assert(!chainsLeaves.empty());
+
+        throwIfNotInitialized();
+
+        return chainsLeaves[0]->getBlockHeaders(beginIndex, endIndex);
+    }
+
+    CachedBlockHeader Core::getBlockHeaderByHash(const Crypto::Hash &blockHash) const
+    {
+        assert(!chainsStorage.empty());
+        assert(!chainsLeaves.empty());
+
+        throwIfNotInitialized();
+        IBlockchainCache *segment = findMainChainSegmentContainingBlock(blockHash);
+        if (segment == nullptr)
+        {
+            throw std::runtime_error("Requested hash wasn't found in main blockchain");
+        }
+
+        const uint32_t blockIndex = segment->getBlockIndex(blockHash);
+
+        return segment->getBlockHeaders(blockIndex, blockIndex + 1).at(0);
+    }
+
     std::vector<Crypto::Hash> Core::buildSparseChain() const
     {
         throwIfNotInitialized();
@@ -800,42 +828,20 @@ namespace CryptoNote
                 return true;
             }
 
-            std::vector<RawBlock> rawBlocks;
-
+            /* Made when each block was pushed, so no raw block or transaction
+               needs parsing here */
             if (skipCoinbaseTransactions)
             {
-                rawBlocks = mainChain->getNonEmptyBlocks(startIndex, actualBlockCount);
-            }
-            else
-            {
-                rawBlocks = mainChain->getBlocksByHeight(startIndex, endIndex);
-            }
-
-            for (const auto &rawBlock : rawBlocks)
-            {
-                BlockTemplate block;
-
-                fromBinaryArray(block, rawBlock.block);
-
-                WalletTypes::WalletBlockInfo walletBlock;
+                walletBlocks = mainChain->getNonEmptyWalletSyncBlocks(startIndex, actualBlockCount);
 
-                CachedBlock cachedBlock(block);
-
-                walletBlock.blockHeight = cachedBlock.getBlockIndex();
-                walletBlock.blockHash = cachedBlock.getBlockHash();
-                walletBlock.blockTimestamp = block.timestamp;
-
-                if (!skipCoinbaseTransactions)
-                {
-                    walletBlock.coinbaseTransaction = getRawCoinbaseTransaction(block.baseTransaction);
-                }
-
-                for (const auto &transaction : rawBlock.transactions)
+                for (auto &walletBlock : walletBlocks)
                 {
-                    walletBlock.transactions.push_back(getRawTransaction(transaction));
+                    walletBlock.coinbaseTransaction = std::nullopt;
                 }
-
-                walletBlocks.push_back(walletBlock);
+            }
+            else
+            {
+                walletBlocks = mainChain->getWalletSyncBlocks(startIndex, endIndex);
             }
 
             if (walletBlocks.empty())
@@ -971,69 +977,12 @@ namespace CryptoNote
 
     WalletTypes::RawCoinbaseTransaction Core::getRawCoinbaseTransaction(const CryptoNote::Transaction &t)
     {
-        WalletTypes::RawCoinbaseTransaction transaction;
-
-        transaction.hash = getBinaryArrayHash(toBinaryArray(t));
-
-        transaction.transactionPublicKey = Utilities::getTransactionPublicKeyFromExtra(t.extra);
-
-        transaction.unlockTime = t.unlockTime;
-
-        /* Fill in the simplified key outputs */
-        for (const auto &output : t.outputs)
-        {
-            WalletTypes::KeyOutput keyOutput;
-
-            keyOutput.amount = output.amount;
-            keyOutput.key = boost::get<CryptoNote::KeyOutput>(output.target).key;
-
-            transaction.keyOutputs.push_back(keyOutput);
-        }
-
-        return transaction;
+        return makeWalletCoinbaseTransaction(t);
     }
 
     WalletTypes::RawTransaction Core::getRawTransaction(const std::vector<uint8_t> &rawTX)
     {
-        Transaction t;
-
-        /* Convert the binary array to a transaction */
-        fromBinaryArray(t, rawTX);
-
-        WalletTypes::RawTransaction transaction;
-
-        /* Get the transaction hash from the binary array */
-        transaction.hash = getBinaryArrayHash(rawTX);
-
-        Utilities::ParsedExtra parsedExtra = Utilities::parseExtra(t.extra);
-
-        /* Transaction public key, used for decrypting transactions along with
-       private view key */
-        transaction.transactionPublicKey = parsedExtra.transactionPublicKey;
-
-        /* Get the payment ID if it exists (Empty string if it doesn't) */
-        transaction.paymentID = parsedExtra.paymentID;
-
-        transaction.unlockTime = t.unlockTime;
-
-        /* Simplify the outputs */
-        for (const auto &output : t.outputs)
-        {
-            WalletTypes::KeyOutput keyOutput;
-
-            keyOutput.amount = output.amount;
-            keyOutput.key = boost::get<CryptoNote::KeyOutput>(output.target).key;
-
-            transaction.keyOutputs.push_back(keyOutput);
-        }
-
-        /* Simplify the inputs */
-        for (const auto &input : t.inputs)
-        {
-            transaction.keyInputs.push_back(boost::get<CryptoNote::KeyInput>(input));
-        }
-
-        return transaction;
+        return makeWalletTransaction(CachedTransaction(rawTX));
     }
 
     std::optional<BinaryArray> Core::getTransaction(const Crypto::Hash &hash) const
@@ -1263,39 +1212,33 @@ namespace CryptoNote
         }
 
         uint64_t cumulativeFee = 0;
+        Crypto::Hash failedTransactionHash;
 
-        for (const auto &transaction : transactions)
+        const auto transactionValidationResult = validateBlockTransactions(
+            transactions, validatorState, cache, cumulativeFee, previousBlockIndex, failedTransactionHash);
+
+        if (transactionValidationResult)
         {
-            uint64_t fee = 0;
-            auto transactionValidationResult =
-                validateTransaction(transaction, validatorState, cache, m_transactionValidationThreadPool, fee, previousBlockIndex, false);
+            logger(Logging::DEBUGGING) << "Failed to validate transaction " << failedTransactionHash
+                                       << ": " << transactionValidationResult.message();
 
-            if (transactionValidationResult)
+            if (transactionPool->checkIfTransactionPresent(failedTransactionHash))
             {
-                const auto hash = transaction.getTransactionHash();
-
-                logger(Logging::DEBUGGING) << "Failed to validate transaction " << hash
-                                           << ": " << transactionValidationResult.message();
-
-                if (transactionPool->checkIfTransactionPresent(hash))
-                {
-                    logger(Logging::DEBUGGING) << "Invalid transaction " << hash << " is present in the pool, removing";
-                    transactionPool->removeTransaction(hash);
-                    notifyObservers(makeDelTransactionMessage({hash}, Messages::DeleteTransaction::Reason::NotActual));
-                }
-
-                return transactionValidationResult;
+                logger(Logging::DEBUGGING) << "Invalid transaction " << failedTransactionHash
+                                           << " is present in the pool, removing";
+                transactionPool->removeTransaction(failedTransactionHash);
+                notifyObservers(
+                    makeDelTransactionMessage({failedTransactionHash}, Messages::DeleteTransaction::Reason::NotActual));
             }
 
-            cumulativeFee += fee;
+            return transactionValidationResult;
         }
 
         uint64_t reward = 0;
         int64_t emissionChange = 0;
         auto alreadyGeneratedCoins = cache->getAlreadyGeneratedCoins(previousBlockIndex);
-        auto lastBlocksSizes =
-            cache->getLastBlocksSizes(currency.rewardBlocksWindow(), previousBlockIndex, addGenesisBlock);
-        auto blocksSizeMedian = Common::medianValue(lastBlocksSizes);
+        auto blocksSizeMedian =
+            cache->getLastBlocksSizesMedian(currency.rewardBlocksWindow(), previousBlockIndex, addGenesisBlock);
 
         if (!currency.getBlockReward(
                 cachedBlock.getBlock().majorVersion,
@@ -1356,6 +1299,16 @@ namespace CryptoNote
 
                     updateBlockMedianSize();
 
+                    /* The transactions in this block are no longer pool
+                       candidates, and the remaining verified transactions
+                       are still valid on top of this block */
+                    for (const auto &transaction : transactions)
+                    {
+                        m_verifiedTransactions.remove(transaction.getTransactionHash());
+                    }
+
+                    m_verifiedTransactions.advanceTip(previousBlockHash, blockHash);
+
                     /* Take the current block spent key images and run them
                        against the pool to remove any transactions that may
                        be in the pool that would now be considered invalid */
@@ -1606,6 +1559,40 @@ namespace CryptoNote
         }
     }
 
+    void Core::precomputeBlockLongHashes(const std::vector<CachedBlock> &cachedBlocks)
+    {
+        std::vector<std::future<bool>> results;
+
+        for (const auto &cachedBlock : cachedBlocks)
+        {
+            /* Proof of work is not checked for blocks in the checkpoint zone */
+            if (checkpoints.isInCheckpointZone(cachedBlock.getBlockIndex()))
+            {
+                continue;
+            }
+
+            /* Each block is only touched by a single job, so populating the
+               lazily computed fields of the cached block here is safe */
+            results.push_back(m_transactionValidationThreadPool.addJob([&cachedBlock] {
+                try
+                {
+                    cachedBlock.getBlockLongHash();
+                    return true;
+                }
+                /* Unknown block version - will be rejected when the block is added */
+                catch (const std::exception &)
+                {
+                    return false;
+                }
+            }));
+        }
+
+        for (auto &result : results)
+        {
+            result.get();
+        }
+    }
+
     std::error_code Core::addBlock(RawBlock &&rawBlock)
     {
         throwIfNotInitialized();
@@ -1693,6 +1680,24 @@ namespace CryptoNote
         uint16_t count,
         std::vector<uint32_t> &globalIndexes,
         std::vector<Crypto::PublicKey> &publicKeys) const
+    {
+        std::unordered_map<uint64_t, RandomOutputs> outputs;
+
+        const auto [success, error] = getRandomOutputs({amount}, count, outputs);
+
+        if (success)
+        {
+            globalIndexes = std::move(outputs[amount].globalIndexes);
+            publicKeys = std::move(outputs[amount].publicKeys);
+        }
+
+        return {success, error};
+    }
+
+    std::tuple<bool, std::string> Core::getRandomOutputs(
+        const std::vector<uint64_t> &amounts,
+        uint16_t count,
+        std::unordered_map<uint64_t, RandomOutputs> &outputs) const
     {
         throwIfNotInitialized();
 
@@ -1711,55 +1716,29 @@ namespace CryptoNote
             return {false, error};
         }
 
-        globalIndexes = chainsLeaves[0]->getRandomOutsByAmount(amount, count, getTopBlockIndex());
+        outputs = chainsLeaves[0]->getRandomOutsByAmounts(amounts, count, getTopBlockIndex());
 
-        if (globalIndexes.empty())
+        for (const auto amount : amounts)
         {
-            std::stringstream stream;
-
-            stream << "Failed to get any matching outputs for amount " << amount << " ("
-                   << Utilities::formatAmount(amount) << "). Further explanation here: "
-                   << "https://gist.github.com/ZentCashDevelopers/a0e0006d682e6e64fcc984bb1c2f7d8e\n"
-                   << "Note: If you are a public node operator, you can safely ignore this message. "
-                   << "It is only relevant to the user sending the transaction.";
-
-            std::string error = stream.str();
-
-            logger(Logging::ERROR) << error;
-
-            return {false, error};
-        }
-
-        std::sort(globalIndexes.begin(), globalIndexes.end());
-
-        switch (chainsLeaves[0]->extractKeyOutputKeys(
-            amount, getTopBlockIndex(), {globalIndexes.data(), globalIndexes.size()}, publicKeys))
-        {
-            case ExtractOutputKeysResult::SUCCESS:
-            {
-                return {true, ""};
-            }
-            case ExtractOutputKeysResult::INVALID_GLOBAL_INDEX:
+            if (outputs[amount].globalIndexes.empty())
             {
-                std::string error = "Invalid global index is given";
+                std::stringstream stream;
 
-                logger(Logging::DEBUGGING) << error;
+                stream << "Failed to get any matching outputs for amount " << amount << " ("
+                       << Utilities::formatAmount(amount) << "). Further explanation here: "
+                       << "https://gist.github.com/ZentCashDevelopers/a0e0006d682e6e64fcc984bb1c2f7d8e\n"
+                       << "Note: If you are a public node operator, you can safely ignore this message. "
+                       << "It is only relevant to the user sending the transaction.";
 
-                return {false, error};
-            }
-            case ExtractOutputKeysResult::OUTPUT_LOCKED:
-            {
-                std::string error = "Output is locked";
+                std::string error = stream.str();
 
-                logger(Logging::DEBUGGING) << error;
+                logger(Logging::ERROR) << error;
 
                 return {false, error};
             }
-            default:
-            {
-                return {false, "Unknown error"};
-            }
         }
+
+        return {true, ""};
     }
 
     bool Core::getGlobalIndexesForRange(
@@ -1773,23 +1752,23 @@ namespace CryptoNote
         {
             IBlockchainCache *mainChain = chainsLeaves[0];
 
-            std::vector<Crypto::Hash> transactionHashes;
+            std::vector<BinaryArray> transactions;
 
-            for (const auto &rawBlock : mainChain->getBlocksByHeight(startHeight, endHeight))
+            for (auto &rawBlock : mainChain->getBlocksByHeight(startHeight, endHeight))
             {
-                for (const auto &transaction : rawBlock.transactions)
+                for (auto &transaction : rawBlock.transactions)
                 {
-                    transactionHashes.push_back(getBinaryArrayHash(transaction));
+                    transactions.push_back(std::move(transaction));
                 }
 
                 BlockTemplate block;
 
                 fromBinaryArray(block, rawBlock.block);
 
-                transactionHashes.push_back(getBinaryArrayHash(toBinaryArray(block.baseTransaction)));
+                transactions.push_back(toBinaryArray(block.baseTransaction));
             }
 
-            indexes = mainChain->getGlobalIndexes(transactionHashes);
+            indexes = mainChain->getGlobalIndexes(getBinaryArrayHashes(transactions));
 
             return true;
         }
@@ -1840,6 +1819,8 @@ namespace CryptoNote
             return {false, "Transaction already exists in pool"};
         }
 
+        const auto topBlockHash = chainsLeaves[0]->getTopBlockHash();
+
         const auto [success, error] = isTransactionValidForPool(cachedTransaction, validatorState);
         if (!success)
         {
@@ -1853,6 +1834,10 @@ namespace CryptoNote
             return {false, "Transaction already exists in pool"};
         }
 
+        /* Remember that we verified this transaction, so we don't have to
+           check the ring signatures again when it arrives in a block */
+        m_verifiedTransactions.add(transactionHash, topBlockHash);
+
         logger(Logging::DEBUGGING) << "Transaction " << transactionHash << " has been added to pool";
         return {true, ""};
     }
@@ -2256,7 +2241,17 @@ namespace CryptoNote
                 }
 
                 cumulativeSize += rawTransaction.size();
-                transactions.emplace_back(rawTransaction);
+            }
+
+            /* Hash the whole block's transactions together, rather than one
+               at a time as each one is needed */
+            const auto transactionHashes = getBinaryArrayHashes(rawTransactions);
+
+            transactions.reserve(transactions.size() + rawTransactions.size());
+
+            for (size_t i = 0; i < rawTransactions.size(); i++)
+            {
+                transactions.emplace_back(rawTransactions[i], transactionHashes[i]);
             }
         }
         catch (std::runtime_error &e)
@@ -2286,7 +2281,8 @@ namespace CryptoNote
             threadPool,
             blockIndex,
             blockMedianSize,
-            isPoolTransaction
+            isPoolTransaction,
+            false /* Ring signatures not yet verified */
         );
 
         const auto result = txValidator.validate();
@@ -2296,6 +2292,155 @@ namespace CryptoNote
         return result.errorCode;
     }
 
+    std::error_code Core::validateBlockTransactions(
+        const std::vector<CachedTransaction> &transactions,
+        TransactionValidatorState &state,
+        IBlockchainCache *cache,
+        uint64_t &cumulativeFee,
+        uint32_t blockIndex,
+        Crypto::Hash &failedTransactionHash)
+    {
+        cumulativeFee = 0;
+
+        std::vector<std::unique_ptr<ValidateTransaction>> validators;
+        validators.reserve(transactions.size());
+
+        /* Transactions which were verified against the same chain tip when
+         * they entered the pool don't need their ring signatures checked again */
+        const Crypto::Hash previousBlockHash = cache->getBlockHash(blockIndex);
+
+        /* First perform the cheap checks on every transaction. This includes
+         * checking for key images spent twice within the block, since all the
+         * transactions share the same validator state. */
+        for (const auto &transaction : transactions)
+        {
+            validators.push_back(std::make_unique<ValidateTransaction>(
+                transaction,
+                state,
+                cache,
+                currency,
+                checkpoints,
+                m_transactionValidationThreadPool,
+                blockIndex,
+                blockMedianSize,
+                false, /* Not a pool transaction */
+                m_verifiedTransactions.contains(transaction.getTransactionHash(), previousBlockHash)
+            ));
+
+            const auto result = validators.back()->validateWithoutExpensiveInputs();
+
+            if (!result.valid)
+            {
+                failedTransactionHash = transaction.getTransactionHash();
+                return result.errorCode;
+            }
+
+            cumulativeFee += result.fee;
+        }
+
+        /* Every transaction in the block is at the same height, so they are
+         * either all in the checkpoint zone or all not */
+        if (validators.empty() || validators.front()->isInCheckpointZone())
+        {
+            return {};
+        }
+
+        /* Inputs are verified in groups, so their ring signatures can share
+         * the cost of encoding the ring commitments. Small enough groups that
+         * a block still spreads across every thread in the pool. */
+        const size_t inputsPerJob = 16;
+
+        std::vector<std::tuple<ValidateTransaction *, uint64_t>> inputs;
+
+        for (size_t i = 0; i < validators.size(); i++)
+        {
+            const size_t inputCount = transactions[i].getTransaction().inputs.size();
+
+            for (uint64_t inputIndex = 0; inputIndex < inputCount; inputIndex++)
+            {
+                inputs.emplace_back(validators[i].get(), inputIndex);
+            }
+        }
+
+        std::vector<std::future<bool>> validationResults;
+        std::atomic<bool> cancelValidation = false;
+
+        /* Now verify every input of every transaction as one batch, rather
+         * than waiting for each transaction's inputs in turn */
+        for (size_t start = 0; start < inputs.size(); start += inputsPerJob)
+        {
+            const size_t end = std::min(start + inputsPerJob, inputs.size());
+
+            validationResults.push_back(
+                m_transactionValidationThreadPool.addJob([&inputs, start, end, &cancelValidation] {
+                    /* Another job has already failed, and reported the block
+                     * as invalid, so there is no need to fail this one too */
+                    if (cancelValidation)
+                    {
+                        return true;
+                    }
+
+                    const std::vector<std::tuple<ValidateTransaction *, uint64_t>> group(
+                        inputs.begin() + start, inputs.begin() + end);
+
+                    const bool valid = ValidateTransaction::validateInputsExpensive(group);
+
+                    if (!valid)
+                    {
+                        cancelValidation = true;
+                    }
+
+                    return valid;
+                }));
+        }
+
+        bool valid = true;
+
+        /* The first input of the first job which failed */
+        size_t failedInput = 0;
+
+        for (size_t i = 0; i < validationResults.size(); i++)
+        {
+            if (!validationResults[i].get() && valid)
+            {
+                valid = false;
+                failedInput = i * inputsPerJob;
+            }
+        }
+
+        if (valid)
+        {
+            return {};
+        }
+
+        /* Report the first transaction which recorded why it failed */
+        for (size_t i = 0; i < validators.size(); i++)
+        {
+            const auto errorCode = validators[i]->getValidationResult().errorCode;
+
+            if (errorCode)
+            {
+                failedTransactionHash = transactions[i].getTransactionHash();
+                return errorCode;
+            }
+        }
+
+        /* A job failed without recording an error. The block must still be
+         * rejected, so blame the transaction the failed job started with */
+        const ValidateTransaction *failedValidator = std::get<0>(inputs[failedInput]);
+
+        for (size_t i = 0; i < validators.size(); i++)
+        {
+            if (validators[i].get() == failedValidator)
+            {
+                failedTransactionHash = transactions[i].getTransactionHash();
+                break;
+            }
+        }
+
+        return error::TransactionValidationError::INPUT_INVALID_SIGNATURES;
+    }
+
     uint32_t Core::findBlockchainSupplement(const std::vector<Crypto::Hash> &remoteBlockIds) const
     {
         /* Requester doesn't know anything about the chain yet */
@@ -2931,8 +3076,7 @@ namespace CryptoNote
         assert(!chainsStorage.empty());
         assert(!chainsLeaves.empty());
         // FIXME: skip gensis here?
-        auto sizes = chainsLeaves[0]->getLastBlocksSizes(currency.rewardBlocksWindow());
-        uint64_t median = Common::medianValue(sizes);
+        uint64_t median = chainsLeaves[0]->getLastBlocksSizesMedian(currency.rewardBlocksWindow());
         if (median <= nextBlockGrantedFullRewardZone)
         {
             median = nextBlockGrantedFullRewardZone;
@@ -2957,7 +3101,8 @@ namespace CryptoNote
             m_transactionValidationThreadPool,
             blockHeight,
             blockMedianSize,
-            true /* Pool transaction */
+            true, /* Pool transaction */
+            false /* Ring signatures are not checked in revalidateAfterHeightChange() */
         );
 
         const auto result = txValidator.revalidateAfterHeightChange();
@@ -3253,9 +3398,8 @@ namespace CryptoNote
         blockDetails.sizeMedian = 0;
         if (blockDetails.index > 0)
         {
-            auto lastBlocksSizes =
-                segment->getLastBlocksSizes(currency.rewardBlocksWindow(), blockDetails.index - 1, addGenesisBlock);
-            blockDetails.sizeMedian = Common::medianValue(lastBlocksSizes);
+            blockDetails.sizeMedian = segment->getLastBlocksSizesMedian(
+                currency.rewardBlocksWindow(), blockDetails.index - 1, addGenesisBlock);
             prevBlockGeneratedCoins = segment->getAlreadyGeneratedCoins(blockDetails.index - 1);
         }
 
@@ -3594,10 +3738,9 @@ namespace CryptoNote
         size_t nextBlockGrantedFullRewardZone = currency.blockGrantedFullRewardZoneByBlockVersion(
             upgradeManager->getBlockMajorVersion(mainChain->getTopBlockIndex() + 1));
 
-        auto lastBlockSizes = mainChain->getLastBlocksSizes(currency.rewardBlocksWindow());
+        auto lastBlocksSizesMedian = mainChain->getLastBlocksSizesMedian(currency.rewardBlocksWindow());
 
-        blockMedianSize =
-            std::max(Common::medianValue(lastBlockSizes), static_cast<uint64_t>(nextBlockGrantedFullRewardZone));
+        blockMedianSize = std::max(lastBlocksSizesMedian, static_cast<uint64_t>(nextBlockGrantedFullRewardZone));
     }
 
     uint64_t Core::get_current_blockchain_height() const
@@ -21,6 +21,7 @@
 #include "IUpgradeManager.h"
 #include "MessageQueue.h"
 #include "TransactionValidatiorState.h"
+#include "VerifiedTransactionCache.h"
 
 #include <WalletTypes.h>
 #include <ctime>
@@ -64,6 +65,10 @@ namespace CryptoNote
 
         virtual BlockTemplate getBlockByHash(const Crypto::Hash &blockHash) const override;
 
+        virtual std::vector<CachedBlockHeader> getBlockHeaders(uint32_t beginIndex, uint32_t endIndex) const override;
+
+        virtual CachedBlockHeader getBlockHeaderByHash(const Crypto::Hash &blockHash) const override;
+
         virtual std::vector<Crypto::Hash> buildSparseChain() const override;
 
         virtual std::vector<Crypto::Hash> findBlockchainSupplement(
@@ -145,6 +150,8 @@ namespace CryptoNote
 
         virtual std::error_code addBlock(RawBlock &&rawBlock) override;
 
+        virtual void precomputeBlockLongHashes(const std::vector<CachedBlock> &cachedBlocks) override;
+
         virtual std::error_code submitBlock(const BinaryArray &rawBlockTemplate) override;
 
         virtual bool getTransactionGlobalIndexes(
@@ -157,6 +164,13 @@ namespace CryptoNote
             std::vector<uint32_t> &globalIndexes,
             std::vector<Crypto::PublicKey> &publicKeys) const override;
 
+        /* Picks the outputs of every amount together, so the database is read
+           a few times in total rather than a few times per amount */
+        virtual std::tuple<bool, std::string> getRandomOutputs(
+            const std::vector<uint64_t> &amounts,
+            uint16_t count,
+            std::unordered_map<uint64_t, RandomOutputs> &outputs) const override;
+
         virtual bool getGlobalIndexesForRange(
             const uint64_t startHeight,
             const uint64_t endHeight,
@@ -255,6 +269,9 @@ namespace CryptoNote
 
         Utilities::ThreadPool<bool> m_transactionValidationThreadPool;
 
+        /* Pool transactions whose ring signatures we have already verified */
+        VerifiedTransactionCache m_verifiedTransactions;
+
         bool initialized;
 
         time_t start_time;
@@ -277,6 +294,14 @@ namespace CryptoNote
             uint32_t blockIndex,
             const bool isPoolTransaction);
 
+        std::error_code validateBlockTransactions(
+            const std::vector<CachedTransaction> &transactions,
+            TransactionValidatorState &state,
+            IBlockchainCache *cache,
+            uint64_t &cumulativeFee,
+            uint32_t blockIndex,
+            Crypto::Hash &failedTransactionHash);
+
         uint32_t findBlockchainSupplement(const std::vector<Crypto::Hash> &remoteBlockIds) const;
 
         std::vector<Crypto::Hash> getBlockHashes(uint32_t startBlockIndex, uint32_t maxCount) const;
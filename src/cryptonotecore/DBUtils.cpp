@@ -5,36 +5,655 @@
 
 #include "DBUtils.h"
 
+#include "common/MemoryInputStream.h"
+#include "common/StringOutputStream.h"
+#include "serialization/BinaryInputStreamSerializer.h"
+#include "serialization/BinaryOutputStreamSerializer.h"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
 namespace
 {
     const std::string RAW_BLOCK_NAME = "raw_block";
 
     const std::string RAW_TXS_NAME = "raw_txs";
+
+    template<class Integer> void appendBigEndian(std::string &serialized, Integer value)
+    {
+        for (size_t i = sizeof(Integer); i > 0; i--)
+        {
+            serialized.push_back(static_cast<char>(value >> (8 * (i - 1))));
+        }
+    }
+
+    template<class Integer>
+    void readBigEndian(const std::string &serialized, const std::string &keyPrefix, Integer &value)
+    {
+        if (serialized.size() != keyPrefix.size() + sizeof(Integer)
+            || serialized.compare(0, keyPrefix.size(), keyPrefix) != 0)
+        {
+            throw std::runtime_error("Unexpected key in database with prefix " + keyPrefix);
+        }
+
+        value = 0;
+
+        for (size_t i = keyPrefix.size(); i < serialized.size(); i++)
+        {
+            value = (value << 8) | static_cast<uint8_t>(serialized[i]);
+        }
+    }
+
+    class ValueWriter
+    {
+      public:
+        template<class Integer> void writeInteger(Integer value)
+        {
+            for (size_t i = 0; i < sizeof(Integer); i++)
+            {
+                m_serialized.push_back(static_cast<char>(value >> (8 * i)));
+            }
+        }
+
+        void writeBytes(const void *data, size_t size)
+        {
+            m_serialized.append(static_cast<const char *>(data), size);
+        }
+
+        void writeLength(size_t length)
+        {
+            if (length > std::numeric_limits<uint32_t>::max())
+            {
+                throw std::runtime_error("Array is too large to store in the database");
+            }
+
+            writeInteger(static_cast<uint32_t>(length));
+        }
+
+        std::string extract()
+        {
+            return std::move(m_serialized);
+        }
+
+      private:
+        std::string m_serialized;
+    };
+
+    class ValueReader
+    {
+      public:
+        ValueReader(std::string_view serialized): m_serialized(serialized) {}
+
+        template<class Integer> Integer readInteger()
+        {
+            const uint8_t *bytes = consume(sizeof(Integer));
+
+            Integer value = 0;
+
+            for (size_t i = 0; i < sizeof(Integer); i++)
+            {
+                value |= static_cast<Integer>(bytes[i]) << (8 * i);
+            }
+
+            return value;
+        }
+
+        void readBytes(void *data, size_t size)
+        {
+            std::memcpy(data, consume(size), size);
+        }
+
+        /* Checks the length against what is left, so a corrupt length can't
+           make the caller reserve a huge amount of memory */
+        size_t readLength(size_t elementSize)
+        {
+            const size_t length = readInteger<uint32_t>();
+
+            if (length > (m_serialized.size() - m_position) / elementSize)
+            {
+                throw std::runtime_error("Truncated value in database");
+            }
+
+            return length;
+        }
+
+        void readRecordVersion()
+        {
+            const uint8_t version = readInteger<uint8_t>();
+
+            if (version != CryptoNote::DB::RECORD_FORMAT_VERSION)
+            {
+                throw std::runtime_error(
+                    "Unknown database record version " + std::to_string(version) + ". Please update your software.");
+            }
+        }
+
+        void finish() const
+        {
+            if (m_position != m_serialized.size())
+            {
+                throw std::runtime_error("Unexpected trailing bytes in database value");
+            }
+        }
+
+      private:
+        const uint8_t *consume(size_t size)
+        {
+            if (size > m_serialized.size() - m_position)
+            {
+                throw std::runtime_error("Truncated value in database");
+            }
+
+            const uint8_t *bytes = reinterpret_cast<const uint8_t *>(m_serialized.data()) + m_position;
+
+            m_position += size;
+
+            return bytes;
+        }
+
+        std::string_view m_serialized;
+
+        size_t m_position = 0;
+    };
+
+    template<class Integer> std::string serializeInteger(Integer value)
+    {
+        ValueWriter writer;
+        writer.writeInteger(value);
+        return writer.extract();
+    }
+
+    template<class Integer> void deserializeInteger(std::string_view serialized, Integer &value)
+    {
+        ValueReader reader(serialized);
+        value = reader.readInteger<Integer>();
+        reader.finish();
+    }
+
+    template<class Container> std::string serializePODs(const Container &values)
+    {
+        ValueWriter writer;
+
+        for (const auto &value : values)
+        {
+            writer.writeBytes(&value, sizeof(value));
+        }
+
+        return writer.extract();
+    }
+
+    template<class POD> void deserializePODs(std::string_view serialized, std::vector<POD> &values)
+    {
+        if (serialized.size() % sizeof(POD) != 0)
+        {
+            throw std::runtime_error("Unexpected length of database value");
+        }
+
+        values.resize(serialized.size() / sizeof(POD));
+
+        std::memcpy(values.data(), serialized.data(), serialized.size());
+    }
+
+    void writeKeyOutputs(ValueWriter &writer, const std::vector<WalletTypes::KeyOutput> &keyOutputs)
+    {
+        writer.writeLength(keyOutputs.size());
+
+        for (const auto &keyOutput : keyOutputs)
+        {
+            writer.writeBytes(keyOutput.key.data, sizeof(keyOutput.key.data));
+            writer.writeInteger(keyOutput.amount);
+        }
+    }
+
+    void readKeyOutputs(ValueReader &reader, std::vector<WalletTypes::KeyOutput> &keyOutputs)
+    {
+        keyOutputs.resize(reader.readLength(sizeof(Crypto::PublicKey) + sizeof(uint64_t)));
+
+        for (auto &keyOutput : keyOutputs)
+        {
+            reader.readBytes(keyOutput.key.data, sizeof(keyOutput.key.data));
+            keyOutput.amount = reader.readInteger<uint64_t>();
+            keyOutput.globalOutputIndex = std::nullopt;
+        }
+    }
+
+    /* The fields the coinbase transaction shares with the others */
+    void writeWalletTransaction(ValueWriter &writer, const WalletTypes::RawCoinbaseTransaction &transaction)
+    {
+        writer.writeBytes(transaction.hash.data, sizeof(transaction.hash.data));
+        writer.writeBytes(transaction.transactionPublicKey.data, sizeof(transaction.transactionPublicKey.data));
+        writer.writeInteger(transaction.unlockTime);
+        writeKeyOutputs(writer, transaction.keyOutputs);
+    }
+
+    void readWalletTransaction(ValueReader &reader, WalletTypes::RawCoinbaseTransaction &transaction)
+    {
+        reader.readBytes(transaction.hash.data, sizeof(transaction.hash.data));
+        reader.readBytes(transaction.transactionPublicKey.data, sizeof(transaction.transactionPublicKey.data));
+        transaction.unlockTime = reader.readInteger<uint64_t>();
+        readKeyOutputs(reader, transaction.keyOutputs);
+    }
 } // namespace
 
 namespace CryptoNote
 {
     namespace DB
     {
-        std::string serialize(const RawBlock &value, const std::string &name)
+        std::string serialize(uint32_t value)
+        {
+            return serializeInteger(value);
+        }
+
+        std::string serialize(uint64_t value)
+        {
+            return serializeInteger(value);
+        }
+
+        std::string serialize(const Crypto::Hash &value)
+        {
+            return std::string(reinterpret_cast<const char *>(value.data), sizeof(value.data));
+        }
+
+        std::string serialize(const std::vector<Crypto::Hash> &value)
         {
-            std::stringstream ss;
-            Common::StdOutputStream stream(ss);
+            return serializePODs(value);
+        }
+
+        std::string serialize(const std::unordered_set<Crypto::KeyImage> &value)
+        {
+            return serializePODs(value);
+        }
+
+        std::string serialize(const PackedOutIndex &value)
+        {
+            ValueWriter writer;
+            writer.writeInteger(value.blockIndex);
+            writer.writeInteger(value.transactionIndex);
+            writer.writeInteger(value.outputIndex);
+            return writer.extract();
+        }
+
+        std::string serialize(const CachedBlockInfo &value)
+        {
+            ValueWriter writer;
+            writer.writeInteger(RECORD_FORMAT_VERSION);
+            writer.writeBytes(value.blockHash.data, sizeof(value.blockHash.data));
+            writer.writeInteger(value.timestamp);
+            writer.writeInteger(value.cumulativeDifficulty);
+            writer.writeInteger(value.alreadyGeneratedCoins);
+            writer.writeInteger(value.alreadyGeneratedTransactions);
+            writer.writeInteger(value.blockSize);
+            return writer.extract();
+        }
+
+        std::string serialize(const KeyOutputInfo &value)
+        {
+            ValueWriter writer;
+            writer.writeInteger(RECORD_FORMAT_VERSION);
+            writer.writeBytes(value.publicKey.data, sizeof(value.publicKey.data));
+            writer.writeBytes(value.transactionHash.data, sizeof(value.transactionHash.data));
+            writer.writeInteger(value.unlockTime);
+            writer.writeInteger(value.outputIndex);
+            return writer.extract();
+        }
+
+        std::string serialize(const KeyOutputRingMember &value)
+        {
+            ValueWriter writer;
+            writer.writeInteger(RECORD_FORMAT_VERSION);
+            writer.writeBytes(value.publicKey.data, sizeof(value.publicKey.data));
+            writer.writeInteger(value.unlockTime);
+            writer.writeInteger(value.blockIndex);
+            return writer.extract();
+        }
+
+        std::string serialize(const ExtendedTransactionInfo &value)
+        {
+            ValueWriter writer;
+            writer.writeInteger(RECORD_FORMAT_VERSION);
+            writer.writeInteger(value.blockIndex);
+            writer.writeInteger(value.transactionIndex);
+            writer.writeBytes(value.transactionHash.data, sizeof(value.transactionHash.data));
+            writer.writeInteger(value.unlockTime);
+
+            /* Key outputs are the only output type, so only their keys are stored */
+            writer.writeLength(value.outputs.size());
+
+            for (const auto &output : value.outputs)
+            {
+                const auto &key = boost::get<KeyOutput>(output).key;
+                writer.writeBytes(key.data, sizeof(key.data));
+            }
+
+            writer.writeLength(value.globalIndexes.size());
+
+            for (const auto globalIndex : value.globalIndexes)
+            {
+                writer.writeInteger(globalIndex);
+            }
+
+            writer.writeLength(value.amountToKeyIndexes.size());
+
+            for (const auto &[amount, globalIndexes] : value.amountToKeyIndexes)
+            {
+                writer.writeInteger(amount);
+                writer.writeLength(globalIndexes.size());
+
+                for (const auto globalIndex : globalIndexes)
+                {
+                    writer.writeInteger(globalIndex);
+                }
+            }
+
+            return writer.extract();
+        }
+
+        std::string serialize(const RawBlock &value)
+        {
+            std::string serialized;
+            Common::StringOutputStream stream(serialized);
             CryptoNote::BinaryOutputStreamSerializer serializer(stream);
 
             serializer(const_cast<RawBlock &>(value).block, RAW_BLOCK_NAME);
             serializer(const_cast<RawBlock &>(value).transactions, RAW_TXS_NAME);
 
-            return ss.str();
+            return serialized;
+        }
+
+        std::string serialize(const WalletTypes::WalletBlockInfo &value)
+        {
+            ValueWriter writer;
+            writer.writeInteger(RECORD_FORMAT_VERSION);
+            writer.writeInteger(static_cast<uint32_t>(value.blockHeight));
+            writer.writeBytes(value.blockHash.data, sizeof(value.blockHash.data));
+            writer.writeInteger(value.blockTimestamp);
+
+            writer.writeInteger(static_cast<uint8_t>(value.coinbaseTransaction ? 1 : 0));
+
+            if (value.coinbaseTransaction)
+            {
+                writeWalletTransaction(writer, *value.coinbaseTransaction);
+            }
+
+            writer.writeLength(value.transactions.size());
+
+            for (const auto &transaction : value.transactions)
+            {
+                writeWalletTransaction(writer, transaction);
+
+                writer.writeLength(transaction.paymentID.size());
+                writer.writeBytes(transaction.paymentID.data(), transaction.paymentID.size());
+
+                writer.writeLength(transaction.keyInputs.size());
+
+                for (const auto &input : transaction.keyInputs)
+                {
+                    writer.writeInteger(input.amount);
+                    writer.writeBytes(input.keyImage.data, sizeof(input.keyImage.data));
+                    writer.writeLength(input.outputIndexes.size());
+
+                    for (const auto outputIndex : input.outputIndexes)
+                    {
+                        writer.writeInteger(outputIndex);
+                    }
+                }
+            }
+
+            return writer.extract();
+        }
+
+        std::string serialize(const CachedBlockHeader &value)
+        {
+            ValueWriter writer;
+            writer.writeInteger(RECORD_FORMAT_VERSION);
+            writer.writeInteger(value.majorVersion);
+            writer.writeInteger(value.minorVersion);
+            writer.writeInteger(value.timestamp);
+            writer.writeBytes(value.previousBlockHash.data, sizeof(value.previousBlockHash.data));
+            writer.writeInteger(value.nonce);
+            writer.writeBytes(value.blockHash.data, sizeof(value.blockHash.data));
+            writer.writeInteger(value.blockIndex);
+            writer.writeInteger(value.blockSize);
+            writer.writeInteger(value.difficulty);
+            writer.writeInteger(value.reward);
+            writer.writeInteger(value.transactionCount);
+            return writer.extract();
+        }
+
+        void appendKey(std::string &serialized, uint32_t key)
+        {
+            appendBigEndian(serialized, key);
+        }
+
+        void appendKey(std::string &serialized, uint64_t key)
+        {
+            appendBigEndian(serialized, key);
+        }
+
+        void appendKey(std::string &serialized, const Crypto::Hash &key)
+        {
+            serialized.append(reinterpret_cast<const char *>(key.data), sizeof(key.data));
+        }
+
+        void appendKey(std::string &serialized, const Crypto::KeyImage &key)
+        {
+            serialized.append(reinterpret_cast<const char *>(key.data), sizeof(key.data));
+        }
+
+        void appendKey(std::string &serialized, const std::string &key)
+        {
+            serialized.append(key);
+        }
+
+        void deserializeKey(const std::string &serialized, const std::string &keyPrefix, uint32_t &key)
+        {
+            readBigEndian(serialized, keyPrefix, key);
+        }
+
+        void deserializeKey(const std::string &serialized, const std::string &keyPrefix, uint64_t &key)
+        {
+            readBigEndian(serialized, keyPrefix, key);
+        }
+
+        void deserializeKey(const std::string &serialized, const std::string &keyPrefix, Crypto::Hash &key)
+        {
+            if (serialized.size() != keyPrefix.size() + sizeof(key.data)
+                || serialized.compare(0, keyPrefix.size(), keyPrefix) != 0)
+            {
+                throw std::runtime_error("Unexpected key in database with prefix " + keyPrefix);
+            }
+
+            std::memcpy(key.data, serialized.data() + keyPrefix.size(), sizeof(key.data));
+        }
+
+        void deserialize(std::string_view serialized, uint32_t &value)
+        {
+            deserializeInteger(serialized, value);
+        }
+
+        void deserialize(std::string_view serialized, uint64_t &value)
+        {
+            deserializeInteger(serialized, value);
+        }
+
+        void deserialize(std::string_view serialized, Crypto::Hash &value)
+        {
+            ValueReader reader(serialized);
+            reader.readBytes(value.data, sizeof(value.data));
+            reader.finish();
+        }
+
+        void deserialize(std::string_view serialized, std::vector<Crypto::Hash> &value)
+        {
+            deserializePODs(serialized, value);
+        }
+
+        void deserialize(std::string_view serialized, std::vector<Crypto::KeyImage> &value)
+        {
+            deserializePODs(serialized, value);
+        }
+
+        void deserialize(std::string_view serialized, PackedOutIndex &value)
+        {
+            ValueReader reader(serialized);
+            value.blockIndex = reader.readInteger<uint32_t>();
+            value.transactionIndex = reader.readInteger<uint16_t>();
+            value.outputIndex = reader.readInteger<uint16_t>();
+            reader.finish();
+        }
+
+        void deserialize(std::string_view serialized, CachedBlockInfo &value)
+        {
+            ValueReader reader(serialized);
+            reader.readRecordVersion();
+            reader.readBytes(value.blockHash.data, sizeof(value.blockHash.data));
+            value.timestamp = reader.readInteger<uint64_t>();
+            value.cumulativeDifficulty = reader.readInteger<uint64_t>();
+            value.alreadyGeneratedCoins = reader.readInteger<uint64_t>();
+            value.alreadyGeneratedTransactions = reader.readInteger<uint64_t>();
+            value.blockSize = reader.readInteger<uint32_t>();
+            reader.finish();
+        }
+
+        void deserialize(std::string_view serialized, KeyOutputInfo &value)
+        {
+            ValueReader reader(serialized);
+            reader.readRecordVersion();
+            reader.readBytes(value.publicKey.data, sizeof(value.publicKey.data));
+            reader.readBytes(value.transactionHash.data, sizeof(value.transactionHash.data));
+            value.unlockTime = reader.readInteger<uint64_t>();
+            value.outputIndex = reader.readInteger<uint16_t>();
+            reader.finish();
+        }
+
+        void deserialize(std::string_view serialized, KeyOutputRingMember &value)
+        {
+            ValueReader reader(serialized);
+            reader.readRecordVersion();
+            reader.readBytes(value.publicKey.data, sizeof(value.publicKey.data));
+            value.unlockTime = reader.readInteger<uint64_t>();
+            value.blockIndex = reader.readInteger<uint32_t>();
+            reader.finish();
+        }
+
+        void deserialize(std::string_view serialized, ExtendedTransactionInfo &value)
+        {
+            ValueReader reader(serialized);
+            reader.readRecordVersion();
+            value.blockIndex = reader.readInteger<uint32_t>();
+            value.transactionIndex = reader.readInteger<uint32_t>();
+            reader.readBytes(value.transactionHash.data, sizeof(value.transactionHash.data));
+            value.unlockTime = reader.readInteger<uint64_t>();
+
+            value.outputs.resize(reader.readLength(sizeof(Crypto::PublicKey)));
+
+            for (auto &output : value.outputs)
+            {
+                KeyOutput keyOutput;
+                reader.readBytes(keyOutput.key.data, sizeof(keyOutput.key.data));
+                output = keyOutput;
+            }
+
+            value.globalIndexes.resize(reader.readLength(sizeof(uint32_t)));
+
+            for (auto &globalIndex : value.globalIndexes)
+            {
+                globalIndex = reader.readInteger<uint32_t>();
+            }
+
+            value.amountToKeyIndexes.clear();
+
+            const size_t amountCount = reader.readLength(sizeof(uint64_t) + sizeof(uint32_t));
+
+            for (size_t i = 0; i < amountCount; i++)
+            {
+                const uint64_t amount = reader.readInteger<uint64_t>();
+
+                auto &globalIndexes = value.amountToKeyIndexes[amount];
+
+                globalIndexes.resize(reader.readLength(sizeof(uint32_t)));
+
+                for (auto &globalIndex : globalIndexes)
+                {
+                    globalIndex = reader.readInteger<uint32_t>();
+                }
+            }
+
+            reader.finish();
         }
 
-        void deserialize(const std::string &serialized, RawBlock &value, const std::string &name)
+        void deserialize(std::string_view serialized, RawBlock &value)
         {
-            std::stringstream ss(serialized);
-            Common::StdInputStream stream(ss);
+            Common::MemoryInputStream stream(serialized.data(), serialized.size());
             CryptoNote::BinaryInputStreamSerializer serializer(stream);
             serializer(value.block, RAW_BLOCK_NAME);
             serializer(value.transactions, RAW_TXS_NAME);
         }
+
+        void deserialize(std::string_view serialized, WalletTypes::WalletBlockInfo &value)
+        {
+            ValueReader reader(serialized);
+            reader.readRecordVersion();
+            value.blockHeight = reader.readInteger<uint32_t>();
+            reader.readBytes(value.blockHash.data, sizeof(value.blockHash.data));
+            value.blockTimestamp = reader.readInteger<uint64_t>();
+
+            value.coinbaseTransaction = std::nullopt;
+
+            if (reader.readInteger<uint8_t>() != 0)
+            {
+                readWalletTransaction(reader, value.coinbaseTransaction.emplace());
+            }
+
+            /* Hash, public key, unlock time and three lengths at the least */
+            const size_t minTransactionSize =
+                sizeof(Crypto::Hash) + sizeof(Crypto::PublicKey) + sizeof(uint64_t) + 3 * sizeof(uint32_t);
+
+            value.transactions.resize(reader.readLength(minTransactionSize));
+
+            for (auto &transaction : value.transactions)
+            {
+                readWalletTransaction(reader, transaction);
+
+                transaction.paymentID.resize(reader.readLength(sizeof(char)));
+                reader.readBytes(transaction.paymentID.data(), transaction.paymentID.size());
+
+                transaction.keyInputs.resize(
+                    reader.readLength(sizeof(uint64_t) + sizeof(Crypto::KeyImage) + sizeof(uint32_t)));
+
+                for (auto &input : transaction.keyInputs)
+                {
+                    input.amount = reader.readInteger<uint64_t>();
+                    reader.readBytes(input.keyImage.data, sizeof(input.keyImage.data));
+                    input.outputIndexes.resize(reader.readLength(sizeof(uint32_t)));
+
+                    for (auto &outputIndex : input.outputIndexes)
+                    {
+                        outputIndex = reader.readInteger<uint32_t>();
+                    }
+                }
+            }
+
+            reader.finish();
+        }
+
+        void deserialize(std::string_view serialized, CachedBlockHeader &value)
+        {
+            ValueReader reader(serialized);
+            reader.readRecordVersion();
+            value.majorVersion = reader.readInteger<uint8_t>();
+            value.minorVersion = reader.readInteger<uint8_t>();
+            value.timestamp = reader.readInteger<uint64_t>();
+            reader.readBytes(value.previousBlockHash.data, sizeof(value.previousBlockHash.data));
+            value.nonce = reader.readInteger<uint32_t>();
+            reader.readBytes(value.blockHash.data, sizeof(value.blockHash.data));
+            value.blockIndex = reader.readInteger<uint32_t>();
+            value.blockSize = reader.readInteger<uint64_t>();
+            value.difficulty = reader.readInteger<uint64_t>();
+            value.reward = reader.readInteger<uint64_t>();
+            value.transactionCount = reader.readInteger<uint32_t>();
+            reader.finish();
+        }
     } // namespace DB
 } // namespace CryptoNote
@@ -5,16 +5,13 @@
 
 #pragma once
 
-#include "common/StdInputStream.h"
-#include "common/StdOutputStream.h"
 #include "cryptonotecore/CryptoNoteFormatUtils.h"
-#include "serialization/CryptoNoteSerialization.h"
-#include "serialization/KVBinaryInputStreamSerializer.h"
-#include "serialization/KVBinaryOutputStreamSerializer.h"
-#include "serialization/SerializationOverloads.h"
+#include "cryptonotecore/DatabaseCacheData.h"
 
-#include <sstream>
+#include <WalletTypes.h>
 #include <string>
+#include <string_view>
+#include <unordered_set>
 
 namespace CryptoNote
 {
@@ -56,40 +53,116 @@ namespace CryptoNote
 
         const std::string KEY_OUTPUT_KEY_PREFIX = "j";
 
-        template<class Value> std::string serialize(const Value &value, const std::string &name)
-        {
-            CryptoNote::KVBinaryOutputStreamSerializer serializer;
-            std::stringstream ss;
-            Common::StdOutputStream stream(ss);
+        const std::string KEY_OUTPUT_RING_MEMBER_PREFIX = "k";
 
-            serializer(const_cast<Value &>(value), name);
-            serializer.dump(stream);
+        const std::string BLOCK_INDEX_TO_WALLET_SYNC_RECORD_PREFIX = "l";
 
-            return ss.str();
-        }
+        /* Only blocks with transactions other than the coinbase have a key here */
+        const std::string NON_EMPTY_BLOCK_INDEX_PREFIX = "m";
 
-        std::string serialize(const RawBlock &value, const std::string &name);
+        const std::string BLOCK_INDEX_TO_BLOCK_HEADER_PREFIX = "n";
 
-        template<class Key, class Value>
-        std::pair<std::string, std::string> serialize(const std::string &keyPrefix, const Key &key, const Value &value)
+        /* The version byte that starts each record value, so the layout of a record
+           can change without changing the database scheme version */
+        const uint8_t RECORD_FORMAT_VERSION = 1;
+
+        /* Values are written in a fixed binary layout, integers little endian, so
+           they can be decoded straight from the buffer the database read them
+           into. Records start with RECORD_FORMAT_VERSION, and arrays with their
+           length, apart from arrays of hashes, which fill the whole value. */
+        std::string serialize(uint32_t value);
+
+        std::string serialize(uint64_t value);
+
+        std::string serialize(const Crypto::Hash &value);
+
+        std::string serialize(const std::vector<Crypto::Hash> &value);
+
+        std::string serialize(const std::unordered_set<Crypto::KeyImage> &value);
+
+        std::string serialize(const PackedOutIndex &value);
+
+        std::string serialize(const CachedBlockInfo &value);
+
+        std::string serialize(const KeyOutputInfo &value);
+
+        std::string serialize(const KeyOutputRingMember &value);
+
+        std::string serialize(const ExtendedTransactionInfo &value);
+
+        std::string serialize(const RawBlock &value);
+
+        std::string serialize(const WalletTypes::WalletBlockInfo &value);
+
+        std::string serialize(const CachedBlockHeader &value);
+
+        /* Keys are the prefix followed by each field of the key. Integers are written
+           big endian at their full width, so the keys of a prefix sort in the same
+           order as the block indexes or timestamps they hold, and a range of those
+           can be read as a range of keys. */
+        void appendKey(std::string &serialized, uint32_t key);
+
+        void appendKey(std::string &serialized, uint64_t key);
+
+        void appendKey(std::string &serialized, const Crypto::Hash &key);
+
+        void appendKey(std::string &serialized, const Crypto::KeyImage &key);
+
+        void appendKey(std::string &serialized, const std::string &key);
+
+        template<class First, class Second>
+        void appendKey(std::string &serialized, const std::pair<First, Second> &key)
         {
-            return {DB::serialize(std::make_pair(keyPrefix, key), keyPrefix), DB::serialize(value, keyPrefix)};
+            appendKey(serialized, key.first);
+            appendKey(serialized, key.second);
         }
 
         template<class Key> std::string serializeKey(const std::string &keyPrefix, const Key &key)
         {
-            return DB::serialize(std::make_pair(keyPrefix, key), keyPrefix);
+            std::string serialized = keyPrefix;
+            appendKey(serialized, key);
+            return serialized;
         }
 
-        template<class Value> void deserialize(const std::string &serialized, Value &value, const std::string &name)
+        template<class Key, class Value>
+        std::pair<std::string, std::string> serialize(const std::string &keyPrefix, const Key &key, const Value &value)
         {
-            std::stringstream ss(serialized);
-            Common::StdInputStream stream(ss);
-            CryptoNote::KVBinaryInputStreamSerializer serializer(stream);
-            serializer(value, name);
+            return {DB::serializeKey(keyPrefix, key), DB::serialize(value)};
         }
 
-        void deserialize(const std::string &serialized, RawBlock &value, const std::string &name);
+        void deserializeKey(const std::string &serialized, const std::string &keyPrefix, uint32_t &key);
+
+        void deserializeKey(const std::string &serialized, const std::string &keyPrefix, uint64_t &key);
+
+        void deserializeKey(const std::string &serialized, const std::string &keyPrefix, Crypto::Hash &key);
+
+        /* These throw std::runtime_error if the value is truncated, has bytes left
+           over, or is a record of an unknown version */
+        void deserialize(std::string_view serialized, uint32_t &value);
+
+        void deserialize(std::string_view serialized, uint64_t &value);
+
+        void deserialize(std::string_view serialized, Crypto::Hash &value);
+
+        void deserialize(std::string_view serialized, std::vector<Crypto::Hash> &value);
+
+        void deserialize(std::string_view serialized, std::vector<Crypto::KeyImage> &value);
+
+        void deserialize(std::string_view serialized, PackedOutIndex &value);
+
+        void deserialize(std::string_view serialized, CachedBlockInfo &value);
+
+        void deserialize(std::string_view serialized, KeyOutputInfo &value);
+
+        void deserialize(std::string_view serialized, KeyOutputRingMember &value);
+
+        void deserialize(std::string_view serialized, ExtendedTransactionInfo &value);
+
+        void deserialize(std::string_view serialized, RawBlock &value);
+
+        void deserialize(std::string_view serialized, WalletTypes::WalletBlockInfo &value);
+
+        void deserialize(std::string_view serialized, CachedBlockHeader &value);
 
         template<class Key, class Value>
         void serializeKeys(
@@ -104,16 +177,13 @@ namespace CryptoNote
         }
 
         template<class Key, class Value, class Iterator>
-        void deserializeValues(
-            std::unordered_map<Key, Value> &map,
-            Iterator &serializedValuesIter,
-            const std::string &name)
+        void deserializeValues(std::unordered_map<Key, Value> &map, Iterator &serializedValuesIter)
         {
             for (auto iter = map.begin(); iter != map.end(); ++serializedValuesIter)
             {
                 if (boost::get<1>(*serializedValuesIter))
                 {
-                    DB::deserialize(boost::get<0>(*serializedValuesIter), iter->second, name);
+                    DB::deserialize(boost::get<0>(*serializedValuesIter), iter->second);
                     ++iter;
                 }
                 else
@@ -123,14 +193,28 @@ namespace CryptoNote
             }
         }
 
+        template<class Key, class Value>
+        void deserializeRange(
+            std::unordered_map<Key, Value> &map,
+            const std::vector<std::pair<std::string, std::string>> &keyValues,
+            const std::string &keyPrefix)
+        {
+            for (const auto &[serializedKey, serializedValue] : keyValues)
+            {
+                Key key;
+                DB::deserializeKey(serializedKey, keyPrefix, key);
+                DB::deserialize(serializedValue, map[key]);
+            }
+        }
+
         template<class Value, class Iterator>
-        void deserializeValue(std::pair<Value, bool> &pair, Iterator &serializedValuesIter, const std::string &name)
+        void deserializeValue(std::pair<Value, bool> &pair, Iterator &serializedValuesIter)
         {
             if (pair.second)
             {
                 if (boost::get<1>(*serializedValuesIter))
                 {
-                    DB::deserialize(boost::get<0>(*serializedValuesIter), pair.first, name);
+                    DB::deserialize(boost::get<0>(*serializedValuesIter), pair.first);
                 }
                 else
                 {
@@ -9,12 +9,16 @@
 
 #include <boost/iterator/iterator_facade.hpp>
 #include <common/CryptoNoteTools.h>
+#include <common/Math.h>
 #include <common/ShuffleGenerator.h>
 #include <common/TransactionExtra.h>
 #include <cryptonotecore/BlockchainStorage.h>
 #include <cryptonotecore/CryptoNoteBasicImpl.h>
+#include <cryptonotecore/DBUtils.h>
 #include <cryptonotecore/DatabaseBlockchainCache.h>
+#include <cryptonotecore/WalletSyncRecord.h>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 
 namespace CryptoNote
@@ -62,49 +66,6 @@ namespace CryptoNote
             return true;
         }
 
-        bool requestTransactionHashesForGlobalOutputIndexes(
-            const std::vector<PackedOutIndex> &packedOuts,
-            IDataBase &database,
-            std::vector<Crypto::Hash> &transactionHashes)
-        {
-            BlockchainReadBatch readHashesBatch;
-
-            std::set<uint32_t> blockIndexes;
-            std::for_each(packedOuts.begin(), packedOuts.end(), [&blockIndexes](PackedOutIndex out) {
-                blockIndexes.insert(out.blockIndex);
-            });
-            std::for_each(blockIndexes.begin(), blockIndexes.end(), [&readHashesBatch](uint32_t blockIndex) {
-                readHashesBatch.requestTransactionHashesByBlock(blockIndex);
-            });
-
-            auto dbResult = database.read(readHashesBatch);
-            if (dbResult)
-            {
-                return false;
-            }
-
-            auto readResult = readHashesBatch.extractResult();
-            const auto &transactionHashesMap = readResult.getTransactionHashesByBlocks();
-
-            if (transactionHashesMap.size() != blockIndexes.size())
-            {
-                return false;
-            }
-
-            transactionHashes.reserve(transactionHashes.size() + packedOuts.size());
-            for (const auto &output : packedOuts)
-            {
-                if (output.transactionIndex >= transactionHashesMap.at(output.blockIndex).size())
-                {
-                    return false;
-                }
-
-                transactionHashes.push_back(transactionHashesMap.at(output.blockIndex)[output.transactionIndex]);
-            }
-
-            return true;
-        }
-
         bool requestCachedTransactionInfos(
             const std::vector<Crypto::Hash> &transactionHashes,
             IDataBase &database,
@@ -138,17 +99,6 @@ namespace CryptoNote
             return true;
         }
 
-        // returns CachedTransactionInfos in the same or as packedOuts are
-        /*
-        bool requestCachedTransactionInfos(const std::vector<PackedOutIndex>& packedOuts, IDataBase& database,
-        std::vector<CachedTransactionInfo>& result) { std::vector<Crypto::Hash> transactionHashes; if
-        (!requestTransactionHashesForGlobalOutputIndexes(packedOuts, database, transactionHashes)) { return false;
-          }
-
-          return requestCachedTransactionInfos(transactionHashes, database, result);
-        }
-        */
-
         bool requestExtendedTransactionInfos(
             const std::vector<Crypto::Hash> &transactionHashes,
             IDataBase &database,
@@ -185,21 +135,6 @@ namespace CryptoNote
             return true;
         }
 
-        // returns ExtendedTransactionInfos in the same order as packedOuts are
-        bool requestExtendedTransactionInfos(
-            const std::vector<PackedOutIndex> &packedOuts,
-            IDataBase &database,
-            std::vector<ExtendedTransactionInfo> &result)
-        {
-            std::vector<Crypto::Hash> transactionHashes;
-            if (!requestTransactionHashesForGlobalOutputIndexes(packedOuts, database, transactionHashes))
-            {
-                return false;
-            }
-
-            return requestExtendedTransactionInfos(transactionHashes, database, result);
-        }
-
         uint64_t roundToMidnight(uint64_t timestamp)
         {
             if (timestamp > static_cast<uint64_t>(std::numeric_limits<time_t>::max()))
@@ -467,17 +402,6 @@ namespace CryptoNote
             }
         }
 
-        void cutTail(std::deque<CachedBlockInfo> &cache, size_t count)
-        {
-            if (count >= cache.size())
-            {
-                cache.clear();
-                return;
-            }
-
-            cache.erase(std::next(cache.begin(), cache.size() - count), cache.end());
-        }
-
         const std::string DB_VERSION_KEY = "db_scheme_version";
 
         class DatabaseVersionReadBatch : public IReadBatch
@@ -490,8 +414,9 @@ namespace CryptoNote
                 return {DB_VERSION_KEY};
             }
 
-            virtual void
-                submitRawResult(const std::vector<std::string> &values, const std::vector<bool> &resultStates) override
+            virtual void submitRawResult(
+                const std::vector<std::string_view> &values,
+                const std::vector<bool> &resultStates) override
             {
                 assert(values.size() == 1);
                 assert(resultStates.size() == values.size());
@@ -501,7 +426,7 @@ namespace CryptoNote
                     return;
                 }
 
-                version = static_cast<uint32_t>(std::atoi(values[0].c_str()));
+                version = static_cast<uint32_t>(std::stoul(std::string(values[0])));
             }
 
             boost::optional<uint32_t> getDbSchemeVersion()
@@ -534,7 +459,129 @@ namespace CryptoNote
             uint32_t schemeVersion;
         };
 
-        const uint32_t CURRENT_DB_SCHEME_VERSION = 2;
+        /* The top block hash the filter was saved at, then the filter */
+        const std::string KEY_IMAGE_FILTER_KEY = "spent_key_image_filter";
+
+        /* How many blocks of spent key images to read at once when building the filter */
+        const uint32_t KEY_IMAGE_FILTER_BUILD_BLOCKS = 1000;
+
+        const uint64_t KEY_IMAGE_FILTER_MIN_CAPACITY = 1 << 20;
+
+        /* Reads a page of the block hash to block index records */
+        class BlockIndexesByHashReadBatch : public IReadBatch
+        {
+          public:
+            BlockIndexesByHashReadBatch(std::string begin, size_t limit)
+            {
+                range.begin = std::move(begin);
+                range.end = std::string(1, static_cast<char>(DB::BLOCK_HASH_TO_BLOCK_INDEX_PREFIX[0] + 1));
+                range.limit = limit;
+            }
+
+            virtual std::vector<std::string> getRawKeys() const override
+            {
+                return {};
+            }
+
+            virtual void submitRawResult(
+                const std::vector<std::string_view> &values,
+                const std::vector<bool> &resultStates) override
+            {
+            }
+
+            virtual std::vector<RawKeyRange> getRawKeyRanges() const override
+            {
+                return {range};
+            }
+
+            virtual void submitRawRangeResult(
+                const std::vector<std::vector<std::pair<std::string, std::string>>> &keyValues) override
+            {
+                assert(keyValues.size() == 1);
+                this->keyValues = keyValues[0];
+            }
+
+            const std::vector<std::pair<std::string, std::string>> &getKeyValues() const
+            {
+                return keyValues;
+            }
+
+          private:
+            RawKeyRange range;
+
+            std::vector<std::pair<std::string, std::string>> keyValues;
+        };
+
+        const size_t BLOCK_HASH_TABLE_LOAD_BATCH_SIZE = 100000;
+
+        class KeyImageFilterReadBatch : public IReadBatch
+        {
+          public:
+            virtual std::vector<std::string> getRawKeys() const override
+            {
+                return {KEY_IMAGE_FILTER_KEY};
+            }
+
+            virtual void submitRawResult(
+                const std::vector<std::string_view> &values,
+                const std::vector<bool> &resultStates) override
+            {
+                assert(values.size() == 1);
+                assert(resultStates.size() == values.size());
+
+                if (resultStates[0])
+                {
+                    serializedFilter = std::string(values[0]);
+                }
+            }
+
+            boost::optional<std::string> getSerializedFilter() const
+            {
+                return serializedFilter;
+            }
+
+          private:
+            boost::optional<std::string> serializedFilter;
+        };
+
+        /* Stores the filter, or removes it when there's none */
+        class KeyImageFilterWriteBatch : public IWriteBatch
+        {
+          public:
+            KeyImageFilterWriteBatch(boost::optional<std::string> serializedFilter):
+                serializedFilter(std::move(serializedFilter))
+            {
+            }
+
+            virtual std::vector<std::pair<std::string, std::string>> extractRawDataToInsert() override
+            {
+                if (!serializedFilter)
+                {
+                    return {};
+                }
+
+                return {make_pair(KEY_IMAGE_FILTER_KEY, std::move(*serializedFilter))};
+            }
+
+            virtual std::vector<std::string> extractRawKeysToRemove() override
+            {
+                if (serializedFilter)
+                {
+                    return {};
+                }
+
+                return {KEY_IMAGE_FILTER_KEY};
+            }
+
+          private:
+            boost::optional<std::string> serializedFilter;
+        };
+
+        /* Version 3 moved to fixed width, big endian keys and compact values,
+           and added the ring member, wallet sync record, non empty block and
+           block header records. Older databases are destroyed and rebuilt from
+           blocks.bin by checkDBSchemeVersion. */
+        const uint32_t CURRENT_DB_SCHEME_VERSION = 3;
 
     } // namespace
 
@@ -552,7 +599,8 @@ namespace CryptoNote
         currency(curr),
         database(dataBase),
         blockchainCacheFactory(blockchainCacheFactory),
-        logger(_logger, "DatabaseBlockchainCache")
+        logger(_logger, "DatabaseBlockchainCache"),
+        rewardWindowBlockSizes(curr.rewardBlocksWindow())
     {
         DatabaseVersionReadBatch readBatch;
         auto ec = database.read(readBatch);
@@ -583,6 +631,171 @@ namespace CryptoNote
             logger(Logging::DEBUGGING) << "top block index is null, add genesis block";
             addGenesisBlock(CachedBlock(currency.genesisBlock()));
         }
+
+        loadBlockHashTable();
+
+        loadUnitsCache();
+
+        updateNextBlockDifficulty();
+
+        loadSpentKeyImageFilter();
+    }
+
+    void DatabaseBlockchainCache::loadBlockHashTable()
+    {
+        const uint32_t blockCount = getTopBlockIndex() + 1;
+
+        std::vector<Crypto::Hash> hashes(blockCount);
+        uint32_t loaded = 0;
+
+        std::string begin = DB::BLOCK_HASH_TO_BLOCK_INDEX_PREFIX;
+
+        while (true)
+        {
+            BlockIndexesByHashReadBatch readBatch(begin, BLOCK_HASH_TABLE_LOAD_BATCH_SIZE);
+
+            auto error = database.read(readBatch);
+            if (error)
+            {
+                logger(Logging::ERROR) << "Failed to read block hashes from database";
+                throw std::system_error(error);
+            }
+
+            const auto &keyValues = readBatch.getKeyValues();
+
+            for (const auto &[key, value] : keyValues)
+            {
+                Crypto::Hash blockHash;
+                DB::deserializeKey(key, DB::BLOCK_HASH_TO_BLOCK_INDEX_PREFIX, blockHash);
+
+                uint32_t blockIndex;
+                DB::deserialize(value, blockIndex);
+
+                if (blockIndex < blockCount)
+                {
+                    hashes[blockIndex] = blockHash;
+                    loaded++;
+                }
+            }
+
+            if (keyValues.size() < BLOCK_HASH_TABLE_LOAD_BATCH_SIZE)
+            {
+                break;
+            }
+
+            begin = keyValues.back().first + '\0';
+        }
+
+        if (loaded != blockCount)
+        {
+            logger(Logging::ERROR) << "Found " << loaded << " block hashes in database, expected " << blockCount;
+            throw std::runtime_error("Block hashes are missing from the database");
+        }
+
+        blockHashTable.load(hashes);
+
+        logger(Logging::DEBUGGING) << "Loaded " << blockCount << " block hashes";
+    }
+
+    void DatabaseBlockchainCache::loadUnitsCache()
+    {
+        const auto units = getLastDbUnits(getTopBlockIndex(), unitsCacheSize, UseGenesis {true});
+
+        unitsCache.assign(units.begin(), units.end());
+
+        std::scoped_lock<std::mutex> lock(rewardWindowMutex);
+
+        rewardWindowBlockSizes.clear();
+
+        for (const auto &unit : unitsCache)
+        {
+            rewardWindowBlockSizes.push(unit.blockSize);
+        }
+
+        rewardWindowTopIndex = getTopBlockIndex();
+    }
+
+    void DatabaseBlockchainCache::loadSpentKeyImageFilter()
+    {
+        KeyImageFilterReadBatch readBatch;
+        auto ec = database.read(readBatch);
+        if (ec)
+        {
+            throw std::system_error(ec);
+        }
+
+        const auto serialized = readBatch.getSerializedFilter();
+
+        if (serialized)
+        {
+            /* Only kept in the database while the daemon is stopped, so after a
+               crash it's rebuilt rather than missing the key images spent since */
+            KeyImageFilterWriteBatch writeBatch(boost::none);
+            auto writeError = database.write(writeBatch);
+            if (writeError)
+            {
+                throw std::system_error(writeError);
+            }
+
+            const std::string_view view(*serialized);
+            const Crypto::Hash &topHash = getTopBlockHash();
+
+            if (view.size() >= sizeof(topHash) && std::memcmp(view.data(), topHash.data, sizeof(topHash)) == 0
+                && spentKeyImageFilter.deserialize(view.substr(sizeof(topHash))) && !spentKeyImageFilter.isOverfull())
+            {
+                logger(Logging::DEBUGGING) << "Loaded spent key image filter with capacity "
+                                           << spentKeyImageFilter.getCapacity();
+                return;
+            }
+        }
+
+        buildSpentKeyImageFilter(KEY_IMAGE_FILTER_MIN_CAPACITY);
+    }
+
+    void DatabaseBlockchainCache::buildSpentKeyImageFilter(uint64_t minCapacity)
+    {
+        logger(Logging::INFO) << "Building spent key image filter, this may take a while...";
+
+        const uint64_t blockCount = static_cast<uint64_t>(getTopBlockIndex()) + 1;
+
+        const auto forEachSpentKeyImages = [&](const auto &handler) {
+            for (uint64_t startIndex = 0; startIndex < blockCount; startIndex += KEY_IMAGE_FILTER_BUILD_BLOCKS)
+            {
+                const uint64_t endIndex = std::min(startIndex + KEY_IMAGE_FILTER_BUILD_BLOCKS, blockCount);
+
+                auto batch = BlockchainReadBatch().requestSpentKeyImagesByBlocks(
+                    static_cast<uint32_t>(startIndex), static_cast<uint32_t>(endIndex));
+
+                const auto result = readDatabase(batch);
+
+                for (const auto &[blockIndex, keyImages] : result.getSpentKeyImagesByBlock())
+                {
+                    handler(keyImages);
+                }
+            }
+        };
+
+        uint64_t keyImagesCount = 0;
+
+        forEachSpentKeyImages(
+            [&](const std::vector<Crypto::KeyImage> &keyImages) { keyImagesCount += keyImages.size(); });
+
+        /* Room for as many key images again before the next rebuild */
+        KeyImageFilter filter(std::max(keyImagesCount * 2, minCapacity));
+
+        forEachSpentKeyImages([&](const std::vector<Crypto::KeyImage> &keyImages) {
+            for (const auto &keyImage : keyImages)
+            {
+                filter.insert(keyImage);
+            }
+        });
+
+        {
+            std::unique_lock<std::shared_mutex> lock(spentKeyImageFilterMutex);
+            spentKeyImageFilter = std::move(filter);
+        }
+
+        logger(Logging::INFO) << "Built spent key image filter from " << keyImagesCount << " key images";
     }
 
     bool DatabaseBlockchainCache::checkDBSchemeVersion(IDataBase &database, std::shared_ptr<Logging::ILogger> _logger)
@@ -650,12 +863,10 @@ namespace CryptoNote
         }
 
         BlockchainReadBatch midnightBatch;
-        while (readDatabase(midnightBatch.requestClosestTimestampBlockIndex(midnight))
-                   .getClosestTimestampBlockIndex()
-                   .count(midnight))
+        auto midnightResult = readDatabase(midnightBatch.requestClosestTimestampBlockIndexesFrom(midnight));
+        for (const auto &kv : midnightResult.getClosestTimestampBlockIndex())
         {
-            writeBatch.removeClosestTimestampBlockIndex(midnight);
-            midnight += ONE_DAY_SECONDS;
+            writeBatch.removeClosestTimestampBlockIndex(kv.first);
         }
 
         logger(Logging::TRACE) << "deleted closest timestamp";
@@ -696,7 +907,11 @@ namespace CryptoNote
             auto &validatorState = std::get<2>(*it);
             uint64_t timestamp = std::get<3>(*it);
 
-            writeBatch.removeCachedBlock(blockHash, blockIndex).removeRawBlock(blockIndex);
+            writeBatch.removeCachedBlock(blockHash, blockIndex)
+                .removeRawBlock(blockIndex)
+                .removeWalletSyncRecord(blockIndex)
+                .removeNonEmptyBlockIndex(blockIndex)
+                .removeBlockHeader(blockIndex);
             requestDeleteSpentOutputs(writeBatch, blockIndex, validatorState);
             requestRemoveTimestamp(writeBatch, timestamp, blockHash);
         }
@@ -733,16 +948,25 @@ namespace CryptoNote
             throw std::runtime_error(err.message());
         }
 
-        cutTail(unitsCache, currentTop + 1 - splitBlockIndex);
-
         children.push_back(cache.get());
         logger(Logging::TRACE) << "Delete successfull";
 
+        blockHashTable.truncate(splitBlockIndex);
+
         // invalidate top block index and hash
         topBlockIndex = boost::none;
         topBlockHash = boost::none;
         transactionsCount = boost::none;
 
+        {
+            std::scoped_lock<std::mutex> lock(unlockedKeyOutputCountsMutex);
+            unlockedKeyOutputCounts.clear();
+        }
+
+        loadUnitsCache();
+
+        updateNextBlockDifficulty();
+
         logger(Logging::DEBUGGING) << "split completed";
         // return new cache
         return cache;
@@ -860,6 +1084,8 @@ namespace CryptoNote
 
         std::vector<Crypto::KeyImage> spentKeys(spentOutputs.spentKeyImages.begin(), spentOutputs.spentKeyImages.end());
 
+        /* These stay in spentKeyImageFilter, which can't remove them, so checking
+           them again just costs a database read */
         writeBatch.removeSpentKeyImages(blockIndex, spentKeys);
     }
 
@@ -905,6 +1131,7 @@ namespace CryptoNote
         for (GlobalOutputIndex index = boundary; index < outputsCount; ++index)
         {
             writeBatch.removeKeyOutputInfo(amount, index);
+            writeBatch.removeKeyOutputRingMember(amount, index);
         }
 
         updateKeyOutputCount(amount, boundary - outputsCount);
@@ -994,6 +1221,13 @@ namespace CryptoNote
                 outputInfo.outputIndex = poi.outputIndex;
 
                 batch.insertKeyOutputInfo(output.amount, globalIndex, outputInfo);
+
+                KeyOutputRingMember ringMember;
+                ringMember.publicKey = outputInfo.publicKey;
+                ringMember.unlockTime = outputInfo.unlockTime;
+                ringMember.blockIndex = blockIndex;
+
+                batch.insertKeyOutputRingMember(output.amount, globalIndex, ringMember);
             }
         }
 
@@ -1059,6 +1293,142 @@ namespace CryptoNote
         return it->second;
     }
 
+    std::unordered_map<DatabaseBlockchainCache::Amount, uint32_t> DatabaseBlockchainCache::getUnlockedKeyOutputCounts(
+        const std::vector<Amount> &amounts,
+        uint32_t upperBlockIndex) const
+    {
+        BlockchainReadBatch countBatch;
+        for (const auto amount : amounts)
+        {
+            countBatch.requestKeyOutputGlobalIndexesCountForAmount(amount);
+        }
+
+        const auto outputCounts = readDatabase(countBatch).getKeyOutputGlobalIndexesCountForAmounts();
+
+        /* Outputs below lower are in blocks up to upperBlockIndex, and those from
+           upper on aren't. Probes start out stepping further ahead each time, as
+           the count has usually only grown by a few outputs since it was last
+           found, then halve the gap once one overshoots. */
+        struct Search
+        {
+            uint32_t lower;
+
+            uint32_t upper;
+
+            uint64_t step;
+
+            bool galloping;
+        };
+
+        std::unordered_map<Amount, Search> searches;
+
+        {
+            std::scoped_lock<std::mutex> lock(unlockedKeyOutputCountsMutex);
+
+            for (const auto amount : amounts)
+            {
+                const auto outputCount = outputCounts.find(amount);
+
+                Search search {0, outputCount != outputCounts.end() ? outputCount->second : 0, 1, true};
+
+                const auto cached = unlockedKeyOutputCounts.find(amount);
+
+                if (cached != unlockedKeyOutputCounts.end())
+                {
+                    if (cached->second.upperBlockIndex <= upperBlockIndex)
+                    {
+                        search.lower = std::min(cached->second.count, search.upper);
+                    }
+
+                    if (cached->second.upperBlockIndex >= upperBlockIndex)
+                    {
+                        search.upper = std::min(cached->second.count, search.upper);
+                    }
+                }
+
+                searches.emplace(amount, search);
+            }
+        }
+
+        /* Each round probes every amount still being searched in one read */
+        while (true)
+        {
+            BlockchainReadBatch probeBatch;
+            std::vector<std::pair<Amount, uint32_t>> probes;
+
+            for (const auto &[amount, search] : searches)
+            {
+                if (search.lower >= search.upper)
+                {
+                    continue;
+                }
+
+                const uint32_t probe = search.galloping
+                                           ? static_cast<uint32_t>(std::min<uint64_t>(
+                                               search.lower + search.step - 1, search.upper - 1))
+                                           : search.lower + (search.upper - search.lower) / 2;
+
+                probeBatch.requestKeyOutputRingMember(amount, probe);
+                probes.emplace_back(amount, probe);
+            }
+
+            if (probes.empty())
+            {
+                break;
+            }
+
+            const auto ringMembers = readDatabase(probeBatch).getKeyOutputRingMembers();
+
+            for (const auto &[amount, probe] : probes)
+            {
+                const auto ringMember = ringMembers.find({amount, probe});
+
+                if (ringMember == ringMembers.end())
+                {
+                    logger(Logging::ERROR) << "getUnlockedKeyOutputCounts: output " << probe << " of amount " << amount
+                                           << " is missing";
+                    throw std::runtime_error("Invalid output index");
+                }
+
+                Search &search = searches.at(amount);
+
+                if (ringMember->second.blockIndex <= upperBlockIndex)
+                {
+                    search.lower = probe + 1;
+                    search.step *= 2;
+                }
+                else
+                {
+                    search.upper = probe;
+                    search.galloping = false;
+                }
+            }
+        }
+
+        std::unordered_map<Amount, uint32_t> unlockedCounts;
+
+        for (const auto &[amount, search] : searches)
+        {
+            unlockedCounts.emplace(amount, search.lower);
+        }
+
+        std::scoped_lock<std::mutex> lock(unlockedKeyOutputCountsMutex);
+
+        /* Blocks can still be added below an upper block index at or past the
+           top, which would make the count stale. The top is checked with the
+           lock held, as split clears the counts under it once the top has
+           moved, so a count made stale by a split is never kept. */
+        if (upperBlockIndex < getTopBlockIndex())
+        {
+            for (const auto &[amount, count] : unlockedCounts)
+            {
+                unlockedKeyOutputCounts[amount] = {upperBlockIndex, count};
+            }
+        }
+
+        return unlockedCounts;
+    }
+
     void DatabaseBlockchainCache::insertPaymentId(
         BlockchainWriteBatch &batch,
         const Crypto::Hash &transactionHash,
@@ -1128,6 +1498,23 @@ namespace CryptoNote
 
         batch.insertSpentKeyImages(getTopBlockIndex() + 1, validatorState.spentKeyImages);
 
+        /* Past its capacity the false positive rate climbs, and more checks
+           fall through to the database. Rebuilding it reads every spent key
+           image, so it's regrown to twice its capacity to keep rebuilds rare.
+           This block's key images aren't written yet, so they're inserted
+           after. */
+        if (spentKeyImageFilter.isOverfull())
+        {
+            buildSpentKeyImageFilter(spentKeyImageFilter.getCapacity() * 2);
+        }
+
+        /* Before the write, so no reader finds the key images in the database
+           but not in the filter */
+        for (const auto &keyImage : validatorState.spentKeyImages)
+        {
+            spentKeyImageFilter.insert(keyImage);
+        }
+
         auto txHashes = cachedBlock.getBlock().transactionHashes;
         auto baseTransaction = cachedBlock.getBlock().baseTransaction;
         auto cachedBaseTransaction = CachedTransaction {std::move(baseTransaction)};
@@ -1137,6 +1524,15 @@ namespace CryptoNote
 
         batch.insertCachedBlock(blockInfo, getTopBlockIndex() + 1, txHashes);
         batch.insertRawBlock(getTopBlockIndex() + 1, std::move(rawBlock));
+        batch.insertWalletSyncRecord(getTopBlockIndex() + 1, makeWalletBlockInfo(cachedBlock, cachedTransactions));
+
+        batch.insertBlockHeader(
+            getTopBlockIndex() + 1, Utils::makeCachedBlockHeader(cachedBlock, blockSize, blockDifficulty));
+
+        if (!cachedTransactions.empty())
+        {
+            batch.insertNonEmptyBlockIndex(getTopBlockIndex() + 1, static_cast<uint32_t>(cachedTransactions.size()));
+        }
 
         auto transactionIndex = 0;
         pushTransaction(cachedBaseTransaction, getTopBlockIndex() + 1, transactionIndex++, batch);
@@ -1174,11 +1570,22 @@ namespace CryptoNote
         topBlockHash = cachedBlock.getBlockHash();
         logger(Logging::DEBUGGING) << "push block " << cachedBlock.getBlockHash() << " completed";
 
+        blockHashTable.push(cachedBlock.getBlockHash());
+
         unitsCache.push_back(blockInfo);
         if (unitsCache.size() > unitsCacheSize)
         {
             unitsCache.pop_front();
         }
+
+        {
+            std::scoped_lock<std::mutex> lock(rewardWindowMutex);
+
+            rewardWindowBlockSizes.push(blockInfo.blockSize);
+            rewardWindowTopIndex = *topBlockIndex;
+        }
+
+        updateNextBlockDifficulty();
     }
 
     PushedBlockInfo DatabaseBlockchainCache::getPushedBlockInfo(uint32_t blockIndex) const
@@ -1188,6 +1595,15 @@ namespace CryptoNote
 
     bool DatabaseBlockchainCache::checkIfSpent(const Crypto::KeyImage &keyImage, uint32_t blockIndex) const
     {
+        {
+            std::shared_lock<std::shared_mutex> lock(spentKeyImageFilterMutex);
+
+            if (!spentKeyImageFilter.mightContain(keyImage))
+            {
+                return false;
+            }
+        }
+
         auto batch = BlockchainReadBatch().requestBlockIndexBySpentKeyImage(keyImage);
         auto res = database.readThreadSafe(batch);
 
@@ -1251,24 +1667,38 @@ namespace CryptoNote
         Common::ArrayView<uint32_t> globalIndexes,
         std::vector<Crypto::PublicKey> &publicKeys) const
     {
-        return extractKeyOutputs(
-            amount,
-            blockIndex,
-            globalIndexes,
-            [this, &publicKeys, blockIndex](
-                const CachedTransactionInfo &info, PackedOutIndex index, uint32_t globalIndex) {
-                if (!isTransactionSpendTimeUnlocked(info.unlockTime, blockIndex))
-                {
-                    logger(Logging::DEBUGGING) << "extractKeyOutputKeys: output " << globalIndex << " is locked";
-                    return ExtractOutputKeysResult::OUTPUT_LOCKED;
-                }
+        /* Ring members are read from their own compact records, which carry
+           everything checked here, in one batched read */
+        BlockchainReadBatch batch;
+        for (auto it = globalIndexes.begin(); it != globalIndexes.end(); ++it)
+        {
+            batch.requestKeyOutputRingMember(amount, *it);
+        }
 
-                auto &output = info.outputs[index.outputIndex];
-                assert(output.type() == typeid(KeyOutput));
-                publicKeys.push_back(boost::get<KeyOutput>(output).key);
+        const auto ringMembers = readDatabase(batch).getKeyOutputRingMembers();
 
-                return ExtractOutputKeysResult::SUCCESS;
-            });
+        publicKeys.reserve(publicKeys.size() + globalIndexes.getSize());
+
+        for (auto it = globalIndexes.begin(); it != globalIndexes.end(); ++it)
+        {
+            const auto ringMember = ringMembers.find({amount, *it});
+
+            if (ringMember == ringMembers.end() || ringMember->second.blockIndex > blockIndex)
+            {
+                logger(Logging::DEBUGGING) << "extractKeyOutputKeys: output " << *it << " doesn't exist";
+                return ExtractOutputKeysResult::INVALID_GLOBAL_INDEX;
+            }
+
+            if (!isTransactionSpendTimeUnlocked(ringMember->second.unlockTime, blockIndex))
+            {
+                logger(Logging::DEBUGGING) << "extractKeyOutputKeys: output " << *it << " is locked";
+                return ExtractOutputKeysResult::OUTPUT_LOCKED;
+            }
+
+            publicKeys.push_back(ringMember->second.publicKey);
+        }
+
+        return ExtractOutputKeysResult::SUCCESS;
     }
 
     ExtractOutputKeysResult DatabaseBlockchainCache::extractKeyOtputIndexes(
@@ -1383,21 +1813,19 @@ namespace CryptoNote
 
     bool DatabaseBlockchainCache::hasBlock(const Crypto::Hash &blockHash) const
     {
-        auto batch = BlockchainReadBatch().requestBlockIndexByBlockHash(blockHash);
-        auto result = database.read(batch);
-        return !result && batch.extractResult().getBlockIndexesByBlockHashes().count(blockHash);
+        return blockHashTable.find(blockHash).has_value();
     }
 
     uint32_t DatabaseBlockchainCache::getBlockIndex(const Crypto::Hash &blockHash) const
     {
-        if (blockHash == getTopBlockHash())
+        const auto blockIndex = blockHashTable.find(blockHash);
+
+        if (!blockIndex)
         {
-            return getTopBlockIndex();
+            throw std::out_of_range("Block not found");
         }
 
-        auto batch = BlockchainReadBatch().requestBlockIndexByBlockHash(blockHash);
-        auto result = readDatabase(batch);
-        return result.getBlockIndexesByBlockHashes().at(blockHash);
+        return *blockIndex;
     }
 
     bool DatabaseBlockchainCache::hasTransaction(const Crypto::Hash &transactionHash) const
@@ -1429,6 +1857,32 @@ namespace CryptoNote
         return getLastUnits(count, blockIndex, useGenesis, [](const CachedBlockInfo &cb) { return cb.blockSize; });
     }
 
+    uint64_t DatabaseBlockchainCache::getLastBlocksSizesMedian(size_t count) const
+    {
+        return getLastBlocksSizesMedian(count, getTopBlockIndex(), UseGenesis {true});
+    }
+
+    uint64_t DatabaseBlockchainCache::getLastBlocksSizesMedian(
+        size_t count,
+        uint32_t blockIndex,
+        UseGenesis useGenesis) const
+    {
+        if (count == currency.rewardBlocksWindow() && useGenesis)
+        {
+            std::scoped_lock<std::mutex> lock(rewardWindowMutex);
+
+            /* Compared under the lock, so a block pushed in between can't
+               give us the median of the window after blockIndex */
+            if (blockIndex == rewardWindowTopIndex)
+            {
+                return rewardWindowBlockSizes.median();
+            }
+        }
+
+        auto sizes = getLastBlocksSizes(count, blockIndex, useGenesis);
+        return Common::medianValue(sizes);
+    }
+
     std::vector<uint64_t> DatabaseBlockchainCache::getLastCumulativeDifficulties(
         size_t count,
         uint32_t blockIndex,
@@ -1451,6 +1905,31 @@ namespace CryptoNote
     uint64_t DatabaseBlockchainCache::getDifficultyForNextBlock(uint32_t blockIndex) const
     {
         assert(blockIndex <= getTopBlockIndex());
+
+        {
+            std::scoped_lock<std::mutex> lock(nextBlockDifficultyMutex);
+
+            if (nextBlockDifficulty && nextBlockDifficulty->first == blockIndex)
+            {
+                return nextBlockDifficulty->second;
+            }
+        }
+
+        return findDifficultyForNextBlock(blockIndex);
+    }
+
+    void DatabaseBlockchainCache::updateNextBlockDifficulty()
+    {
+        const uint32_t blockIndex = getTopBlockIndex();
+        const uint64_t difficulty = findDifficultyForNextBlock(blockIndex);
+
+        std::scoped_lock<std::mutex> lock(nextBlockDifficultyMutex);
+
+        nextBlockDifficulty = std::make_pair(blockIndex, difficulty);
+    }
+
+    uint64_t DatabaseBlockchainCache::findDifficultyForNextBlock(uint32_t blockIndex) const
+    {
         uint8_t nextBlockMajorVersion = getBlockMajorVersionForHeight(blockIndex + 1);
         auto timestamps = getLastTimestamps(
             currency.difficultyBlocksCountByBlockVersion(nextBlockMajorVersion, blockIndex),
@@ -1633,49 +2112,14 @@ namespace CryptoNote
 
     Crypto::Hash DatabaseBlockchainCache::getBlockHash(uint32_t blockIndex) const
     {
-        if (blockIndex == getTopBlockIndex())
-        {
-            return getTopBlockHash();
-        }
-
-        auto batch = BlockchainReadBatch().requestCachedBlock(blockIndex);
-        auto result = readDatabase(batch);
-        return result.getCachedBlocks().at(blockIndex).blockHash;
+        return blockHashTable.getBlockHash(blockIndex);
     }
 
     std::vector<Crypto::Hash> DatabaseBlockchainCache::getBlockHashes(uint32_t startIndex, size_t maxCount) const
     {
         assert(startIndex <= getTopBlockIndex());
-        assert(maxCount <= std::numeric_limits<uint32_t>::max());
 
-        uint32_t count = std::min(getTopBlockIndex() - startIndex + 1, static_cast<uint32_t>(maxCount));
-        if (count == 0)
-        {
-            return {};
-        }
-
-        BlockchainReadBatch request;
-        auto index = startIndex;
-        while (index != startIndex + count)
-        {
-            request.requestCachedBlock(index++);
-        }
-
-        auto result = readDatabase(request);
-        assert(result.getCachedBlocks().size() == count);
-
-        std::vector<Crypto::Hash> hashes;
-        hashes.reserve(count);
-
-        std::map<uint32_t, CachedBlockInfo> sortedResult(
-            result.getCachedBlocks().begin(), result.getCachedBlocks().end());
-
-        std::transform(
-            sortedResult.begin(),
-            sortedResult.end(),
-            std::back_inserter(hashes),
-            [](const std::pair<uint32_t, CachedBlockInfo> &cb) { return cb.second.blockHash; });
-        return hashes;
+        return blockHashTable.getBlockHashes(startIndex, maxCount);
     }
 
     IBlockchainCache *DatabaseBlockchainCache::getParent() const
@@ -1733,25 +2177,21 @@ namespace CryptoNote
     {
         auto midnight = roundToMidnight(timestamp);
 
-        while (midnight > 0)
+        auto batch = BlockchainReadBatch().requestClosestTimestampBlockIndexAtOrBefore(midnight);
+        auto error = database.read(batch);
+        if (error)
         {
-            auto dbRes = requestClosestBlockIndexByTimestamp(midnight, database);
-            if (!dbRes.second)
-            {
-                logger(Logging::DEBUGGING) << "getTimestampLowerBoundBlockIndex failed: failed to read database";
-                throw std::runtime_error("Couldn't get closest to timestamp block index");
-            }
-
-            if (!dbRes.first)
-            {
-                midnight -= 60 * 60 * 24;
-                continue;
-            }
+            logger(Logging::DEBUGGING) << "getTimestampLowerBoundBlockIndex failed: failed to read database";
+            throw std::runtime_error("Couldn't get closest to timestamp block index");
+        }
 
-            return *dbRes.first;
+        const auto result = batch.extractResult();
+        if (result.getClosestTimestampBlockIndex().empty())
+        {
+            return 0;
         }
 
-        return 0;
+        return result.getClosestTimestampBlockIndex().begin()->second;
     }
 
     bool DatabaseBlockchainCache::getTransactionGlobalIndexes(
@@ -1796,7 +2236,24 @@ namespace CryptoNote
         return children.size();
     }
 
-    void DatabaseBlockchainCache::save() {}
+    void DatabaseBlockchainCache::save()
+    {
+        const Crypto::Hash &topHash = getTopBlockHash();
+
+        std::string serialized(reinterpret_cast<const char *>(topHash.data), sizeof(topHash));
+        {
+            std::shared_lock<std::shared_mutex> lock(spentKeyImageFilterMutex);
+            serialized += spentKeyImageFilter.serialize();
+        }
+
+        KeyImageFilterWriteBatch writeBatch(std::move(serialized));
+        auto ec = database.write(writeBatch);
+        if (ec)
+        {
+            /* Not fatal, the filter is just rebuilt on the next start */
+            logger(Logging::ERROR) << "Failed to save spent key image filter: " << ec.message();
+        }
+    }
 
     void DatabaseBlockchainCache::load() {}
 
@@ -1895,72 +2352,92 @@ namespace CryptoNote
     std::vector<uint32_t>
         DatabaseBlockchainCache::getRandomOutsByAmount(uint64_t amount, size_t count, uint32_t blockIndex) const
     {
-        auto batch = BlockchainReadBatch().requestKeyOutputGlobalIndexesCountForAmount(amount);
-        auto result = readDatabase(batch);
-        auto outputsCount = result.getKeyOutputGlobalIndexesCountForAmounts();
-        auto outputsToPick = std::min(static_cast<uint32_t>(count), outputsCount[amount]);
+        return getRandomOutsByAmounts({amount}, count, blockIndex)[amount].globalIndexes;
+    }
 
-        std::vector<uint32_t> resultOuts;
-        resultOuts.reserve(outputsToPick);
+    std::unordered_map<uint64_t, RandomOutputs> DatabaseBlockchainCache::getRandomOutsByAmounts(
+        const std::vector<uint64_t> &amounts,
+        size_t count,
+        uint32_t blockIndex) const
+    {
+        uint32_t upperBlockIndex = 0;
+        if (blockIndex > currency.minedMoneyUnlockWindow())
+        {
+            upperBlockIndex = blockIndex - currency.minedMoneyUnlockWindow();
+        }
 
-        ShuffleGenerator<uint32_t> generator(outputsCount[amount]);
+        /* Only outputs below these counts are past the unlock window, so every
+           pick is one, and just those with a later unlock time get skipped */
+        const auto unlockedCounts = getUnlockedKeyOutputCounts(amounts, upperBlockIndex);
 
-        while (outputsToPick)
+        std::unordered_map<uint64_t, std::vector<std::pair<uint32_t, Crypto::PublicKey>>> picked;
+        std::unordered_map<uint64_t, ShuffleGenerator<uint32_t>> generators;
+
+        for (const auto &[amount, unlockedCount] : unlockedCounts)
         {
-            std::vector<uint32_t> globalIndexes;
-            globalIndexes.reserve(outputsToPick);
+            picked[amount].reserve(std::min<size_t>(count, unlockedCount));
+            generators.emplace(amount, unlockedCount);
+        }
 
-            try
+        while (true)
+        {
+            BlockchainReadBatch batch;
+            std::vector<std::pair<uint64_t, uint32_t>> picks;
+
+            for (auto &[amount, generator] : generators)
             {
-                for (uint32_t i = 0; i < outputsToPick; ++i, globalIndexes.push_back(generator()))
+                for (size_t i = picked[amount].size(); i < count && !generator.empty(); i++)
                 {
-                }
-                // std::generate_n(std::back_inserter(globalIndexes), outputsToPick, generator);
-            }
-            catch (const SequenceEnded &)
-            {
-                logger(Logging::TRACE) << "getRandomOutsByAmount: generator reached sequence end";
-                return resultOuts;
-            }
+                    const uint32_t globalIndex = generator();
 
-            std::vector<PackedOutIndex> outputs;
-            if (extractKeyOtputIndexes(
-                    amount, Common::ArrayView<uint32_t>(globalIndexes.data(), globalIndexes.size()), outputs)
-                != ExtractOutputKeysResult::SUCCESS)
-            {
-                logger(Logging::DEBUGGING) << "getRandomOutsByAmount: failed to extract key output indexes";
-                throw std::runtime_error("Invalid output index"); // TODO: make error code
+                    batch.requestKeyOutputRingMember(amount, globalIndex);
+                    picks.emplace_back(amount, globalIndex);
+                }
             }
 
-            std::vector<ExtendedTransactionInfo> transactions;
-            if (!requestExtendedTransactionInfos(outputs, database, transactions))
+            if (picks.empty())
             {
-                logger(Logging::TRACE) << "getRandomOutsByAmount: requestExtendedTransactionInfos failed";
-                throw std::runtime_error("Error while requesting transactions"); // TODO: make error code
+                break;
             }
 
-            assert(globalIndexes.size() == transactions.size());
+            const auto ringMembers = readDatabase(batch).getKeyOutputRingMembers();
 
-            uint32_t uppperBlockIndex = 0;
-            if (blockIndex > currency.minedMoneyUnlockWindow())
+            for (const auto &[amount, globalIndex] : picks)
             {
-                uppperBlockIndex = blockIndex - currency.minedMoneyUnlockWindow();
-            }
+                const auto ringMember = ringMembers.find({amount, globalIndex});
 
-            for (size_t i = 0; i < transactions.size(); ++i)
-            {
-                if (!isTransactionSpendTimeUnlocked(transactions[i].unlockTime, blockIndex)
-                    || transactions[i].blockIndex > uppperBlockIndex)
+                if (ringMember == ringMembers.end())
+                {
+                    logger(Logging::DEBUGGING) << "getRandomOutsByAmounts: failed to read output " << globalIndex
+                                               << " of amount " << amount;
+                    throw std::runtime_error("Invalid output index");
+                }
+
+                if (!isTransactionSpendTimeUnlocked(ringMember->second.unlockTime, blockIndex))
                 {
                     continue;
                 }
 
-                resultOuts.push_back(globalIndexes[i]);
-                --outputsToPick;
+                picked[amount].emplace_back(globalIndex, ringMember->second.publicKey);
             }
         }
 
-        return resultOuts;
+        std::unordered_map<uint64_t, RandomOutputs> result;
+
+        for (auto &[amount, outputs] : picked)
+        {
+            std::sort(outputs.begin(), outputs.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+            RandomOutputs &randomOutputs = result[amount];
+
+            for (const auto &[globalIndex, publicKey] : outputs)
+            {
+                randomOutputs.globalIndexes.push_back(globalIndex);
+                randomOutputs.publicKeys.push_back(publicKey);
+            }
+        }
+
+        return result;
     }
 
     ExtractOutputKeysResult DatabaseBlockchainCache::extractKeyOutputs(
@@ -2037,62 +2514,61 @@ namespace CryptoNote
         }
 
         BlockchainReadBatch batch;
-        for (uint64_t timestamp = timestampBegin; timestamp < timestampBegin + static_cast<uint64_t>(secondsCount);
-             ++timestamp)
-        {
-            batch.requestBlockHashesByTimestamp(timestamp);
-        }
+        batch.requestBlockHashesByTimestamps(timestampBegin, timestampBegin + static_cast<uint64_t>(secondsCount));
 
         auto result = readDatabase(batch);
-        for (uint64_t timestamp = timestampBegin; timestamp < timestampBegin + static_cast<uint64_t>(secondsCount);
-             ++timestamp)
-        {
-            if (result.getBlockHashesByTimestamp().count(timestamp) == 0)
-            {
-                continue;
-            }
 
-            const auto &hashes = result.getBlockHashesByTimestamp().at(timestamp);
-            blockHashes.insert(blockHashes.end(), hashes.begin(), hashes.end());
+        std::map<uint64_t, std::vector<Crypto::Hash>> sortedResult(
+            result.getBlockHashesByTimestamp().begin(), result.getBlockHashesByTimestamp().end());
+
+        for (const auto &kv : sortedResult)
+        {
+            blockHashes.insert(blockHashes.end(), kv.second.begin(), kv.second.end());
         }
 
         return blockHashes;
     }
 
-    std::vector<RawBlock>
-        DatabaseBlockchainCache::getNonEmptyBlocks(const uint64_t startHeight, const size_t blockCount) const
+    std::vector<uint32_t>
+        DatabaseBlockchainCache::getNonEmptyBlockIndexes(uint64_t startHeight, size_t blockCount) const
     {
-        std::vector<RawBlock> orderedBlocks;
+        auto batch = BlockchainReadBatch().requestNonEmptyBlockIndexes(startHeight, blockCount);
 
-        const uint32_t storageBlockCount = getBlockCount();
+        const auto transactionCounts = readDatabase(batch).getNonEmptyBlockTransactionCounts();
 
-        uint64_t height = startHeight;
+        std::vector<uint32_t> blockIndexes;
+        blockIndexes.reserve(transactionCounts.size());
 
-        while (orderedBlocks.size() < blockCount && height < storageBlockCount)
+        for (const auto &[blockIndex, transactionCount] : transactionCounts)
         {
-            uint64_t startHeight = height;
+            blockIndexes.push_back(blockIndex);
+        }
 
-            /* Lets try taking the amount we need *2, to try and balance not needing
-               multiple DB requests to get the amount we need of non empty blocks, with
-               not taking too many */
-            uint64_t endHeight = startHeight + (blockCount * 2);
+        std::sort(blockIndexes.begin(), blockIndexes.end());
 
-            auto blockBatch = BlockchainReadBatch().requestRawBlocks(startHeight, endHeight);
-            const auto rawBlocks = readDatabase(blockBatch).getRawBlocks();
+        return blockIndexes;
+    }
 
-            while (orderedBlocks.size() < blockCount && height < startHeight + rawBlocks.size())
-            {
-                const auto block = rawBlocks.at(height);
+    std::vector<RawBlock>
+        DatabaseBlockchainCache::getNonEmptyBlocks(const uint64_t startHeight, const size_t blockCount) const
+    {
+        const auto blockIndexes = getNonEmptyBlockIndexes(startHeight, blockCount);
 
-                height++;
+        BlockchainReadBatch batch;
 
-                if (block.transactions.empty())
-                {
-                    continue;
-                }
+        for (const auto blockIndex : blockIndexes)
+        {
+            batch.requestRawBlock(blockIndex);
+        }
 
-                orderedBlocks.push_back(block);
-            }
+        const auto rawBlocks = readDatabase(batch).getRawBlocks();
+
+        std::vector<RawBlock> orderedBlocks;
+        orderedBlocks.reserve(blockIndexes.size());
+
+        for (const auto blockIndex : blockIndexes)
+        {
+            orderedBlocks.push_back(rawBlocks.at(blockIndex));
         }
 
         return orderedBlocks;
@@ -2117,6 +2593,68 @@ namespace CryptoNote
         return orderedBlocks;
     }
 
+    std::vector<WalletTypes::WalletBlockInfo>
+        DatabaseBlockchainCache::getWalletSyncBlocks(const uint64_t startHeight, uint64_t endHeight) const
+    {
+        auto batch = BlockchainReadBatch().requestWalletSyncRecords(startHeight, endHeight);
+
+        const auto records = readDatabase(batch).getWalletSyncRecords();
+
+        std::vector<WalletTypes::WalletBlockInfo> orderedBlocks;
+        orderedBlocks.reserve(records.size());
+
+        for (uint64_t height = startHeight; height < startHeight + records.size(); height++)
+        {
+            orderedBlocks.push_back(records.at(height));
+        }
+
+        return orderedBlocks;
+    }
+
+    std::vector<WalletTypes::WalletBlockInfo>
+        DatabaseBlockchainCache::getNonEmptyWalletSyncBlocks(const uint64_t startHeight, const size_t blockCount) const
+    {
+        const auto blockIndexes = getNonEmptyBlockIndexes(startHeight, blockCount);
+
+        BlockchainReadBatch batch;
+
+        for (const auto blockIndex : blockIndexes)
+        {
+            batch.requestWalletSyncRecord(blockIndex);
+        }
+
+        const auto records = readDatabase(batch).getWalletSyncRecords();
+
+        std::vector<WalletTypes::WalletBlockInfo> orderedBlocks;
+        orderedBlocks.reserve(blockIndexes.size());
+
+        for (const auto blockIndex : blockIndexes)
+        {
+            orderedBlocks.push_back(records.at(blockIndex));
+        }
+
+        return orderedBlocks;
+    }
+
+    std::vector<CachedBlockHeader>
+        DatabaseBlockchainCache::getBlockHeaders(uint32_t beginIndex, uint32_t endIndex) const
+    {
+        endIndex = std::min(endIndex, getTopBlockIndex() + 1);
+
+        auto batch = BlockchainReadBatch().requestBlockHeaders(beginIndex, endIndex);
+
+        const auto headers = readDatabase(batch).getBlockHeaders();
+
+        std::vector<CachedBlockHeader> orderedHeaders;
+
+        for (uint32_t blockIndex = beginIndex; blockIndex < endIndex; blockIndex++)
+        {
+            orderedHeaders.push_back(headers.at(blockIndex));
+        }
+
+        return orderedHeaders;
+    }
+
     std::unordered_map<Crypto::Hash, std::vector<uint64_t>>
         DatabaseBlockchainCache::getGlobalIndexes(const std::vector<Crypto::Hash> transactionHashes) const
     {
@@ -2236,6 +2774,9 @@ namespace CryptoNote
 
         batch.insertCachedBlock(blockInfo, 0, {cachedBaseTransaction.getTransactionHash()});
         batch.insertRawBlock(0, {toBinaryArray(genesisBlock.getBlock()), {}});
+        batch.insertWalletSyncRecord(0, makeWalletBlockInfo(genesisBlock, {}));
+        batch.insertBlockHeader(
+            0, Utils::makeCachedBlockHeader(genesisBlock, baseTransactionSize, blockInfo.cumulativeDifficulty));
         batch.insertClosestTimestampBlockIndex(roundToMidnight(genesisBlock.getBlock().timestamp), 0);
 
         auto res = database.write(batch);
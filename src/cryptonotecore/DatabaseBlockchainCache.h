@@ -19,14 +19,19 @@
 
 #include "Currency.h"
 #include "IBlockchainCache.h"
+#include "common/RollingMedian.h"
 #include "common/StringView.h"
 #include "cryptonotecore/UpgradeManager.h"
 
 #include <IDataBase.h>
+#include <cryptonotecore/BlockHashTable.h>
 #include <cryptonotecore/BlockchainReadBatch.h>
 #include <cryptonotecore/BlockchainWriteBatch.h>
 #include <cryptonotecore/DatabaseCacheData.h>
 #include <cryptonotecore/IBlockchainCacheFactory.h>
+#include <cryptonotecore/KeyImageFilter.h>
+#include <mutex>
+#include <shared_mutex>
 
 namespace CryptoNote
 {
@@ -122,6 +127,10 @@ namespace CryptoNote
 
         std::vector<uint64_t> getLastBlocksSizes(size_t count, uint32_t blockIndex, UseGenesis) const override;
 
+        uint64_t getLastBlocksSizesMedian(size_t count) const override;
+
+        uint64_t getLastBlocksSizesMedian(size_t count, uint32_t blockIndex, UseGenesis) const override;
+
         std::vector<uint64_t>
             getLastCumulativeDifficulties(size_t count, uint32_t blockIndex, UseGenesis) const override;
 
@@ -214,6 +223,11 @@ namespace CryptoNote
         virtual std::vector<uint32_t>
             getRandomOutsByAmount(uint64_t amount, size_t count, uint32_t blockIndex) const override;
 
+        virtual std::unordered_map<uint64_t, RandomOutputs> getRandomOutsByAmounts(
+            const std::vector<uint64_t> &amounts,
+            size_t count,
+            uint32_t blockIndex) const override;
+
         virtual ExtractOutputKeysResult extractKeyOutputs(
             uint64_t amount,
             uint32_t blockIndex,
@@ -233,6 +247,14 @@ namespace CryptoNote
         virtual std::vector<RawBlock>
             getNonEmptyBlocks(const uint64_t startHeight, const size_t blockCount) const override;
 
+        virtual std::vector<WalletTypes::WalletBlockInfo>
+            getWalletSyncBlocks(const uint64_t startHeight, uint64_t endHeight) const override;
+
+        virtual std::vector<WalletTypes::WalletBlockInfo>
+            getNonEmptyWalletSyncBlocks(const uint64_t startHeight, const size_t blockCount) const override;
+
+        virtual std::vector<CachedBlockHeader> getBlockHeaders(uint32_t beginIndex, uint32_t endIndex) const override;
+
       private:
         const Currency &currency;
 
@@ -250,14 +272,58 @@ namespace CryptoNote
 
         mutable std::unordered_map<Amount, int32_t> keyOutputCountsForAmounts;
 
+        struct UnlockedKeyOutputCount
+        {
+            uint32_t upperBlockIndex;
+
+            uint32_t count;
+        };
+
+        /* How many outputs of each amount were in blocks up to upperBlockIndex,
+           when last asked, so the next lookup only has to search past them.
+           RPC threads look these up at the same time, so it is only accessed
+           with unlockedKeyOutputCountsMutex held. */
+        mutable std::unordered_map<Amount, UnlockedKeyOutputCount> unlockedKeyOutputCounts;
+
+        mutable std::mutex unlockedKeyOutputCountsMutex;
+
         std::vector<IBlockchainCache *> children;
 
         Logging::LoggerRef logger;
 
+        /* The last unitsCacheSize blocks, so the windows the difficulty and
+           reward are found from don't need database reads */
         std::deque<CachedBlockInfo> unitsCache;
 
         const size_t unitsCacheSize = 1000;
 
+        /* Sizes of the blocks in the reward window ending at rewardWindowTopIndex,
+           the top block. Both are guarded by rewardWindowMutex, as the RPC
+           threads find the median while pushBlock moves the window. */
+        Common::RollingMedian<uint64_t> rewardWindowBlockSizes;
+
+        uint32_t rewardWindowTopIndex = 0;
+
+        mutable std::mutex rewardWindowMutex;
+
+        /* The difficulty of the block after the top block, and the top block
+           index. Only set by the constructor, pushBlock and split, and guarded
+           by nextBlockDifficultyMutex as the RPC threads read it too. */
+        boost::optional<std::pair<uint32_t, uint64_t>> nextBlockDifficulty;
+
+        mutable std::mutex nextBlockDifficultyMutex;
+
+        /* Lets checkIfSpent skip the database for key images never spent. Key
+           images are inserted while other threads check it, but replacing it
+           when it's rebuilt needs spentKeyImageFilterMutex held exclusively. */
+        KeyImageFilter spentKeyImageFilter;
+
+        mutable std::shared_mutex spentKeyImageFilterMutex;
+
+        /* Every block hash in the chain, so hash to index lookups and back
+           don't need the database */
+        BlockHashTable blockHashTable;
+
         struct ExtendedPushedBlockInfo;
 
         ExtendedPushedBlockInfo getExtendedPushedBlockInfo(uint32_t blockIndex) const;
@@ -281,6 +347,12 @@ namespace CryptoNote
             PackedOutIndex output); // TODO not implemented. Should it be removed?
         uint32_t updateKeyOutputCount(Amount amount, int32_t diff) const;
 
+        /* The number of outputs of each amount in blocks up to upperBlockIndex.
+           Global indexes follow block order, so these are the outputs with
+           global indexes below the count. */
+        std::unordered_map<Amount, uint32_t>
+            getUnlockedKeyOutputCounts(const std::vector<Amount> &amounts, uint32_t upperBlockIndex) const;
+
         void insertPaymentId(
             BlockchainWriteBatch &batch,
             const Crypto::Hash &transactionHash,
@@ -290,6 +362,28 @@ namespace CryptoNote
 
         void addGenesisBlock(CachedBlock &&genesisBlock);
 
+        /* Refills unitsCache and the reward window from the database, for
+           when the top block changes other than by pushBlock */
+        void loadUnitsCache();
+
+        /* Loads the filter persisted by save, or builds it from the database
+           if it's missing, out of date, or too full */
+        void loadSpentKeyImageFilter();
+
+        void loadBlockHashTable();
+
+        /* Sets nextBlockDifficulty for the current top block */
+        void updateNextBlockDifficulty();
+
+        uint64_t findDifficultyForNextBlock(uint32_t blockIndex) const;
+
+        /* Ascending, from the non empty block index, so empty blocks are never read */
+        std::vector<uint32_t> getNonEmptyBlockIndexes(uint64_t startHeight, size_t blockCount) const;
+
+        /* Sized for twice the spent key images in the database, and at least
+           minCapacity */
+        void buildSpentKeyImageFilter(uint64_t minCapacity);
+
         enum class OutputSearchResult : uint8_t
         {
             FOUND,
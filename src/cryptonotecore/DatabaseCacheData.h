@@ -23,6 +23,17 @@ namespace CryptoNote
         void serialize(CryptoNote::ISerializer &s);
     };
 
+    /* Just what's needed to pick a key output as a ring member, and to check
+       it's unlocked and below the height asked for */
+    struct KeyOutputRingMember
+    {
+        Crypto::PublicKey publicKey;
+
+        uint64_t unlockTime;
+
+        uint32_t blockIndex;
+    };
+
     // inherit here to avoid breaking IBlockchainCache interface
     struct ExtendedTransactionInfo : CachedTransactionInfo
     {
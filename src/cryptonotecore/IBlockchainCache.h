@@ -11,6 +11,7 @@
 #include "cryptonotecore/TransactionValidatiorState.h"
 
 #include <CryptoNote.h>
+#include <WalletTypes.h>
 #include <unordered_map>
 #include <vector>
 
@@ -49,6 +50,46 @@ namespace CryptoNote
         uint64_t blockDifficulty;
     };
 
+    /* Randomly picked unlocked key outputs of one amount, sorted by global index,
+       with the public key of each output at the same position */
+    struct RandomOutputs
+    {
+        std::vector<uint32_t> globalIndexes;
+
+        std::vector<Crypto::PublicKey> publicKeys;
+    };
+
+    /* The header fields of a block, and the totals header RPCs report with
+       them, kept apart from the raw block so they can be read without loading
+       and parsing every transaction of the block */
+    struct CachedBlockHeader
+    {
+        uint8_t majorVersion;
+
+        uint8_t minorVersion;
+
+        uint64_t timestamp;
+
+        Crypto::Hash previousBlockHash;
+
+        uint32_t nonce;
+
+        Crypto::Hash blockHash;
+
+        uint32_t blockIndex;
+
+        /* The block blob and its transactions, as getBlockDetails reports it */
+        uint64_t blockSize;
+
+        uint64_t difficulty;
+
+        /* The sum of the coinbase transaction outputs */
+        uint64_t reward;
+
+        /* Including the coinbase transaction */
+        uint32_t transactionCount;
+    };
+
     class UseGenesis
     {
       public:
@@ -153,6 +194,11 @@ namespace CryptoNote
 
         virtual std::vector<uint64_t> getLastBlocksSizes(size_t count, uint32_t blockIndex, UseGenesis) const = 0;
 
+        /* The median of getLastBlocksSizes */
+        virtual uint64_t getLastBlocksSizesMedian(size_t count) const = 0;
+
+        virtual uint64_t getLastBlocksSizesMedian(size_t count, uint32_t blockIndex, UseGenesis) const = 0;
+
         virtual std::vector<uint64_t>
             getLastCumulativeDifficulties(size_t count, uint32_t blockIndex, UseGenesis) const = 0;
 
@@ -233,6 +279,10 @@ namespace CryptoNote
         virtual std::vector<uint32_t>
             getRandomOutsByAmount(uint64_t amount, size_t count, uint32_t blockIndex) const = 0;
 
+        /* Up to count outputs of each amount, unlocked at blockIndex */
+        virtual std::unordered_map<uint64_t, RandomOutputs>
+            getRandomOutsByAmounts(const std::vector<uint64_t> &amounts, size_t count, uint32_t blockIndex) const = 0;
+
         virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash &paymentId) const = 0;
 
         virtual std::vector<Crypto::Hash>
@@ -241,6 +291,20 @@ namespace CryptoNote
         virtual std::vector<RawBlock> getBlocksByHeight(const uint64_t startHeight, uint64_t endHeight) const = 0;
 
         virtual std::vector<RawBlock> getNonEmptyBlocks(const uint64_t startHeight, const size_t blockCount) const = 0;
+
+        /* What wallets need of each block in [startHeight, endHeight), coinbase
+           transaction included */
+        virtual std::vector<WalletTypes::WalletBlockInfo>
+            getWalletSyncBlocks(const uint64_t startHeight, uint64_t endHeight) const = 0;
+
+        /* As getWalletSyncBlocks, but for the first blockCount blocks from
+           startHeight with transactions other than the coinbase */
+        virtual std::vector<WalletTypes::WalletBlockInfo>
+            getNonEmptyWalletSyncBlocks(const uint64_t startHeight, const size_t blockCount) const = 0;
+
+        /* The headers of the blocks in [beginIndex, endIndex), fewer if the
+           chain ends first */
+        virtual std::vector<CachedBlockHeader> getBlockHeaders(uint32_t beginIndex, uint32_t endIndex) const = 0;
     };
 
 } // namespace CryptoNote
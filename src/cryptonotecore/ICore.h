@@ -12,6 +12,7 @@
 #include "CachedBlock.h"
 #include "CachedTransaction.h"
 #include "CoreStatistics.h"
+#include "IBlockchainCache.h"
 #include "ICoreDefinitions.h"
 #include "ICoreObserver.h"
 #include "MessageQueue.h"
@@ -53,6 +54,11 @@ namespace CryptoNote
 
         virtual BlockTemplate getBlockByHash(const Crypto::Hash &blockHash) const = 0;
 
+        /* Main chain headers for [beginIndex, endIndex), without loading the full blocks */
+        virtual std::vector<CachedBlockHeader> getBlockHeaders(uint32_t beginIndex, uint32_t endIndex) const = 0;
+
+        virtual CachedBlockHeader getBlockHeaderByHash(const Crypto::Hash &blockHash) const = 0;
+
         virtual std::vector<Crypto::Hash> buildSparseChain() const = 0;
 
         virtual std::vector<Crypto::Hash> findBlockchainSupplement(
@@ -139,6 +145,13 @@ namespace CryptoNote
 
         virtual std::error_code addBlock(RawBlock &&rawBlock) = 0;
 
+        /*!
+         * \brief precomputeBlockLongHashes Computes the proof of work hashes of a batch of blocks in parallel, so
+         *        that adding them afterwards only has to compare the hash against the difficulty
+         * \param cachedBlocks The blocks to hash. The hashes are cached in the blocks themselves.
+         */
+        virtual void precomputeBlockLongHashes(const std::vector<CachedBlock> &cachedBlocks) = 0;
+
         virtual std::error_code submitBlock(const BinaryArray &rawBlockTemplate) = 0;
 
         virtual bool getTransactionGlobalIndexes(
@@ -151,6 +164,13 @@ namespace CryptoNote
             std::vector<uint32_t> &globalIndexes,
             std::vector<Crypto::PublicKey> &publicKeys) const = 0;
 
+        /* Picks the outputs of every amount together, so the database is read
+           a few times in total rather than a few times per amount */
+        virtual std::tuple<bool, std::string> getRandomOutputs(
+            const std::vector<uint64_t> &amounts,
+            uint16_t count,
+            std::unordered_map<uint64_t, RandomOutputs> &outputs) const = 0;
+
         virtual bool getGlobalIndexesForRange(
             const uint64_t startHeight,
             const uint64_t endHeight,
@@ -0,0 +1,158 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "KeyImageFilter.h"
+
+namespace CryptoNote
+{
+    namespace
+    {
+        /* One 64 byte cache line */
+        const uint64_t WORDS_PER_BLOCK = 8;
+
+        const uint64_t BITS_PER_KEY_IMAGE = 16;
+
+        const uint64_t KEY_IMAGES_PER_BLOCK = WORDS_PER_BLOCK * 64 / BITS_PER_KEY_IMAGE;
+
+        /* Capacity, inserted count, then the words */
+        const size_t HEADER_SIZE = 2 * sizeof(uint64_t);
+
+        uint64_t readUint64(const uint8_t *data)
+        {
+            uint64_t value = 0;
+
+            for (size_t i = 0; i < sizeof(uint64_t); i++)
+            {
+                value |= static_cast<uint64_t>(data[i]) << (8 * i);
+            }
+
+            return value;
+        }
+
+        void appendUint64(std::string &serialized, uint64_t value)
+        {
+            for (size_t i = 0; i < sizeof(uint64_t); i++)
+            {
+                serialized.push_back(static_cast<char>(value >> (8 * i)));
+            }
+        }
+
+        uint64_t getBlockCount(uint64_t capacity)
+        {
+            return (capacity + KEY_IMAGES_PER_BLOCK - 1) / KEY_IMAGES_PER_BLOCK;
+        }
+    } // namespace
+
+    KeyImageFilter::KeyImageFilter(): capacity(0), insertedCount(0) {}
+
+    KeyImageFilter::KeyImageFilter(uint64_t capacity):
+        capacity(capacity),
+        insertedCount(0),
+        words(getBlockCount(capacity) * WORDS_PER_BLOCK)
+    {
+    }
+
+    /* Key images are curve points, so their bytes are already evenly spread.
+       The first eight bytes pick the block, and six bits of the next eight
+       pick the bit set in each word of it. */
+    void KeyImageFilter::insert(const Crypto::KeyImage &keyImage)
+    {
+        if (words.empty())
+        {
+            return;
+        }
+
+        const uint64_t blockIndex = readUint64(keyImage.data) % (words.size() / WORDS_PER_BLOCK);
+        const uint64_t bits = readUint64(keyImage.data + 8);
+
+        for (uint64_t i = 0; i < WORDS_PER_BLOCK; i++)
+        {
+            words[blockIndex * WORDS_PER_BLOCK + i].fetch_or(
+                uint64_t(1) << ((bits >> (i * 6)) & 63), std::memory_order_relaxed);
+        }
+
+        insertedCount++;
+    }
+
+    bool KeyImageFilter::mightContain(const Crypto::KeyImage &keyImage) const
+    {
+        if (words.empty())
+        {
+            return true;
+        }
+
+        const uint64_t blockIndex = readUint64(keyImage.data) % (words.size() / WORDS_PER_BLOCK);
+        const uint64_t bits = readUint64(keyImage.data + 8);
+
+        for (uint64_t i = 0; i < WORDS_PER_BLOCK; i++)
+        {
+            const uint64_t mask = uint64_t(1) << ((bits >> (i * 6)) & 63);
+
+            if ((words[blockIndex * WORDS_PER_BLOCK + i].load(std::memory_order_relaxed) & mask) == 0)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool KeyImageFilter::isOverfull() const
+    {
+        return insertedCount > capacity;
+    }
+
+    uint64_t KeyImageFilter::getCapacity() const
+    {
+        return capacity;
+    }
+
+    std::string KeyImageFilter::serialize() const
+    {
+        std::string serialized;
+        serialized.reserve(HEADER_SIZE + words.size() * sizeof(uint64_t));
+
+        appendUint64(serialized, capacity);
+        appendUint64(serialized, insertedCount);
+
+        for (const auto &word : words)
+        {
+            appendUint64(serialized, word.load(std::memory_order_relaxed));
+        }
+
+        return serialized;
+    }
+
+    bool KeyImageFilter::deserialize(std::string_view serialized)
+    {
+        if (serialized.size() < HEADER_SIZE)
+        {
+            return false;
+        }
+
+        const auto *data = reinterpret_cast<const uint8_t *>(serialized.data());
+
+        const uint64_t serializedCapacity = readUint64(data);
+        const uint64_t wordCount = getBlockCount(serializedCapacity) * WORDS_PER_BLOCK;
+
+        if ((serialized.size() - HEADER_SIZE) / sizeof(uint64_t) != wordCount
+            || (serialized.size() - HEADER_SIZE) % sizeof(uint64_t) != 0)
+        {
+            return false;
+        }
+
+        std::vector<std::atomic<uint64_t>> serializedWords(wordCount);
+
+        for (uint64_t i = 0; i < wordCount; i++)
+        {
+            serializedWords[i].store(readUint64(data + HEADER_SIZE + i * sizeof(uint64_t)), std::memory_order_relaxed);
+        }
+
+        capacity = serializedCapacity;
+        insertedCount = readUint64(data + sizeof(uint64_t));
+        words = std::move(serializedWords);
+
+        return true;
+    }
+} // namespace CryptoNote
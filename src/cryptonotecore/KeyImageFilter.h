@@ -0,0 +1,55 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <CryptoNote.h>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CryptoNote
+{
+    /* A blocked bloom filter over spent key images, so that checking a key
+       image that was never spent, which is nearly every check, needs no
+       database read. Each key image sets one bit in each word of a single 64
+       byte block, so a check touches one cache line.
+
+       Key images can be inserted while other threads check them. They can't
+       be removed, so those of popped blocks stay as false positives until the
+       filter is rebuilt. */
+    class KeyImageFilter
+    {
+      public:
+        /* An empty filter, which reports every key image as maybe spent */
+        KeyImageFilter();
+
+        /* Sized for capacity key images at around a 0.1% false positive rate */
+        explicit KeyImageFilter(uint64_t capacity);
+
+        void insert(const Crypto::KeyImage &keyImage);
+
+        /* False if the key image was never inserted, true if it probably was */
+        bool mightContain(const Crypto::KeyImage &keyImage) const;
+
+        /* More key images have been inserted than the filter was sized for,
+           so false positives are climbing */
+        bool isOverfull() const;
+
+        uint64_t getCapacity() const;
+
+        std::string serialize() const;
+
+        /* Returns false if serialized isn't a valid filter */
+        bool deserialize(std::string_view serialized);
+
+      private:
+        uint64_t capacity;
+
+        uint64_t insertedCount;
+
+        std::vector<std::atomic<uint64_t>> words;
+    };
+} // namespace CryptoNote
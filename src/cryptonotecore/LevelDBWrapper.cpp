@@ -232,7 +232,79 @@ std::error_code LevelDBWrapper::read(IReadBatch &batch)
 
     values.reserve(rawKeys.size());
 
-    batch.submitRawResult(values, resultStates);
+    std::vector<std::vector<std::pair<std::string, std::string>>> rangeValues;
+    error = readRanges(batch.getRawKeyRanges(), rangeValues);
+    if (error)
+    {
+        return error;
+    }
+
+    batch.submitRawResult(std::vector<std::string_view>(values.begin(), values.end()), resultStates);
+    batch.submitRawRangeResult(rangeValues);
+    return std::error_code();
+}
+
+std::error_code LevelDBWrapper::readRanges(
+    const std::vector<RawKeyRange> &ranges,
+    std::vector<std::vector<std::pair<std::string, std::string>>> &keyValues)
+{
+    keyValues.resize(ranges.size());
+
+    for (size_t i = 0; i < ranges.size(); i++)
+    {
+        const RawKeyRange &range = ranges[i];
+        const leveldb::Slice begin(range.begin);
+        const leveldb::Slice end(range.end);
+
+        std::unique_ptr<leveldb::Iterator> iterator(db->NewIterator(leveldb::ReadOptions()));
+
+        if (range.reverse)
+        {
+            /* LevelDB has no SeekForPrev, so step back from the first key at or after end */
+            iterator->Seek(end);
+
+            if (iterator->Valid())
+            {
+                iterator->Prev();
+            }
+            else
+            {
+                iterator->SeekToLast();
+            }
+        }
+        else
+        {
+            iterator->Seek(begin);
+        }
+
+        while (iterator->Valid() && (range.limit == 0 || keyValues[i].size() < range.limit))
+        {
+            const leveldb::Slice key = iterator->key();
+
+            if (range.reverse ? key.compare(begin) < 0 : key.compare(end) >= 0)
+            {
+                break;
+            }
+
+            keyValues[i].emplace_back(key.ToString(), iterator->value().ToString());
+
+            if (range.reverse)
+            {
+                iterator->Prev();
+            }
+            else
+            {
+                iterator->Next();
+            }
+        }
+
+        if (!iterator->status().ok())
+        {
+            logger(ERROR) << "Can't read range from DB. " << iterator->status().ToString();
+            return make_error_code(CryptoNote::error::DataBaseErrorCodes::INTERNAL_ERROR);
+        }
+    }
+
     return std::error_code();
 }
 
@@ -45,6 +45,10 @@ namespace CryptoNote
       private:
         std::error_code write(IWriteBatch &batch, bool sync);
 
+        std::error_code readRanges(
+            const std::vector<RawKeyRange> &ranges,
+            std::vector<std::vector<std::pair<std::string, std::string>>> &keyValues);
+
         std::string getDataDir(const DataBaseConfig &config);
 
         enum State
@@ -5,9 +5,12 @@
 
 #include "RocksDBWrapper.h"
 
+#include "DBUtils.h"
 #include "DataBaseErrors.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/db.h"
+#include "rocksdb/filter_policy.h"
+#include "rocksdb/statistics.h"
 #include "rocksdb/table.h"
 #include "rocksdb/utilities/backupable_db.h"
 
@@ -17,7 +20,141 @@ using namespace Logging;
 namespace
 {
     const std::string DB_NAME = "DB";
-}
+
+    /* Raw blocks are written once and rarely read, so are worth compressing harder */
+    const int RAW_BLOCK_COMPRESSION_LEVEL = 9;
+
+    /* Raw blocks smaller than this, mostly empty blocks, stay inline as the
+       blob reference would save little */
+    const uint64_t RAW_BLOCK_MIN_BLOB_SIZE = 512;
+
+    const uint64_t BYTES_PER_MB = 1024 * 1024;
+
+    enum ColumnFamilyType
+    {
+        /* Read by block index or output index, which nearly always exist */
+        INDEX_LOOKUP,
+
+        /* Read by block, transaction or payment ID hash, which often don't exist */
+        HASH_LOOKUP,
+
+        /* Spent key images, checked for every input of every transaction and
+           almost never found */
+        KEY_IMAGE,
+
+        RAW_BLOCK
+    };
+
+    struct ColumnFamily
+    {
+        std::string keyPrefix;
+
+        std::string name;
+
+        ColumnFamilyType type;
+    };
+
+    /* Keys with any other prefix, like the scheme version, stay in the default family */
+    const std::vector<ColumnFamily> COLUMN_FAMILIES = {
+        {DB::BLOCK_INDEX_TO_KEY_IMAGE_PREFIX, "block_index_to_key_images", INDEX_LOOKUP},
+        {DB::BLOCK_INDEX_TO_TX_HASHES_PREFIX, "block_index_to_tx_hashes", INDEX_LOOKUP},
+        {DB::BLOCK_INDEX_TO_RAW_BLOCK_PREFIX, "block_index_to_raw_block", RAW_BLOCK},
+        {DB::BLOCK_HASH_TO_BLOCK_INDEX_PREFIX, "block_hash_to_block_index", HASH_LOOKUP},
+        {DB::BLOCK_INDEX_TO_BLOCK_INFO_PREFIX, "block_index_to_block_info", INDEX_LOOKUP},
+        {DB::KEY_IMAGE_TO_BLOCK_INDEX_PREFIX, "key_image_to_block_index", KEY_IMAGE},
+        {DB::BLOCK_INDEX_TO_BLOCK_HASH_PREFIX, "block_index_to_block_hash", INDEX_LOOKUP},
+        {DB::TRANSACTION_HASH_TO_TRANSACTION_INFO_PREFIX, "tx_hash_to_tx_info", HASH_LOOKUP},
+        {DB::KEY_OUTPUT_AMOUNT_PREFIX, "key_output_amount", INDEX_LOOKUP},
+        {DB::CLOSEST_TIMESTAMP_BLOCK_INDEX_PREFIX, "closest_timestamp_block_index", INDEX_LOOKUP},
+        {DB::PAYMENT_ID_TO_TX_HASH_PREFIX, "payment_id_to_tx_hash", HASH_LOOKUP},
+        {DB::TIMESTAMP_TO_BLOCKHASHES_PREFIX, "timestamp_to_block_hashes", INDEX_LOOKUP},
+        {DB::KEY_OUTPUT_AMOUNTS_COUNT_PREFIX, "key_output_amounts_count", INDEX_LOOKUP},
+        {DB::KEY_OUTPUT_KEY_PREFIX, "key_output_key", INDEX_LOOKUP},
+        {DB::KEY_OUTPUT_RING_MEMBER_PREFIX, "key_output_ring_member", INDEX_LOOKUP},
+        {DB::BLOCK_INDEX_TO_WALLET_SYNC_RECORD_PREFIX, "block_index_to_wallet_sync_record", INDEX_LOOKUP},
+        {DB::NON_EMPTY_BLOCK_INDEX_PREFIX, "non_empty_block_index", INDEX_LOOKUP},
+        {DB::BLOCK_INDEX_TO_BLOCK_HEADER_PREFIX, "block_index_to_block_header", INDEX_LOOKUP},
+    };
+
+    rocksdb::ColumnFamilyOptions getColumnFamilyOptions(
+        const DataBaseConfig &config,
+        const ColumnFamilyType type,
+        const std::shared_ptr<rocksdb::Cache> &blockCache)
+    {
+        rocksdb::ColumnFamilyOptions fOptions;
+        fOptions.write_buffer_size = static_cast<size_t>(config.writeBufferSize);
+        // merge two memtables when flushing to L0
+        fOptions.min_write_buffer_number_to_merge = 2;
+        // this means we'll use 50% extra memory in the worst case, but will reduce
+        // write stalls.
+        fOptions.max_write_buffer_number = 6;
+        // start flushing L0->L1 as soon as possible. each file on level0 is
+        // (memtable_memory_budget / 2). This will flush level 0 when it's bigger than
+        // memtable_memory_budget.
+        fOptions.level0_file_num_compaction_trigger = 20;
+
+        fOptions.level0_slowdown_writes_trigger = 30;
+        fOptions.level0_stop_writes_trigger = 40;
+
+        // doesn't really matter much, but we don't want to create too many files
+        fOptions.target_file_size_base = config.writeBufferSize / 10;
+        // make Level1 size equal to Level0 size, so that L0->L1 compactions are fast
+        fOptions.max_bytes_for_level_base = config.writeBufferSize;
+        fOptions.num_levels = 10;
+        fOptions.target_file_size_multiplier = 2;
+        // level style compaction
+        fOptions.compaction_style = rocksdb::kCompactionStyleLevel;
+
+        fOptions.compression_per_level.resize(fOptions.num_levels);
+
+        const auto compressionLevel = config.compressionEnabled
+            ? rocksdb::kZSTD
+            : rocksdb::kNoCompression;
+
+        for (int i = 0; i < fOptions.num_levels; ++i)
+        {
+            // don't compress l0 & l1, apart from raw blocks which are rarely read back
+            fOptions.compression_per_level[i] =
+                (i < 2 && type != RAW_BLOCK ? rocksdb::kNoCompression : compressionLevel);
+        }
+
+        // bottom most use kZSTD
+        fOptions.bottommost_compression = compressionLevel;
+
+        rocksdb::BlockBasedTableOptions tableOptions;
+        tableOptions.block_cache = blockCache;
+
+        if (type == RAW_BLOCK)
+        {
+            fOptions.compression_opts.level = RAW_BLOCK_COMPRESSION_LEVEL;
+            fOptions.bottommost_compression_opts.level = RAW_BLOCK_COMPRESSION_LEVEL;
+            fOptions.bottommost_compression_opts.enabled = true;
+
+            // bigger blocks compress better, and raw blocks are mostly read in ranges
+            tableOptions.block_size = static_cast<size_t>(config.rawBlockBlockSize);
+
+            // off by default, as raw blocks are written in key order, so
+            // compaction mostly moves their table files without rewriting them
+            fOptions.enable_blob_files = config.blobFilesEnabled;
+            fOptions.min_blob_size = RAW_BLOCK_MIN_BLOB_SIZE;
+            fOptions.blob_compression_type = compressionLevel;
+            // raw blocks are only deleted when rewinding, so little is ever reclaimed
+            fOptions.enable_blob_garbage_collection = true;
+        }
+
+        // lets a lookup of a missing key skip reading the table's blocks
+        if ((type == HASH_LOOKUP || type == KEY_IMAGE) && config.bloomBitsPerKey > 0)
+        {
+            tableOptions.filter_policy.reset(
+                rocksdb::NewBloomFilterPolicy(static_cast<double>(config.bloomBitsPerKey), false));
+        }
+
+        std::shared_ptr<rocksdb::TableFactory> tfp(NewBlockBasedTableFactory(tableOptions));
+        fOptions.table_factory = tfp;
+
+        return fOptions;
+    }
+} // namespace
 
 RocksDBWrapper::RocksDBWrapper(std::shared_ptr<Logging::ILogger> logger):
     logger(logger, "RocksDBWrapper"),
@@ -25,7 +162,13 @@ RocksDBWrapper::RocksDBWrapper(std::shared_ptr<Logging::ILogger> logger):
 {
 }
 
-RocksDBWrapper::~RocksDBWrapper() {}
+RocksDBWrapper::~RocksDBWrapper()
+{
+    if (db)
+    {
+        closeColumnFamilies();
+    }
+}
 
 void RocksDBWrapper::init(const DataBaseConfig &config)
 {
@@ -41,7 +184,8 @@ void RocksDBWrapper::init(const DataBaseConfig &config)
     rocksdb::DB *dbPtr;
 
     rocksdb::Options dbOptions = getDBOptions(config);
-    rocksdb::Status status = rocksdb::DB::Open(dbOptions, dataDir, &dbPtr);
+    const std::vector<rocksdb::ColumnFamilyDescriptor> descriptors = getColumnFamilyDescriptors(config);
+    rocksdb::Status status = rocksdb::DB::Open(dbOptions, dataDir, descriptors, &columnFamilies, &dbPtr);
     if (status.ok())
     {
         logger(INFO) << "DB opened in " << dataDir;
@@ -50,7 +194,7 @@ void RocksDBWrapper::init(const DataBaseConfig &config)
     {
         logger(INFO) << "DB not found in " << dataDir << ". Creating new DB...";
         dbOptions.create_if_missing = true;
-        rocksdb::Status status = rocksdb::DB::Open(dbOptions, dataDir, &dbPtr);
+        rocksdb::Status status = rocksdb::DB::Open(dbOptions, dataDir, descriptors, &columnFamilies, &dbPtr);
         if (!status.ok())
         {
             logger(ERROR) << "DB Error. DB can't be created in " << dataDir << ". Error: " << status.ToString();
@@ -69,6 +213,16 @@ void RocksDBWrapper::init(const DataBaseConfig &config)
     }
 
     db.reset(dbPtr);
+    statistics = dbOptions.statistics;
+
+    /* The default family is always first */
+    columnFamilyByPrefix.fill(columnFamilies[0]);
+
+    for (size_t i = 0; i < COLUMN_FAMILIES.size(); i++)
+    {
+        columnFamilyByPrefix[static_cast<uint8_t>(COLUMN_FAMILIES[i].keyPrefix[0])] = columnFamilies[i + 1];
+    }
+
     state.store(INITIALIZED);
 }
 
@@ -80,8 +234,10 @@ void RocksDBWrapper::shutdown()
     }
 
     logger(INFO) << "Closing DB.";
-    db->Flush(rocksdb::FlushOptions());
+    db->Flush(rocksdb::FlushOptions(), columnFamilies);
     db->SyncWAL();
+    logWriteVolume();
+    closeColumnFamilies();
     db.reset();
     state.store(NOT_INITIALIZED);
 }
@@ -98,7 +254,7 @@ void RocksDBWrapper::destroy(const DataBaseConfig &config)
     logger(WARNING) << "Destroying DB in " << dataDir;
 
     rocksdb::Options dbOptions = getDBOptions(config);
-    rocksdb::Status status = rocksdb::DestroyDB(dataDir, dbOptions);
+    rocksdb::Status status = rocksdb::DestroyDB(dataDir, dbOptions, getColumnFamilyDescriptors(config));
 
     if (status.ok())
     {
@@ -130,13 +286,15 @@ std::error_code RocksDBWrapper::write(IWriteBatch &batch, bool sync)
     std::vector<std::pair<std::string, std::string>> rawData(batch.extractRawDataToInsert());
     for (const std::pair<std::string, std::string> &kvPair : rawData)
     {
-        rocksdbBatch.Put(rocksdb::Slice(kvPair.first), rocksdb::Slice(kvPair.second));
+        const rocksdb::Slice key(kvPair.first);
+        rocksdbBatch.Put(getColumnFamily(key), key, rocksdb::Slice(kvPair.second));
     }
 
     std::vector<std::string> rawKeys(batch.extractRawKeysToRemove());
     for (const std::string &key : rawKeys)
     {
-        rocksdbBatch.Delete(rocksdb::Slice(key));
+        const rocksdb::Slice keySlice(key);
+        rocksdbBatch.Delete(getColumnFamily(keySlice), keySlice);
     }
 
     rocksdb::Status status = db->Write(writeOptions, &rocksdbBatch);
@@ -163,28 +321,45 @@ std::error_code RocksDBWrapper::read(IReadBatch &batch)
 
     std::vector<std::string> rawKeys(batch.getRawKeys());
     std::vector<rocksdb::Slice> keySlices;
+    std::vector<rocksdb::ColumnFamilyHandle *> keyFamilies;
     keySlices.reserve(rawKeys.size());
+    keyFamilies.reserve(rawKeys.size());
     for (const std::string &key : rawKeys)
     {
         keySlices.emplace_back(rocksdb::Slice(key));
+        keyFamilies.push_back(getColumnFamily(keySlices.back()));
     }
 
-    std::vector<std::string> values;
-    values.reserve(rawKeys.size());
-    std::vector<rocksdb::Status> statuses = db->MultiGet(readOptions, keySlices, &values);
+    /* Pinned values point straight into the block cache, so they are decoded
+       without being copied out first */
+    std::vector<rocksdb::PinnableSlice> values(rawKeys.size());
+    std::vector<rocksdb::Status> statuses(rawKeys.size());
+    db->MultiGet(
+        readOptions, keySlices.size(), keyFamilies.data(), keySlices.data(), values.data(), statuses.data());
 
     std::error_code error;
+    std::vector<std::string_view> valueViews;
     std::vector<bool> resultStates;
-    for (const rocksdb::Status &status : statuses)
+    valueViews.reserve(rawKeys.size());
+    for (size_t i = 0; i < statuses.size(); i++)
     {
-        if (!status.ok() && !status.IsNotFound())
+        if (!statuses[i].ok() && !statuses[i].IsNotFound())
         {
             return make_error_code(CryptoNote::error::DataBaseErrorCodes::INTERNAL_ERROR);
         }
-        resultStates.push_back(status.ok());
+        valueViews.emplace_back(values[i].data(), values[i].size());
+        resultStates.push_back(statuses[i].ok());
+    }
+
+    std::vector<std::vector<std::pair<std::string, std::string>>> rangeValues;
+    error = readRanges(batch.getRawKeyRanges(), rangeValues);
+    if (error)
+    {
+        return error;
     }
 
-    batch.submitRawResult(values, resultStates);
+    batch.submitRawResult(valueViews, resultStates);
+    batch.submitRawRangeResult(rangeValues);
     return std::error_code();
 }
 
@@ -199,7 +374,9 @@ std::error_code RocksDBWrapper::readThreadSafe(IReadBatch &batch)
 
     std::vector<std::string> rawKeys(batch.getRawKeys());
 
-    std::vector<std::string> values(rawKeys.size());
+    std::vector<rocksdb::PinnableSlice> values(rawKeys.size());
+
+    std::vector<std::string_view> valueViews;
 
     std::vector<bool> resultStates;
 
@@ -207,7 +384,10 @@ std::error_code RocksDBWrapper::readThreadSafe(IReadBatch &batch)
 
     for (const std::string &key : rawKeys)
     {
-        const rocksdb::Status status = db->Get(readOptions, rocksdb::Slice(key), &values[i]);
+        const rocksdb::Slice keySlice(key);
+        const rocksdb::Status status = db->Get(readOptions, getColumnFamily(keySlice), keySlice, &values[i]);
+
+        valueViews.emplace_back(values[i].data(), values[i].size());
 
         if (status.ok())
         {
@@ -226,7 +406,77 @@ std::error_code RocksDBWrapper::readThreadSafe(IReadBatch &batch)
         i++;
     }
 
-    batch.submitRawResult(values, resultStates);
+    std::vector<std::vector<std::pair<std::string, std::string>>> rangeValues;
+    const std::error_code error = readRanges(batch.getRawKeyRanges(), rangeValues);
+    if (error)
+    {
+        return error;
+    }
+
+    batch.submitRawResult(valueViews, resultStates);
+    batch.submitRawRangeResult(rangeValues);
+    return std::error_code();
+}
+
+std::error_code RocksDBWrapper::readRanges(
+    const std::vector<RawKeyRange> &ranges,
+    std::vector<std::vector<std::pair<std::string, std::string>>> &keyValues)
+{
+    keyValues.resize(ranges.size());
+
+    for (size_t i = 0; i < ranges.size(); i++)
+    {
+        const RawKeyRange &range = ranges[i];
+        const rocksdb::Slice begin(range.begin);
+        const rocksdb::Slice end(range.end);
+
+        /* A range never spans more than one key prefix, so is all in one family */
+        rocksdb::ReadOptions readOptions;
+        std::unique_ptr<rocksdb::Iterator> iterator(db->NewIterator(readOptions, getColumnFamily(begin)));
+
+        if (range.reverse)
+        {
+            iterator->SeekForPrev(end);
+
+            /* SeekForPrev lands on end itself if it exists, which is outside the range */
+            if (iterator->Valid() && iterator->key() == end)
+            {
+                iterator->Prev();
+            }
+        }
+        else
+        {
+            iterator->Seek(begin);
+        }
+
+        while (iterator->Valid() && (range.limit == 0 || keyValues[i].size() < range.limit))
+        {
+            const rocksdb::Slice key = iterator->key();
+
+            if (range.reverse ? key.compare(begin) < 0 : key.compare(end) >= 0)
+            {
+                break;
+            }
+
+            keyValues[i].emplace_back(key.ToString(), iterator->value().ToString());
+
+            if (range.reverse)
+            {
+                iterator->Prev();
+            }
+            else
+            {
+                iterator->Next();
+            }
+        }
+
+        if (!iterator->status().ok())
+        {
+            logger(ERROR) << "Can't read range from DB. " << iterator->status().ToString();
+            return make_error_code(CryptoNote::error::DataBaseErrorCodes::INTERNAL_ERROR);
+        }
+    }
+
     return std::error_code();
 }
 
@@ -236,52 +486,87 @@ rocksdb::Options RocksDBWrapper::getDBOptions(const DataBaseConfig &config)
     dbOptions.IncreaseParallelism(config.backgroundThreadsCount);
     dbOptions.info_log_level = rocksdb::InfoLogLevel::WARN_LEVEL;
     dbOptions.max_open_files = config.maxOpenFiles;
+    dbOptions.create_missing_column_families = true;
+    // every family has its own memtables, so cap them all at what a single
+    // family merging two memtables would use
+    dbOptions.db_write_buffer_size = static_cast<size_t>(config.writeBufferSize * 2);
+    // only the tickers are needed, for logWriteVolume
+    dbOptions.statistics = rocksdb::CreateDBStatistics();
+    dbOptions.statistics->set_stats_level(rocksdb::StatsLevel::kExceptHistogramOrTimers);
 
-    rocksdb::ColumnFamilyOptions fOptions;
-    fOptions.write_buffer_size = static_cast<size_t>(config.writeBufferSize);
-    // merge two memtables when flushing to L0
-    fOptions.min_write_buffer_number_to_merge = 2;
-    // this means we'll use 50% extra memory in the worst case, but will reduce
-    // write stalls.
-    fOptions.max_write_buffer_number = 6;
-    // start flushing L0->L1 as soon as possible. each file on level0 is
-    // (memtable_memory_budget / 2). This will flush level 0 when it's bigger than
-    // memtable_memory_budget.
-    fOptions.level0_file_num_compaction_trigger = 20;
-
-    fOptions.level0_slowdown_writes_trigger = 30;
-    fOptions.level0_stop_writes_trigger = 40;
-
-    // doesn't really matter much, but we don't want to create too many files
-    fOptions.target_file_size_base = config.writeBufferSize / 10;
-    // make Level1 size equal to Level0 size, so that L0->L1 compactions are fast
-    fOptions.max_bytes_for_level_base = config.writeBufferSize;
-    fOptions.num_levels = 10;
-    fOptions.target_file_size_multiplier = 2;
-    // level style compaction
-    fOptions.compaction_style = rocksdb::kCompactionStyleLevel;
-
-    fOptions.compression_per_level.resize(fOptions.num_levels);
-
-    const auto compressionLevel = config.compressionEnabled
-        ? rocksdb::kZSTD
-        : rocksdb::kNoCompression;
-
-    for (int i = 0; i < fOptions.num_levels; ++i)
+    rocksdb::ColumnFamilyOptions fOptions =
+        getColumnFamilyOptions(config, INDEX_LOOKUP, rocksdb::NewLRUCache(config.readCacheSize));
+
+    return rocksdb::Options(dbOptions, fOptions);
+}
+
+std::vector<rocksdb::ColumnFamilyDescriptor> RocksDBWrapper::getColumnFamilyDescriptors(const DataBaseConfig &config)
+{
+    /* Key images and raw blocks get their own cache budgets, so neither can
+       push the other families out of the shared cache */
+    const std::shared_ptr<rocksdb::Cache> sharedCache = rocksdb::NewLRUCache(config.readCacheSize);
+    const std::shared_ptr<rocksdb::Cache> keyImageCache = rocksdb::NewLRUCache(config.keyImageCacheSize);
+    const std::shared_ptr<rocksdb::Cache> rawBlockCache = rocksdb::NewLRUCache(config.rawBlockCacheSize);
+
+    std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+
+    descriptors.emplace_back(
+        rocksdb::kDefaultColumnFamilyName, getColumnFamilyOptions(config, INDEX_LOOKUP, sharedCache));
+
+    for (const auto &family : COLUMN_FAMILIES)
     {
-        // don't compress l0 & l1
-        fOptions.compression_per_level[i] = (i < 2 ? rocksdb::kNoCompression : compressionLevel);
+        const auto &blockCache = family.type == KEY_IMAGE ? keyImageCache
+                                 : family.type == RAW_BLOCK ? rawBlockCache
+                                 : sharedCache;
+
+        descriptors.emplace_back(family.name, getColumnFamilyOptions(config, family.type, blockCache));
     }
 
-    // bottom most use kZSTD
-    fOptions.bottommost_compression = compressionLevel;
+    return descriptors;
+}
 
-    rocksdb::BlockBasedTableOptions tableOptions;
-    tableOptions.block_cache = rocksdb::NewLRUCache(config.readCacheSize);
-    std::shared_ptr<rocksdb::TableFactory> tfp(NewBlockBasedTableFactory(tableOptions));
-    fOptions.table_factory = tfp;
+rocksdb::ColumnFamilyHandle *RocksDBWrapper::getColumnFamily(const rocksdb::Slice &key) const
+{
+    if (key.empty())
+    {
+        return columnFamilies[0];
+    }
 
-    return rocksdb::Options(dbOptions, fOptions);
+    return columnFamilyByPrefix[static_cast<uint8_t>(key[0])];
+}
+
+void RocksDBWrapper::closeColumnFamilies()
+{
+    for (rocksdb::ColumnFamilyHandle *family : columnFamilies)
+    {
+        db->DestroyColumnFamilyHandle(family);
+    }
+
+    columnFamilies.clear();
+}
+
+void RocksDBWrapper::logWriteVolume() const
+{
+    const uint64_t userBytes = statistics->getTickerCount(rocksdb::BYTES_WRITTEN);
+    const uint64_t walBytes = statistics->getTickerCount(rocksdb::WAL_FILE_BYTES);
+    const uint64_t flushBytes = statistics->getTickerCount(rocksdb::FLUSH_WRITE_BYTES);
+    const uint64_t compactionBytes = statistics->getTickerCount(rocksdb::COMPACT_WRITE_BYTES);
+    const uint64_t blobBytes = statistics->getTickerCount(rocksdb::BLOB_DB_BLOB_FILE_BYTES_WRITTEN);
+
+    /* Blob files are written by flushes and compactions, so are already
+       counted in their bytes */
+    const uint64_t diskBytes = walBytes + flushBytes + compactionBytes;
+
+    logger(INFO) << "DB wrote " << diskBytes / BYTES_PER_MB << " MB to disk for " << userBytes / BYTES_PER_MB
+                 << " MB of data this session. WAL: " << walBytes / BYTES_PER_MB
+                 << " MB, flushes: " << flushBytes / BYTES_PER_MB
+                 << " MB, compactions: " << compactionBytes / BYTES_PER_MB
+                 << " MB, of which blob files: " << blobBytes / BYTES_PER_MB << " MB";
+
+    if (userBytes != 0)
+    {
+        logger(INFO) << "DB write amplification: " << static_cast<double>(diskBytes) / userBytes;
+    }
 }
 
 std::string RocksDBWrapper::getDataDir(const DataBaseConfig &config)
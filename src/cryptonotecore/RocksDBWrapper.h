@@ -8,6 +8,7 @@
 #include "IDataBase.h"
 #include "rocksdb/db.h"
 
+#include <array>
 #include <atomic>
 #include <logging/LoggerRef.h>
 #include <memory>
@@ -45,8 +46,22 @@ namespace CryptoNote
       private:
         std::error_code write(IWriteBatch &batch, bool sync);
 
+        std::error_code readRanges(
+            const std::vector<RawKeyRange> &ranges,
+            std::vector<std::vector<std::pair<std::string, std::string>>> &keyValues);
+
         rocksdb::Options getDBOptions(const DataBaseConfig &config);
 
+        std::vector<rocksdb::ColumnFamilyDescriptor> getColumnFamilyDescriptors(const DataBaseConfig &config);
+
+        /* The family a key is stored in, picked by its prefix */
+        rocksdb::ColumnFamilyHandle *getColumnFamily(const rocksdb::Slice &key) const;
+
+        void closeColumnFamilies();
+
+        /* Logs how much was written to disk since the DB was opened */
+        void logWriteVolume() const;
+
         std::string getDataDir(const DataBaseConfig &config);
 
         enum State
@@ -59,6 +74,14 @@ namespace CryptoNote
 
         std::unique_ptr<rocksdb::DB> db;
 
+        std::shared_ptr<rocksdb::Statistics> statistics;
+
+        /* Handles returned by DB::Open, in the order of getColumnFamilyDescriptors */
+        std::vector<rocksdb::ColumnFamilyHandle *> columnFamilies;
+
+        /* Indexed by the first byte of a key */
+        std::array<rocksdb::ColumnFamilyHandle *, 256> columnFamilyByPrefix;
+
         std::atomic<State> state;
     };
 } // namespace CryptoNote
@@ -5,6 +5,8 @@
 //
 // Please see the included LICENSE file for more information.
 
+#include <algorithm>
+
 #include <config/CryptoNoteConfig.h>
 #include <cryptonotecore/Mixins.h>
 #include <cryptonotecore/TransactionValidationErrors.h>
@@ -21,7 +23,8 @@ ValidateTransaction::ValidateTransaction(
     Utilities::ThreadPool<bool> &threadPool,
     const uint64_t blockHeight,
     const uint64_t blockSizeMedian,
-    const bool isPoolTransaction) :
+    const bool isPoolTransaction,
+    const bool ringSignaturesVerified) :
     m_cachedTransaction(cachedTransaction),
     m_transaction(cachedTransaction.getTransaction()),
     m_validatorState(state),
@@ -31,63 +34,53 @@ ValidateTransaction::ValidateTransaction(
     m_blockchainCache(cache),
     m_blockHeight(blockHeight),
     m_blockSizeMedian(blockSizeMedian),
-    m_isPoolTransaction(isPoolTransaction)
+    m_isPoolTransaction(isPoolTransaction),
+    m_ringSignaturesVerified(ringSignaturesVerified)
 {
 }
 
 TransactionValidationResult ValidateTransaction::validate()
 {
-    /* Validate transaction isn't too big */
-    if (!validateTransactionSize())
+    /* Perform all the cheap checks first, so we can fail fast */
+    if (!validateWithoutExpensiveInputs().valid)
     {
         return m_validationResult;
     }
 
-    /* Validate the transaction inputs are non empty, key images are valid, etc. */
-    if (!validateTransactionInputs())
+    /* Verify key images are not spent, ring signatures are valid, etc. We
+     * do this separately from the transaction input verification, because
+     * these checks are much slower to perform, so we want to fail fast on the
+     * cheaper checks first. */
+    if (!validateTransactionInputsExpensive())
     {
+        m_validationResult.valid = false;
         return m_validationResult;
     }
 
-    /* Validate transaction outputs are non zero, don't overflow, etc */
-    if (!validateTransactionOutputs())
-    {
-        return m_validationResult;
-    }
+    return m_validationResult;
+}
 
-    /* Verify inputs > outputs, fee is > min fee unless fusion, etc */
-    if (!validateTransactionFee())
+/* Note: Does not set the .fee property */
+TransactionValidationResult ValidateTransaction::revalidateAfterHeightChange()
+{
+    /* Validate transaction isn't too big now that the median size has changed */
+    if (!validateTransactionSize())
     {
         return m_validationResult;
     }
 
-    /* Validate the transaction extra is a reasonable size. */
+    /* Validate the transaction extra is still a reasonable size. */
     if (!validateTransactionExtra())
     {
         return m_validationResult;
     }
 
-    /* Validate transaction input / output ratio is not excessive */
-    if (!validateInputOutputRatio())
-    {
-        return m_validationResult;
-    }
-
-    /* Validate transaction mixin is in the valid range */
+    /* Validate transaction mixin is still in the valid range */
     if (!validateTransactionMixin())
     {
         return m_validationResult;
     }
 
-    /* Verify key images are not spent, ring signatures are valid, etc. We
-     * do this separately from the transaction input verification, because
-     * these checks are much slower to perform, so we want to fail fast on the
-     * cheaper checks first. */
-    if (!validateTransactionInputsExpensive())
-    {
-        return m_validationResult;
-    }
-
     m_validationResult.valid = true;
     setTransactionValidationResult(
         CryptoNote::error::TransactionValidationError::VALIDATION_SUCCESS
@@ -96,27 +89,54 @@ TransactionValidationResult ValidateTransaction::validate()
     return m_validationResult;
 }
 
-/* Note: Does not set the .fee property */
-TransactionValidationResult ValidateTransaction::revalidateAfterHeightChange()
+TransactionValidationResult ValidateTransaction::validateWithoutExpensiveInputs()
 {
-    /* Validate transaction isn't too big now that the median size has changed */
+    /* Validate transaction isn't too big */
     if (!validateTransactionSize())
     {
         return m_validationResult;
     }
 
-    /* Validate the transaction extra is still a reasonable size. */
+    /* Validate the transaction inputs are non empty, key images are valid, etc. */
+    if (!validateTransactionInputs())
+    {
+        return m_validationResult;
+    }
+
+    /* Validate transaction outputs are non zero, don't overflow, etc */
+    if (!validateTransactionOutputs())
+    {
+        return m_validationResult;
+    }
+
+    /* Verify inputs > outputs, fee is > min fee unless fusion, etc */
+    if (!validateTransactionFee())
+    {
+        return m_validationResult;
+    }
+
+    /* Validate the transaction extra is a reasonable size. */
     if (!validateTransactionExtra())
     {
         return m_validationResult;
     }
 
-    /* Validate transaction mixin is still in the valid range */
+    /* Validate transaction input / output ratio is not excessive */
+    if (!validateInputOutputRatio())
+    {
+        return m_validationResult;
+    }
+
+    /* Validate transaction mixin is in the valid range */
     if (!validateTransactionMixin())
     {
         return m_validationResult;
     }
 
+    /* The prefix hash is computed lazily, so make sure it is populated before
+     * the expensive input checks read it from multiple threads */
+    m_cachedTransaction.getTransactionPrefixHash();
+
     m_validationResult.valid = true;
     setTransactionValidationResult(
         CryptoNote::error::TransactionValidationError::VALIDATION_SUCCESS
@@ -125,7 +145,6 @@ TransactionValidationResult ValidateTransaction::revalidateAfterHeightChange()
     return m_validationResult;
 }
 
-
 bool ValidateTransaction::validateTransactionSize()
 {
     const auto maxTransactionSize = m_blockSizeMedian * 2 - m_currency.minerTxBlobReservedSize();
@@ -482,127 +501,228 @@ bool ValidateTransaction::validateTransactionMixin()
     return true;
 }
 
+bool ValidateTransaction::isInCheckpointZone() const
+{
+    return m_checkpoints.isInCheckpointZone(m_blockHeight + 1);
+}
+
 bool ValidateTransaction::validateTransactionInputsExpensive()
 {
     /* Don't need to do expensive transaction validation for transactions
      * in a checkpoints range - they are assumed valid, and the transaction
      * hash would change thus invalidation the checkpoints if not. */
-    if (m_checkpoints.isInCheckpointZone(m_blockHeight + 1))
+    if (isInCheckpointZone())
     {
         return true;
     }
 
-    uint64_t inputIndex = 0;
-
     std::vector<std::future<bool>> validationResult;
     std::atomic<bool> cancelValidation = false;
-    const Crypto::Hash prefixHash = m_cachedTransaction.getTransactionPrefixHash();
 
-    for (const auto &input : m_transaction.inputs)
+    for (uint64_t inputIndex = 0; inputIndex < m_transaction.inputs.size(); inputIndex++)
     {
         /* Validate each input on a separate thread in our thread pool */
-    validationResult.push_back(m_threadPool.addJob([inputIndex, &input, &prefixHash, &cancelValidation, this] {
-        const CryptoNote::KeyInput &in = boost::get<CryptoNote::KeyInput>(input);
-        if (cancelValidation)
+        validationResult.push_back(m_threadPool.addJob([inputIndex, &cancelValidation, this] {
+            if (cancelValidation)
+            {
+                return false;
+            }
+
+            return validateInputExpensive(inputIndex);
+        }));
+    }
+
+    bool valid = true;
+
+    for (auto &result : validationResult)
+    {
+        if (!result.get())
         {
-            return false;
+            valid = false;
+            cancelValidation = true;
         }
-        if (m_blockchainCache->checkIfSpent(in.keyImage, m_blockHeight))
+    }
+
+    return valid;
+}
+
+bool ValidateTransaction::validateInputExpensive(const uint64_t inputIndex)
+{
+    std::vector<Crypto::PublicKey> outputKeys;
+
+    if (!validateInputSpendable(inputIndex, outputKeys))
+    {
+        return false;
+    }
+
+    if (m_ringSignaturesVerified)
+    {
+        return true;
+    }
+
+    const CryptoNote::KeyInput &in = boost::get<CryptoNote::KeyInput>(m_transaction.inputs[inputIndex]);
+
+    if (!Crypto::crypto_ops::checkRingSignature(
+            m_cachedTransaction.getTransactionPrefixHash(),
+            in.keyImage,
+            outputKeys,
+            m_transaction.signatures[inputIndex]))
+    {
+        setTransactionValidationResult(
+            CryptoNote::error::TransactionValidationError::INPUT_INVALID_SIGNATURES,
+            "Transaction contains invalid signatures"
+        );
+
+        return false;
+    }
+
+    return true;
+}
+
+bool ValidateTransaction::validateInputSpendable(
+    const uint64_t inputIndex,
+    std::vector<Crypto::PublicKey> &outputKeys)
+{
+    const CryptoNote::KeyInput &in = boost::get<CryptoNote::KeyInput>(m_transaction.inputs[inputIndex]);
+
+    if (m_blockchainCache->checkIfSpent(in.keyImage, m_blockHeight))
+    {
+        // Create error context with detailed information
+        CryptoNote::error::ErrorContext context;
+        context.keyImage = Common::podToHex(in.keyImage);
+
+        // Use the context-aware error creation
+        std::error_code errorCode = CryptoNote::error::make_error_code_with_context(
+            CryptoNote::error::TransactionValidationError::INPUT_KEYIMAGE_ALREADY_SPENT,
+            context
+        );
+
+        setTransactionValidationResult(errorCode, errorCode.message());
+
+        return false;
+    }
+
+    std::vector<uint32_t> globalIndexes(in.outputIndexes.size());
+
+    globalIndexes[0] = in.outputIndexes[0];
+
+    /* Convert output indexes from relative to absolute */
+    for (size_t i = 1; i < in.outputIndexes.size(); ++i)
+    {
+        globalIndexes[i] = globalIndexes[i - 1] + in.outputIndexes[i];
+    }
+
+    const auto result = m_blockchainCache->extractKeyOutputKeys(
+        in.amount, m_blockHeight, {globalIndexes.data(), globalIndexes.size()}, outputKeys);
+
+    if (result == CryptoNote::ExtractOutputKeysResult::INVALID_GLOBAL_INDEX)
+    {
+        setTransactionValidationResult(
+            CryptoNote::error::TransactionValidationError::INPUT_INVALID_GLOBAL_INDEX,
+            "Transaction contains invalid global indexes"
+        );
+
+        return false;
+    }
+
+    if (result == CryptoNote::ExtractOutputKeysResult::OUTPUT_LOCKED)
+    {
+        setTransactionValidationResult(
+            CryptoNote::error::TransactionValidationError::INPUT_SPEND_LOCKED_OUT,
+            "Transaction includes an input which is still locked"
+        );
+
+        return false;
+    }
+
+    if (m_isPoolTransaction
+        || m_blockHeight >= CryptoNote::parameters::TRANSACTION_SIGNATURE_COUNT_VALIDATION_HEIGHT)
+    {
+        if (outputKeys.size() != m_transaction.signatures[inputIndex].size())
         {
-            // Create error context with detailed information
-            CryptoNote::error::ErrorContext context;
-            context.keyImage = Common::podToHex(in.keyImage);
-            
-            // Use the context-aware error creation
-            std::error_code errorCode = CryptoNote::error::make_error_code_with_context(
-                CryptoNote::error::TransactionValidationError::INPUT_KEYIMAGE_ALREADY_SPENT,
-                context
+            setTransactionValidationResult(
+                CryptoNote::error::TransactionValidationError::INPUT_INVALID_SIGNATURES_COUNT,
+                "Transaction has an invalid number of signatures"
             );
-            
-            setTransactionValidationResult(errorCode, errorCode.message());
-            
+
             return false;
         }
+    }
 
-            std::vector<Crypto::PublicKey> outputKeys;
-            std::vector<uint32_t> globalIndexes(in.outputIndexes.size());
+    return true;
+}
 
-            globalIndexes[0] = in.outputIndexes[0];
+bool ValidateTransaction::validateInputsExpensive(
+    const std::vector<std::tuple<ValidateTransaction *, uint64_t>> &inputs)
+{
+    bool valid = true;
 
-            /* Convert output indexes from relative to absolute */
-            for (size_t i = 1; i < in.outputIndexes.size(); ++i)
-            {
-                globalIndexes[i] = globalIndexes[i - 1] + in.outputIndexes[i];
-            }
+    /* Ring members of every input we still need to check the signature of */
+    std::vector<std::vector<Crypto::PublicKey>> outputKeys(inputs.size());
 
-            const auto result = m_blockchainCache->extractKeyOutputKeys(
-                in.amount, m_blockHeight, {globalIndexes.data(), globalIndexes.size()}, outputKeys);
+    std::vector<Crypto::RingSignatureToCheck> ringSignatures;
+    std::vector<size_t> ringSignatureInputs;
 
-            if (result == CryptoNote::ExtractOutputKeysResult::INVALID_GLOBAL_INDEX)
-            {
-                setTransactionValidationResult(
-                    CryptoNote::error::TransactionValidationError::INPUT_INVALID_GLOBAL_INDEX,
-                    "Transaction contains invalid global indexes"
-                );
-
-                return false;
-            }
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        const auto [validator, inputIndex] = inputs[i];
 
-            if (result == CryptoNote::ExtractOutputKeysResult::OUTPUT_LOCKED)
-            {
-                setTransactionValidationResult(
-                    CryptoNote::error::TransactionValidationError::INPUT_SPEND_LOCKED_OUT,
-                    "Transaction includes an input which is still locked"
-                );
+        if (!validator->validateInputSpendable(inputIndex, outputKeys[i]))
+        {
+            valid = false;
+            continue;
+        }
 
-                return false;
-            }
+        if (validator->m_ringSignaturesVerified)
+        {
+            continue;
+        }
 
-            if (m_isPoolTransaction
-                || m_blockHeight >= CryptoNote::parameters::TRANSACTION_SIGNATURE_COUNT_VALIDATION_HEIGHT)
-            {
-                if (outputKeys.size() != m_transaction.signatures[inputIndex].size())
-                {
-                    setTransactionValidationResult(
-                        CryptoNote::error::TransactionValidationError::INPUT_INVALID_SIGNATURES_COUNT,
-                        "Transaction has an invalid number of signatures"
-                    );
-
-                    return false;
-                }
-            }
+        const CryptoNote::KeyInput &in = boost::get<CryptoNote::KeyInput>(validator->m_transaction.inputs[inputIndex]);
 
-            if (!Crypto::crypto_ops::checkRingSignature(
-                    prefixHash, in.keyImage, outputKeys, m_transaction.signatures[inputIndex]))
-            {
-                setTransactionValidationResult(
-                    CryptoNote::error::TransactionValidationError::INPUT_INVALID_SIGNATURES,
-                    "Transaction contains invalid signatures"
-                );
+        ringSignatures.push_back({
+            validator->m_cachedTransaction.getTransactionPrefixHash(),
+            in.keyImage,
+            outputKeys[i],
+            validator->m_transaction.signatures[inputIndex]
+        });
 
-                return false;
-            }
+        ringSignatureInputs.push_back(i);
+    }
 
-            return true;
-        }));
+    std::vector<bool> results;
 
-        inputIndex++;
+    if (Crypto::crypto_ops::checkRingSignatures(ringSignatures, results))
+    {
+        return valid;
     }
 
-    bool valid = true;
+    /* If the batch failed without singling out a signature, every input in
+     * it is suspect, so make sure an error is still recorded */
+    const bool anyResultFailed = std::find(results.begin(), results.end(), false) != results.end();
 
-    for (auto &result : validationResult)
+    for (size_t i = 0; i < ringSignatureInputs.size(); i++)
     {
-        if (!result.get())
+        if (!anyResultFailed || !results[i])
         {
-            valid = false;
-            cancelValidation = true;
+            ValidateTransaction *validator = std::get<0>(inputs[ringSignatureInputs[i]]);
+
+            validator->setTransactionValidationResult(
+                CryptoNote::error::TransactionValidationError::INPUT_INVALID_SIGNATURES,
+                "Transaction contains invalid signatures"
+            );
         }
     }
 
-    return valid;
+    return false;
 }
 
+TransactionValidationResult ValidateTransaction::getValidationResult()
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+
+    return m_validationResult;
+}
 
 void ValidateTransaction::setTransactionValidationResult(const std::error_code &error_code, const std::string &error_message)
 {
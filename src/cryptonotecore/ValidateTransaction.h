@@ -8,6 +8,8 @@
 #pragma once
 
 #include <system_error>
+#include <tuple>
+#include <vector>
 
 #include <CryptoNote.h>
 #include <cryptonotecore/CachedTransaction.h>
@@ -49,7 +51,8 @@ class ValidateTransaction
             Utilities::ThreadPool<bool> &threadPool,
             const uint64_t blockHeight,
             const uint64_t blockSizeMedian,
-            const bool isPoolTransaction);
+            const bool isPoolTransaction,
+            const bool ringSignaturesVerified);
 
         /////////////////////////////
         /* PUBLIC MEMBER FUNCTIONS */
@@ -58,6 +61,26 @@ class ValidateTransaction
 
         TransactionValidationResult revalidateAfterHeightChange();
 
+        /* Performs every check except the per input ring signature and
+         * spent key image checks. Used by block validation, which verifies
+         * the inputs of every transaction in the block as a single batch */
+        TransactionValidationResult validateWithoutExpensiveInputs();
+
+        /* Performs the expensive checks for a single input. Safe to call
+         * concurrently for different inputs. */
+        bool validateInputExpensive(const uint64_t inputIndex);
+
+        /* Performs the expensive checks for a group of inputs, which may
+         * belong to different transactions. The ring signatures of the group
+         * are verified together, sharing the cost of encoding the ring
+         * commitments. Failures are recorded on the owning validator. */
+        static bool validateInputsExpensive(const std::vector<std::tuple<ValidateTransaction *, uint64_t>> &inputs);
+
+        /* Whether the expensive input checks can be skipped for this transaction */
+        bool isInCheckpointZone() const;
+
+        TransactionValidationResult getValidationResult();
+
     private:
         //////////////////////////////
         /* PRIVATE MEMBER FUNCTIONS */
@@ -78,6 +101,10 @@ class ValidateTransaction
 
         bool validateTransactionInputsExpensive();
 
+        /* Key image, global index, unlock time and signature count checks for
+         * a single input. Fills in the ring members on success. */
+        bool validateInputSpendable(const uint64_t inputIndex, std::vector<Crypto::PublicKey> &outputKeys);
+
         void setTransactionValidationResult(const std::error_code &error_code, const std::string &error_message = "");
 
         /////////////////////////
@@ -101,6 +128,11 @@ class ValidateTransaction
 
         const bool m_isPoolTransaction;
 
+        /* Ring signatures were already verified against the same chain, for
+         * example when the transaction entered the pool. Only the spent and
+         * locked checks need repeating. */
+        const bool m_ringSignaturesVerified;
+
         TransactionValidationResult m_validationResult;
 
         uint64_t m_sumOfOutputs = 0;
@@ -0,0 +1,85 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include <cryptonotecore/VerifiedTransactionCache.h>
+
+namespace CryptoNote
+{
+    VerifiedTransactionCache::VerifiedTransactionCache(const size_t maxSize): m_maxSize(maxSize) {}
+
+    void VerifiedTransactionCache::add(const Crypto::Hash &transactionHash, const Crypto::Hash &tipHash)
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+
+        const auto [it, inserted] = m_verified.insert_or_assign(transactionHash, tipHash);
+
+        if (!inserted)
+        {
+            return;
+        }
+
+        m_insertionOrder.push_back(transactionHash);
+
+        /* Evict the oldest entries. Entries which were already removed are
+           skipped over when they reach the front. */
+        while (m_verified.size() > m_maxSize && !m_insertionOrder.empty())
+        {
+            m_verified.erase(m_insertionOrder.front());
+            m_insertionOrder.pop_front();
+        }
+
+        /* Don't let removed entries make the queue grow without bound */
+        if (m_insertionOrder.size() > m_maxSize * 2)
+        {
+            std::deque<Crypto::Hash> insertionOrder;
+
+            for (const auto &hash : m_insertionOrder)
+            {
+                if (m_verified.find(hash) != m_verified.end())
+                {
+                    insertionOrder.push_back(hash);
+                }
+            }
+
+            m_insertionOrder = std::move(insertionOrder);
+        }
+    }
+
+    bool VerifiedTransactionCache::contains(const Crypto::Hash &transactionHash, const Crypto::Hash &tipHash) const
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+
+        const auto it = m_verified.find(transactionHash);
+
+        return it != m_verified.end() && it->second == tipHash;
+    }
+
+    void VerifiedTransactionCache::remove(const Crypto::Hash &transactionHash)
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+
+        m_verified.erase(transactionHash);
+    }
+
+    void VerifiedTransactionCache::advanceTip(const Crypto::Hash &oldTipHash, const Crypto::Hash &newTipHash)
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+
+        for (auto &[transactionHash, tipHash] : m_verified)
+        {
+            if (tipHash == oldTipHash)
+            {
+                tipHash = newTipHash;
+            }
+        }
+    }
+
+    void VerifiedTransactionCache::clear()
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+
+        m_verified.clear();
+        m_insertionOrder.clear();
+    }
+} // namespace CryptoNote
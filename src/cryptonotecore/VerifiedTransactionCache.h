@@ -0,0 +1,49 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <CryptoTypes.h>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace CryptoNote
+{
+    /* Remembers which transactions have had their ring signatures verified,
+       and which chain tip they were verified against. The output keys a ring
+       signature is checked against only change when the chain below the tip
+       changes, so a result can be reused for any block built on that tip. */
+    class VerifiedTransactionCache
+    {
+      public:
+        explicit VerifiedTransactionCache(const size_t maxSize);
+
+        /* Record that the transaction was fully verified on top of tipHash */
+        void add(const Crypto::Hash &transactionHash, const Crypto::Hash &tipHash);
+
+        /* Whether the transaction was verified on top of tipHash */
+        bool contains(const Crypto::Hash &transactionHash, const Crypto::Hash &tipHash) const;
+
+        void remove(const Crypto::Hash &transactionHash);
+
+        /* A block was added on top of oldTipHash. Appending a block does not
+           change any existing outputs, so results verified against the old
+           tip are still valid against the new one. */
+        void advanceTip(const Crypto::Hash &oldTipHash, const Crypto::Hash &newTipHash);
+
+        void clear();
+
+      private:
+        const size_t m_maxSize;
+
+        /* Transaction hash -> tip hash it was verified against */
+        std::unordered_map<Crypto::Hash, Crypto::Hash> m_verified;
+
+        /* Insertion order, used to evict the oldest results when full */
+        std::deque<Crypto::Hash> m_insertionOrder;
+
+        mutable std::mutex m_mutex;
+    };
+} // namespace CryptoNote
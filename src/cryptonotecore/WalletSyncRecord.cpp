@@ -0,0 +1,118 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "WalletSyncRecord.h"
+
+#include <common/CryptoNoteTools.h>
+#include <cryptonotecore/CryptoNoteFormatUtils.h>
+#include <stdexcept>
+#include <utilities/ParseExtra.h>
+
+namespace CryptoNote
+{
+    namespace
+    {
+        std::vector<WalletTypes::KeyOutput> makeWalletKeyOutputs(const Transaction &transaction)
+        {
+            std::vector<WalletTypes::KeyOutput> keyOutputs;
+            keyOutputs.reserve(transaction.outputs.size());
+
+            for (const auto &output : transaction.outputs)
+            {
+                WalletTypes::KeyOutput keyOutput;
+
+                keyOutput.amount = output.amount;
+                keyOutput.key = boost::get<KeyOutput>(output.target).key;
+
+                keyOutputs.push_back(keyOutput);
+            }
+
+            return keyOutputs;
+        }
+    } // namespace
+
+    WalletTypes::RawCoinbaseTransaction makeWalletCoinbaseTransaction(const Transaction &transaction)
+    {
+        WalletTypes::RawCoinbaseTransaction coinbaseTransaction;
+
+        coinbaseTransaction.hash = getObjectHash(transaction);
+        coinbaseTransaction.transactionPublicKey = Utilities::getTransactionPublicKeyFromExtra(transaction.extra);
+        coinbaseTransaction.unlockTime = transaction.unlockTime;
+        coinbaseTransaction.keyOutputs = makeWalletKeyOutputs(transaction);
+
+        return coinbaseTransaction;
+    }
+
+    WalletTypes::RawTransaction makeWalletTransaction(const CachedTransaction &cachedTransaction)
+    {
+        const Transaction &transaction = cachedTransaction.getTransaction();
+
+        WalletTypes::RawTransaction walletTransaction;
+
+        walletTransaction.hash = cachedTransaction.getTransactionHash();
+
+        const Utilities::ParsedExtra parsedExtra = Utilities::parseExtra(transaction.extra);
+
+        /* Transaction public key, used for decrypting transactions along with
+           private view key */
+        walletTransaction.transactionPublicKey = parsedExtra.transactionPublicKey;
+
+        /* Get the payment ID if it exists (Empty string if it doesn't) */
+        walletTransaction.paymentID = parsedExtra.paymentID;
+
+        walletTransaction.unlockTime = transaction.unlockTime;
+        walletTransaction.keyOutputs = makeWalletKeyOutputs(transaction);
+
+        /* The inputs used for a transaction, can be used to track outgoing
+           transactions */
+        walletTransaction.keyInputs.reserve(transaction.inputs.size());
+
+        for (const auto &input : transaction.inputs)
+        {
+            walletTransaction.keyInputs.push_back(boost::get<KeyInput>(input));
+        }
+
+        return walletTransaction;
+    }
+
+    WalletTypes::WalletBlockInfo
+        makeWalletBlockInfo(const CachedBlock &block, const std::vector<CachedTransaction> &transactions)
+    {
+        WalletTypes::WalletBlockInfo walletBlock;
+
+        walletBlock.blockHeight = block.getBlockIndex();
+        walletBlock.blockHash = block.getBlockHash();
+        walletBlock.blockTimestamp = block.getBlock().timestamp;
+        walletBlock.coinbaseTransaction = makeWalletCoinbaseTransaction(block.getBlock().baseTransaction);
+
+        walletBlock.transactions.reserve(transactions.size());
+
+        for (const auto &transaction : transactions)
+        {
+            walletBlock.transactions.push_back(makeWalletTransaction(transaction));
+        }
+
+        return walletBlock;
+    }
+
+    WalletTypes::WalletBlockInfo makeWalletBlockInfo(const RawBlock &rawBlock)
+    {
+        BlockTemplate block;
+
+        if (!fromBinaryArray(block, rawBlock.block))
+        {
+            throw std::runtime_error("Failed to parse raw block");
+        }
+
+        std::vector<CachedTransaction> transactions;
+        transactions.reserve(rawBlock.transactions.size());
+
+        for (const auto &transaction : rawBlock.transactions)
+        {
+            transactions.emplace_back(transaction);
+        }
+
+        return makeWalletBlockInfo(CachedBlock(block), transactions);
+    }
+} // namespace CryptoNote
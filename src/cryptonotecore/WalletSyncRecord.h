@@ -0,0 +1,26 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <WalletTypes.h>
+#include <cryptonotecore/CachedBlock.h>
+#include <cryptonotecore/CachedTransaction.h>
+#include <vector>
+
+namespace CryptoNote
+{
+    /* Just the parts of a block a wallet needs to find and spend its outputs.
+       The database stores one of these for every block when it is pushed, so
+       wallets can sync without the daemon parsing each raw block they ask for. */
+    WalletTypes::RawCoinbaseTransaction makeWalletCoinbaseTransaction(const Transaction &transaction);
+
+    WalletTypes::RawTransaction makeWalletTransaction(const CachedTransaction &transaction);
+
+    /* Always includes the coinbase transaction */
+    WalletTypes::WalletBlockInfo
+        makeWalletBlockInfo(const CachedBlock &block, const std::vector<CachedTransaction> &transactions);
+
+    WalletTypes::WalletBlockInfo makeWalletBlockInfo(const RawBlock &rawBlock);
+} // namespace CryptoNote
@@ -20,6 +20,7 @@
 #include <future>
 #include <serialization/SerializationTools.h>
 #include <system/Dispatcher.h>
+#include <system/RemoteContext.h>
 #include <utilities/FormatTools.h>
 
 using namespace Logging;
@@ -695,6 +696,14 @@ namespace CryptoNote
         const std::vector<CachedBlock> &cachedBlocks)
     {
         assert(rawBlocks.size() == cachedBlocks.size());
+
+        /* Compute the proof of work hashes of the whole batch in parallel,
+           without blocking the dispatcher while we wait */
+        System::RemoteContext<void> precomputeContext(
+            m_dispatcher, [this, &cachedBlocks] { m_core.precomputeBlockLongHashes(cachedBlocks); });
+
+        precomputeContext.get();
+
         for (size_t index = 0; index < rawBlocks.size(); ++index)
         {
             if (m_stop)
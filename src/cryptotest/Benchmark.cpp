@@ -0,0 +1,306 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include <cryptotest/Benchmark.h>
+////////////////////////////////
+
+#include "version.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <crypto/hash.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace Benchmark
+{
+    namespace
+    {
+        /* Calibration stops once a batch takes this fraction of a sample */
+        const uint64_t CALIBRATION_FRACTION = 8;
+
+        /* Nanoseconds per operation of running operationCount operations */
+        double timeOperations(const Operation &operation, const uint64_t operationCount, uint64_t &iteration)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            for (uint64_t i = 0; i < operationCount; i++)
+            {
+                operation(iteration++);
+            }
+
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            return std::chrono::duration<double, std::nano>(elapsed).count() / operationCount;
+        }
+
+        /* Linearly interpolated percentile of sorted values, p from 0 to 1 */
+        double percentile(const std::vector<double> &sorted, const double p)
+        {
+            const double position = p * (sorted.size() - 1);
+            const size_t lower = static_cast<size_t>(std::floor(position));
+            const size_t upper = std::min(lower + 1, sorted.size() - 1);
+
+            return sorted[lower] + (sorted[upper] - sorted[lower]) * (position - lower);
+        }
+
+        std::string formatNanoseconds(const double nanoseconds)
+        {
+            std::stringstream stream;
+
+            stream << std::fixed << std::setprecision(2);
+
+            if (nanoseconds >= 1000000)
+            {
+                stream << nanoseconds / 1000000 << " ms";
+            }
+            else if (nanoseconds >= 1000)
+            {
+                stream << nanoseconds / 1000 << " us";
+            }
+            else
+            {
+                stream << nanoseconds << " ns";
+            }
+
+            return stream.str();
+        }
+    } // namespace
+
+    BenchmarkSuite::BenchmarkSuite(const BenchmarkOptions &options): m_options(options)
+    {
+        if (m_options.samples == 0 || m_options.threadCounts.empty())
+        {
+            throw std::invalid_argument("Benchmarks need at least one sample and one thread count");
+        }
+    }
+
+    void BenchmarkSuite::run(const std::string &name, const Operation &operation)
+    {
+        const uint64_t operationsPerSample = calibrate(operation);
+
+        std::cout << name << "\n";
+
+        double baselineThroughputPerThread = 0;
+
+        for (const size_t threads : m_options.threadCounts)
+        {
+            BenchmarkResult result = runWithThreads(name, operation, threads, operationsPerSample);
+
+            /* Scaling is relative to the first (usually single threaded) run */
+            if (baselineThroughputPerThread == 0)
+            {
+                baselineThroughputPerThread = result.operationsPerSecond / threads;
+            }
+
+            result.scalingEfficiency = result.operationsPerSecond / (threads * baselineThroughputPerThread);
+
+            std::cout << "  " << std::setw(3) << threads << (threads == 1 ? " thread:  " : " threads: ")
+                      << "median " << std::setw(10) << formatNanoseconds(result.medianNanoseconds) << ", p99 "
+                      << std::setw(10) << formatNanoseconds(result.p99Nanoseconds) << ", " << std::fixed
+                      << std::setprecision(1) << std::setw(12) << result.operationsPerSecond << " ops/s, "
+                      << std::setprecision(0) << std::setw(3) << result.scalingEfficiency * 100 << "% scaling\n";
+
+            m_results.push_back(result);
+        }
+
+        std::cout << std::defaultfloat << std::flush;
+    }
+
+    uint64_t BenchmarkSuite::calibrate(const Operation &operation) const
+    {
+        const double sampleNanoseconds = m_options.sampleMilliseconds * 1000000.0;
+
+        uint64_t iteration = 0;
+        uint64_t operationCount = 1;
+
+        while (true)
+        {
+            const double nanosecondsPerOperation = timeOperations(operation, operationCount, iteration);
+
+            const double batchNanoseconds = nanosecondsPerOperation * operationCount;
+
+            if (batchNanoseconds * CALIBRATION_FRACTION >= sampleNanoseconds)
+            {
+                return std::max<uint64_t>(1, static_cast<uint64_t>(sampleNanoseconds / nanosecondsPerOperation));
+            }
+
+            operationCount *= 2;
+        }
+    }
+
+    BenchmarkResult BenchmarkSuite::runWithThreads(
+        const std::string &name,
+        const Operation &operation,
+        const size_t threads,
+        const uint64_t operationsPerSample) const
+    {
+        std::vector<std::vector<double>> threadSamples(threads);
+
+        std::atomic<size_t> threadsReady = 0;
+
+        std::vector<std::thread> workers;
+
+        for (size_t t = 0; t < threads; t++)
+        {
+            workers.emplace_back([&, t] {
+                uint64_t iteration = 0;
+
+                for (size_t i = 0; i < m_options.warmupSamples; i++)
+                {
+                    timeOperations(operation, operationsPerSample, iteration);
+                }
+
+                /* Start the timed samples together, so they're taken with every
+                   thread competing for the cores and memory */
+                threadsReady++;
+
+                while (threadsReady < threads)
+                {
+                    std::this_thread::yield();
+                }
+
+                for (size_t i = 0; i < m_options.samples; i++)
+                {
+                    threadSamples[t].push_back(timeOperations(operation, operationsPerSample, iteration));
+                }
+            });
+        }
+
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+
+        std::vector<double> samples;
+
+        for (const auto &threadSample : threadSamples)
+        {
+            samples.insert(samples.end(), threadSample.begin(), threadSample.end());
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        BenchmarkResult result;
+
+        result.name = name;
+        result.threads = threads;
+        result.samples = samples.size();
+        result.operationsPerSample = operationsPerSample;
+        result.minNanoseconds = samples.front();
+        result.medianNanoseconds = percentile(samples, 0.5);
+        result.p99Nanoseconds = percentile(samples, 0.99);
+        result.maxNanoseconds = samples.back();
+        result.operationsPerSecond = threads * 1000000000.0 / result.medianNanoseconds;
+        result.scalingEfficiency = 1;
+
+        return result;
+    }
+
+    const std::vector<BenchmarkResult> &BenchmarkSuite::getResults() const
+    {
+        return m_results;
+    }
+
+    void BenchmarkSuite::writeJSON(const std::string &filename) const
+    {
+        std::ofstream file(filename);
+
+        if (!file)
+        {
+            throw std::runtime_error("Failed to open " + filename + " for writing");
+        }
+
+        rapidjson::OStreamWrapper stream(file);
+        rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(stream);
+
+        writer.StartObject();
+
+        writer.Key("version");
+        writer.String(PROJECT_VERSION_LONG);
+
+        writer.Key("hardwareConcurrency");
+        writer.Uint(std::thread::hardware_concurrency());
+
+        writer.Key("hugePages");
+        writer.Bool(Crypto::HashingContext::usingHugePages());
+
+        writer.Key("implementations");
+        writer.StartObject();
+
+        for (const auto &[name, implementation] : Crypto::getHashImplementations())
+        {
+            writer.Key(name.c_str());
+            writer.String(implementation.c_str());
+        }
+
+        writer.EndObject();
+
+        writer.Key("options");
+        writer.StartObject();
+        writer.Key("samples");
+        writer.Uint64(m_options.samples);
+        writer.Key("warmupSamples");
+        writer.Uint64(m_options.warmupSamples);
+        writer.Key("sampleMilliseconds");
+        writer.Uint64(m_options.sampleMilliseconds);
+        writer.EndObject();
+
+        writer.Key("results");
+        writer.StartArray();
+
+        for (const auto &result : m_results)
+        {
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(result.name.c_str());
+            writer.Key("threads");
+            writer.Uint64(result.threads);
+            writer.Key("samples");
+            writer.Uint64(result.samples);
+            writer.Key("operationsPerSample");
+            writer.Uint64(result.operationsPerSample);
+            writer.Key("minNanoseconds");
+            writer.Double(result.minNanoseconds);
+            writer.Key("medianNanoseconds");
+            writer.Double(result.medianNanoseconds);
+            writer.Key("p99Nanoseconds");
+            writer.Double(result.p99Nanoseconds);
+            writer.Key("maxNanoseconds");
+            writer.Double(result.maxNanoseconds);
+            writer.Key("operationsPerSecond");
+            writer.Double(result.operationsPerSecond);
+            writer.Key("scalingEfficiency");
+            writer.Double(result.scalingEfficiency);
+            writer.EndObject();
+        }
+
+        writer.EndArray();
+
+        writer.EndObject();
+    }
+
+    std::vector<size_t> getScalingThreadCounts(const size_t maxThreads)
+    {
+        std::vector<size_t> threadCounts;
+
+        for (size_t threads = 1; threads < maxThreads; threads *= 2)
+        {
+            threadCounts.push_back(threads);
+        }
+
+        threadCounts.push_back(std::max<size_t>(maxThreads, 1));
+
+        return threadCounts;
+    }
+} // namespace Benchmark
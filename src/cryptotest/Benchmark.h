@@ -0,0 +1,92 @@
+// Copyright (c) 2018-2019, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+    struct BenchmarkOptions
+    {
+        /* How many timed samples to take of each benchmark, per thread */
+        size_t samples = 30;
+
+        /* How many untimed samples each thread runs before the timed ones, so
+           caches, scratchpads and CPU frequency have settled */
+        size_t warmupSamples = 3;
+
+        /* How long each sample should take. The operations per sample are
+           calibrated to this, so fast and slow operations get similar accuracy */
+        uint64_t sampleMilliseconds = 100;
+
+        /* The thread counts to run each benchmark with */
+        std::vector<size_t> threadCounts = {1};
+    };
+
+    struct BenchmarkResult
+    {
+        std::string name;
+
+        size_t threads;
+
+        /* The timed samples, across all threads */
+        size_t samples;
+
+        uint64_t operationsPerSample;
+
+        /* Per operation timings of the samples, in nanoseconds */
+        double minNanoseconds;
+        double medianNanoseconds;
+        double p99Nanoseconds;
+        double maxNanoseconds;
+
+        /* Operations per second across all threads, at the median timing */
+        double operationsPerSecond;
+
+        /* operationsPerSecond as a fraction of threads times the single
+           threaded operationsPerSecond. 1 is perfect scaling. */
+        double scalingEfficiency;
+    };
+
+    /* An operation to benchmark. Called with how many times this thread has
+       called it, so the work can't be optimized away between calls. Must be
+       safe to call from several threads at once. */
+    typedef std::function<void(uint64_t iteration)> Operation;
+
+    class BenchmarkSuite
+    {
+      public:
+        BenchmarkSuite(const BenchmarkOptions &options);
+
+        /* Runs the operation with each of the thread counts, and prints and
+           records the results */
+        void run(const std::string &name, const Operation &operation);
+
+        const std::vector<BenchmarkResult> &getResults() const;
+
+        /* Writes the results and the machine they were taken on as JSON */
+        void writeJSON(const std::string &filename) const;
+
+      private:
+        /* Picks how many operations make up a sample of about sampleMilliseconds */
+        uint64_t calibrate(const Operation &operation) const;
+
+        BenchmarkResult runWithThreads(
+            const std::string &name,
+            const Operation &operation,
+            size_t threads,
+            uint64_t operationsPerSample) const;
+
+        BenchmarkOptions m_options;
+
+        std::vector<BenchmarkResult> m_results;
+    };
+
+    /* 1, 2, 4... up to and including maxThreads */
+    std::vector<size_t> getScalingThreadCounts(size_t maxThreads);
+} // namespace Benchmark
@@ -7,15 +7,16 @@
 #include "common/StringTools.h"
 #include "crypto/crypto.h"
 #include "crypto/multisig.h"
+#include "cryptonotecore/KeyImageFilter.h"
+#include "cryptotest/Benchmark.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <chrono>
 #include <config/CliHeader.h>
 #include <cxxopts.hpp>
 #include <iostream>
-
-#define PERFORMANCE_ITERATIONS 1000
-#define PERFORMANCE_ITERATIONS_LONG_MULTIPLIER 10
+#include <thread>
 
 using namespace Crypto;
 using namespace CryptoNote;
@@ -189,93 +190,158 @@ void testHashFunction(
 
 /* Bit of hackery so we can get the variable name of the passed in function.
    This way we can print the test we are currently performing. */
-#define BENCHMARK(hashFunction, iterations) benchmark(hashFunction, #hashFunction, iterations)
+#define BENCHMARK(suite, hashFunction) benchmarkHashFunction(suite, hashFunction, #hashFunction)
 
-template<typename T> void benchmark(T hashFunction, std::string hashFunctionName, uint64_t iterations)
+template<typename T>
+void benchmarkHashFunction(Benchmark::BenchmarkSuite &suite, T hashFunction, std::string hashFunctionName)
 {
-    const BinaryArray &rawData = Common::fromHex(INPUT_DATA);
+    const BinaryArray rawData = Common::fromHex(INPUT_DATA);
 
     if (need43BytesOfData(hashFunctionName) && rawData.size() < 43)
     {
         return;
     }
 
-    Hash hash = Hash();
+    suite.run(hashFunctionName, [&rawData, hashFunction](uint64_t) {
+        Hash hash;
+        hashFunction(rawData.data(), rawData.size(), hash);
+    });
+}
 
-    auto startTimer = std::chrono::high_resolution_clock::now();
+void printPointCacheStatistics(const std::string &name, const Crypto::PointCacheStatistics &statistics)
+{
+    const uint64_t lookups = statistics.hits + statistics.misses;
 
-    for (uint64_t i = 0; i < iterations; i++)
+    std::cout << name << ": " << statistics.hits << " hits, " << statistics.misses << " misses";
+
+    if (lookups != 0)
     {
-        hashFunction(rawData.data(), rawData.size(), hash);
+        std::cout << " (" << (statistics.hits * 100 / lookups) << "% hit rate)";
     }
 
-    auto elapsedTime = std::chrono::high_resolution_clock::now() - startTimer;
-
-    std::cout << hashFunctionName << ": "
-              << (iterations / std::chrono::duration_cast<std::chrono::seconds>(elapsedTime).count()) << " H/s\n";
+    std::cout << ", " << statistics.evictions << " evictions, " << statistics.size << " cached" << std::endl;
 }
 
-void benchmarkUnderivePublicKey()
+void benchmarkKeyOperations(Benchmark::BenchmarkSuite &suite)
 {
-    Crypto::KeyDerivation derivation;
-
     Crypto::PublicKey txPublicKey;
     Common::podFromHex("f235acd76ee38ec4f7d95123436200f9ed74f9eb291b1454fbc30742481be1ab", txPublicKey);
 
     Crypto::SecretKey privateViewKey;
     Common::podFromHex("89df8c4d34af41a51cfae0267e8254cadd2298f9256439fa1cfa7e25ee606606", privateViewKey);
 
+    Crypto::KeyDerivation derivation;
     Crypto::generate_key_derivation(txPublicKey, privateViewKey, derivation);
 
-    const uint64_t loopIterations = 600000;
+    Crypto::PublicKey outputKey;
+    Common::podFromHex("4a078e76cd41a3d3b534b83dc6f2ea2de500b653ca82273b7bfad8045d85a400", outputKey);
 
-    auto startTimer = std::chrono::high_resolution_clock::now();
+    Crypto::PublicKey publicSpendKey;
+    Crypto::SecretKey privateSpendKey;
+    Crypto::generate_keys(publicSpendKey, privateSpendKey);
+
+    suite.run("generateKeyDerivation", [&](uint64_t) {
+        Crypto::KeyDerivation result;
+        Crypto::generate_key_derivation(txPublicKey, privateViewKey, result);
+    });
+
+    /* Use the iteration as the output index to prevent optimization */
+    suite.run("derivePublicKey", [&](uint64_t iteration) {
+        Crypto::PublicKey result;
+        Crypto::derive_public_key(derivation, iteration, publicSpendKey, result);
+    });
+
+    suite.run("underivePublicKey", [&](uint64_t iteration) {
+        Crypto::PublicKey result;
+        Crypto::underive_public_key(derivation, iteration, outputKey, result);
+    });
+
+    suite.run("generateKeyImage", [&](uint64_t) {
+        Crypto::KeyImage result;
+        Crypto::generate_key_image(publicSpendKey, privateSpendKey, result);
+    });
+}
 
-    Crypto::PublicKey spendKey;
+void benchmarkRingSignatures(Benchmark::BenchmarkSuite &suite)
+{
+    Crypto::Hash txPrefixHash;
+    Common::podFromHex("b542df5b6e7f5f05275c98e7345884e2ac726aeeb07e03e44e0389eb86cd05f0", txPrefixHash);
 
-    Crypto::PublicKey outputKey;
-    Common::podFromHex("4a078e76cd41a3d3b534b83dc6f2ea2de500b653ca82273b7bfad8045d85a400", outputKey);
+    Crypto::KeyImage keyImage("6865866ed8a25824e042e21dd36e946836b58b03366e489aecf979f444f599b0");
 
-    for (uint64_t i = 0; i < loopIterations; i++)
-    {
-        /* Use i as output index to prevent optimization */
-        Crypto::underive_public_key(derivation, i, outputKey, spendKey);
-    }
+    const std::vector<Crypto::PublicKey> publicKeys {
+        Crypto::PublicKey("492390897da1cabd3886e3eff43ad1d04aa510a905bec0acd31a0a2f260e7862"),
+        Crypto::PublicKey("7644ccb5410cca2be18b033e5f7497aeeeafd1d8f317f29cba4803e4306aa402"),
+        Crypto::PublicKey("bb9a956ffdf8159ad69474e6b0811316c44a17a540d5e39a44642d4d933a6460"),
+        Crypto::PublicKey("e1cd9ccdfdf2b3a45ac2cfd1e29185d22c185742849f52368c3cdd1c0ce499c0")};
+
+    Crypto::SecretKey privateEmpheremal("73a8e577d58f7c11992201d4014ac7eef39c1e9f6f6d78673103de60a0c3240b");
+
+    const std::string ringSize = " (ring size " + std::to_string(publicKeys.size()) + ")";
 
-    auto elapsedTime = std::chrono::high_resolution_clock::now() - startTimer;
+    suite.run("generateRingSignatures" + ringSize, [&](uint64_t) {
+        Crypto::crypto_ops::generateRingSignatures(txPrefixHash, keyImage, publicKeys, privateEmpheremal, 3);
+    });
 
-    /* Need to use microseconds here then divide by 1000 - otherwise we'll just get '0' */
-    const auto timePerDerivation =
-        std::chrono::duration_cast<std::chrono::microseconds>(elapsedTime).count() / loopIterations;
+    const auto [success, signatures] =
+        Crypto::crypto_ops::generateRingSignatures(txPrefixHash, keyImage, publicKeys, privateEmpheremal, 3);
 
-    std::cout << "Time to perform underivePublicKey: " << timePerDerivation / 1000.0 << " ms" << std::endl;
+    /* Every ring member is decompressed and hashed to a point again, as for
+       ring members the node hasn't seen recently. Clearing the caches while
+       they hold a single ring costs little next to the check itself. */
+    suite.run("checkRingSignature" + ringSize + " cold", [&, &signatures = signatures](uint64_t) {
+        Crypto::crypto_ops::clearPointCaches();
+        Crypto::crypto_ops::checkRingSignature(txPrefixHash, keyImage, publicKeys, signatures);
+    });
+
+    /* Start from an empty cache, so the statistics only cover the warm run */
+    Crypto::crypto_ops::clearPointCaches();
+
+    /* The same ring every time, so every point comes from the caches, as for
+       block transactions whose ring members were seen in the pool */
+    suite.run("checkRingSignature" + ringSize + " warm", [&, &signatures = signatures](uint64_t) {
+        Crypto::crypto_ops::checkRingSignature(txPrefixHash, keyImage, publicKeys, signatures);
+    });
+
+    const auto [decompressed, hashed] = Crypto::crypto_ops::getPointCacheStatistics();
+
+    printPointCacheStatistics("Decompressed point cache", decompressed);
+    printPointCacheStatistics("Hashed point cache", hashed);
 }
 
-void benchmarkGenerateKeyDerivation()
+void runBenchmarks(Benchmark::BenchmarkSuite &suite)
 {
-    Crypto::KeyDerivation derivation;
+    benchmarkKeyOperations(suite);
+    benchmarkRingSignatures(suite);
 
-    Crypto::PublicKey txPublicKey;
-    Common::podFromHex("f235acd76ee38ec4f7d95123436200f9ed74f9eb291b1454fbc30742481be1ab", txPublicKey);
+    std::cout << std::endl;
 
-    Crypto::SecretKey privateViewKey;
-    Common::podFromHex("89df8c4d34af41a51cfae0267e8254cadd2298f9256439fa1cfa7e25ee606606", privateViewKey);
+    BENCHMARK(suite, cn_slow_hash_v0);
+    BENCHMARK(suite, cn_slow_hash_v1);
+    BENCHMARK(suite, cn_slow_hash_v2);
 
-    const uint64_t loopIterations = 60000;
+    BENCHMARK(suite, cn_lite_slow_hash_v0);
+    BENCHMARK(suite, cn_lite_slow_hash_v1);
+    BENCHMARK(suite, cn_lite_slow_hash_v2);
 
-    auto startTimer = std::chrono::high_resolution_clock::now();
+    BENCHMARK(suite, cn_dark_slow_hash_v0);
+    BENCHMARK(suite, cn_dark_slow_hash_v1);
+    BENCHMARK(suite, cn_dark_slow_hash_v2);
 
-    for (uint64_t i = 0; i < loopIterations; i++)
-    {
-        Crypto::generate_key_derivation(txPublicKey, privateViewKey, derivation);
-    }
+    BENCHMARK(suite, cn_dark_lite_slow_hash_v0);
+    BENCHMARK(suite, cn_dark_lite_slow_hash_v1);
+    BENCHMARK(suite, cn_dark_lite_slow_hash_v2);
 
-    auto elapsedTime = std::chrono::high_resolution_clock::now() - startTimer;
+    BENCHMARK(suite, cn_turtle_slow_hash_v0);
+    BENCHMARK(suite, cn_turtle_slow_hash_v1);
+    BENCHMARK(suite, cn_turtle_slow_hash_v2);
 
-    const auto timePerDerivation =
-        std::chrono::duration_cast<std::chrono::microseconds>(elapsedTime).count() / loopIterations;
+    BENCHMARK(suite, cn_turtle_lite_slow_hash_v0);
+    BENCHMARK(suite, cn_turtle_lite_slow_hash_v1);
+    BENCHMARK(suite, cn_turtle_lite_slow_hash_v2);
 
-    std::cout << "Time to perform generateKeyDerivation: " << timePerDerivation / 1000.0 << " ms" << std::endl;
+    BENCHMARK(suite, chukwa_slow_hash_v1);
+    BENCHMARK(suite, chukwa_slow_hash_v2);
 }
 
 void TestDeterministicSubwalletCreation(
@@ -316,7 +382,8 @@ void TestDeterministicSubwalletCreation(
 int main(int argc, char **argv)
 {
     bool o_help, o_version, o_benchmark;
-    int o_iterations;
+    size_t o_samples, o_warmup, o_sample_time, o_threads;
+    std::string o_json;
 
     cxxopts::Options options(argv[0], getProjectCLIHeader());
 
@@ -328,12 +395,28 @@ int main(int argc, char **argv)
 
     options.add_options("Performance Testing")(
         "b,benchmark",
-        "Run quick performance benchmark",
+        "Run performance benchmarks",
         cxxopts::value<bool>(o_benchmark)->default_value("false")->implicit_value("true"))(
-        "i,iterations",
-        "The number of iterations for the benchmark test. Minimum of 1,000 iterations required.",
-        cxxopts::value<int>(o_iterations)->default_value(std::to_string(PERFORMANCE_ITERATIONS)),
-        "#");
+        "samples",
+        "The number of timed samples to take of each benchmark, per thread",
+        cxxopts::value<size_t>(o_samples)->default_value("30"),
+        "#")(
+        "warmup",
+        "The number of untimed samples to run before the timed ones",
+        cxxopts::value<size_t>(o_warmup)->default_value("3"),
+        "#")(
+        "sample-time",
+        "How long each sample should take, in milliseconds",
+        cxxopts::value<size_t>(o_sample_time)->default_value("100"),
+        "#")(
+        "threads",
+        "Run each benchmark with 1, 2, 4... up to this many threads, to measure scaling",
+        cxxopts::value<size_t>(o_threads)->default_value(std::to_string(std::thread::hardware_concurrency())),
+        "#")(
+        "json",
+        "Also write the benchmark results as JSON to this file",
+        cxxopts::value<std::string>(o_json),
+        "<file>");
 
     try
     {
@@ -357,14 +440,18 @@ int main(int argc, char **argv)
         exit(0);
     }
 
-    if (o_iterations < 1000 && o_benchmark)
+    if (o_benchmark && (o_samples == 0 || o_sample_time == 0 || o_threads == 0))
     {
-        std::cout << std::endl
-                  << "Error: The number of --iterations should be at least 1,000 for reasonable accuracy" << std::endl;
+        std::cout << std::endl << "Error: --samples, --sample-time and --threads must be at least 1" << std::endl;
         exit(1);
     }
 
-    int o_iterations_long = o_iterations * PERFORMANCE_ITERATIONS_LONG_MULTIPLIER;
+    Benchmark::BenchmarkOptions benchmarkOptions;
+
+    benchmarkOptions.samples = o_samples;
+    benchmarkOptions.warmupSamples = o_warmup;
+    benchmarkOptions.sampleMilliseconds = o_sample_time;
+    benchmarkOptions.threadCounts = Benchmark::getScalingThreadCounts(o_threads);
 
     try
     {
@@ -449,6 +536,173 @@ int main(int argc, char **argv)
             std::cout << "passed" << std::endl;
         }
 
+        {
+            std::cout << "Crypto::crypto_ops::checkRingSignatures: ";
+
+            struct Ring
+            {
+                Crypto::Hash prefixHash;
+
+                Crypto::KeyImage keyImage;
+
+                std::vector<Crypto::PublicKey> publicKeys;
+
+                std::vector<Crypto::Signature> signatures;
+            };
+
+            std::vector<Ring> rings(5);
+
+            for (uint64_t i = 0; i < rings.size(); i++)
+            {
+                Ring &ring = rings[i];
+
+                ring.prefixHash = Crypto::cn_fast_hash(&i, sizeof(i));
+
+                Crypto::PublicKey publicKey;
+                Crypto::SecretKey secretKey;
+
+                Crypto::generate_keys(publicKey, secretKey);
+                Crypto::generate_key_image(publicKey, secretKey, ring.keyImage);
+
+                ring.publicKeys.resize(4);
+
+                for (auto &decoy : ring.publicKeys)
+                {
+                    Crypto::SecretKey decoySecretKey;
+                    Crypto::generate_keys(decoy, decoySecretKey);
+                }
+
+                /* Move the real output around the ring */
+                const uint64_t realOutput = i % ring.publicKeys.size();
+
+                ring.publicKeys[realOutput] = publicKey;
+
+                bool success;
+
+                std::tie(success, ring.signatures) = Crypto::crypto_ops::generateRingSignatures(
+                    ring.prefixHash, ring.keyImage, ring.publicKeys, secretKey, realOutput);
+
+                if (!success)
+                {
+                    std::cout << "failed" << std::endl;
+
+                    exit(1);
+                }
+            }
+
+            /* Not a point on the curve */
+            const Crypto::PublicKey invalidKey("0200000000000000000000000000000000000000000000000000000000000000");
+
+            std::vector<Ring> badSignature = rings;
+            reinterpret_cast<unsigned char *>(&badSignature[1].signatures[2])[0] ^= 1;
+
+            std::vector<Ring> badKeyImage = rings;
+            badKeyImage[2].keyImage = *reinterpret_cast<const Crypto::KeyImage *>(&invalidKey);
+
+            std::vector<Ring> badPublicKey = rings;
+            badPublicKey[3].publicKeys[0] = invalidKey;
+
+            const std::vector<std::tuple<std::vector<Ring>, std::vector<bool>>> batches = {
+                {rings, {true, true, true, true, true}},
+                {badSignature, {true, false, true, true, true}},
+                {badKeyImage, {true, true, false, true, true}},
+                {badPublicKey, {true, true, true, false, true}},
+            };
+
+            for (const auto &[batch, expected] : batches)
+            {
+                std::vector<Crypto::RingSignatureToCheck> ringSignatures;
+
+                for (const auto &ring : batch)
+                {
+                    ringSignatures.push_back({ring.prefixHash, ring.keyImage, ring.publicKeys, ring.signatures});
+                }
+
+                std::vector<bool> results;
+
+                const bool allValid = Crypto::crypto_ops::checkRingSignatures(ringSignatures, results);
+
+                bool expectedAllValid = true;
+
+                for (size_t i = 0; i < batch.size(); i++)
+                {
+                    const bool valid = Crypto::crypto_ops::checkRingSignature(
+                        batch[i].prefixHash, batch[i].keyImage, batch[i].publicKeys, batch[i].signatures);
+
+                    if (results.size() != batch.size() || results[i] != valid || valid != expected[i])
+                    {
+                        std::cout << "failed" << std::endl;
+
+                        exit(1);
+                    }
+
+                    expectedAllValid = expectedAllValid && valid;
+                }
+
+                if (allValid != expectedAllValid)
+                {
+                    std::cout << "failed" << std::endl;
+
+                    exit(1);
+                }
+            }
+
+            std::cout << "passed" << std::endl;
+        }
+
+        {
+            std::cout << "Crypto::crypto_ops::generateKeyDerivations: ";
+
+            std::vector<Crypto::PublicKey> publicKeys(8);
+
+            for (auto &publicKey : publicKeys)
+            {
+                Crypto::SecretKey secretKey;
+                Crypto::generate_keys(publicKey, secretKey);
+            }
+
+            /* Not a point on the curve, in the middle so the keys after it
+               still have to come out right */
+            publicKeys[3] = Crypto::PublicKey("0200000000000000000000000000000000000000000000000000000000000000");
+
+            Crypto::PublicKey viewPublicKey;
+            Crypto::SecretKey viewSecretKey;
+
+            Crypto::generate_keys(viewPublicKey, viewSecretKey);
+
+            std::vector<Crypto::KeyDerivation> derivations;
+            std::vector<bool> results;
+
+            const bool allValid =
+                Crypto::crypto_ops::generateKeyDerivations(publicKeys, viewSecretKey, derivations, results);
+
+            if (allValid || derivations.size() != publicKeys.size() || results.size() != publicKeys.size())
+            {
+                std::cout << "failed" << std::endl;
+
+                exit(1);
+            }
+
+            for (size_t i = 0; i < publicKeys.size(); i++)
+            {
+                /* generate_key_derivation leaves the derivation alone when the
+                   key is invalid, where the batch zeroes it */
+                Crypto::KeyDerivation derivation;
+                std::fill(std::begin(derivation.data), std::end(derivation.data), 0);
+
+                const bool success = Crypto::generate_key_derivation(publicKeys[i], viewSecretKey, derivation);
+
+                if (results[i] != success || results[i] != (i != 3) || !(derivations[i] == derivation))
+                {
+                    std::cout << "failed" << std::endl;
+
+                    exit(1);
+                }
+            }
+
+            std::cout << "passed" << std::endl;
+        }
+
         {
             std::cout << "Crypto::generate_deterministic_subwallet_keys: ";
 
@@ -663,6 +917,164 @@ int main(int argc, char **argv)
             std::cout << "passed" << std::endl;
         }
 
+        {
+            std::cout << "Crypto::cn_fast_hash_multi: ";
+
+            /* Messages spanning zero to several Keccak blocks, so the
+               multi-buffer lanes finish at different times */
+            std::vector<std::vector<uint8_t>> messages;
+
+            for (size_t length = 0; length < 600; length += 23)
+            {
+                std::vector<uint8_t> message(length);
+
+                for (size_t i = 0; i < length; i++)
+                {
+                    message[i] = static_cast<uint8_t>(i * 7 + length);
+                }
+
+                messages.push_back(message);
+            }
+
+            std::vector<const void *> data;
+            std::vector<size_t> lengths;
+
+            for (const auto &message : messages)
+            {
+                data.push_back(message.data());
+                lengths.push_back(message.size());
+            }
+
+            std::vector<Crypto::Hash> hashes(messages.size());
+
+            Crypto::cn_fast_hash_multi(
+                data.data(), lengths.data(), data.size(), reinterpret_cast<char *>(hashes.data()));
+
+            for (size_t i = 0; i < messages.size(); i++)
+            {
+                if (hashes[i] != Crypto::cn_fast_hash(messages[i].data(), messages[i].size()))
+                {
+                    std::cout << "failed" << std::endl;
+
+                    exit(1);
+                }
+            }
+
+            std::cout << "passed" << std::endl;
+        }
+
+        {
+            /* Seven inputs, so they're hashed four, two and one at a time */
+            std::vector<BinaryArray> inputs(7, Common::fromHex(INPUT_DATA));
+            std::vector<const void *> data;
+
+            for (size_t i = 0; i < inputs.size(); i++)
+            {
+                /* Vary the nonce, like the miner does */
+                inputs[i][39] = static_cast<uint8_t>(i);
+                data.push_back(inputs[i].data());
+            }
+
+            const std::tuple<
+                std::string,
+                void (*)(const void *, size_t, Hash &),
+                void (*)(const void *const *, size_t, Hash *, size_t)>
+                multiHashFunctions[] = {
+                    {"Crypto::cn_lite_slow_hash_v1_multi", cn_lite_slow_hash_v1, cn_lite_slow_hash_v1_multi},
+                    {"Crypto::cn_turtle_lite_slow_hash_v2_multi",
+                     cn_turtle_lite_slow_hash_v2,
+                     cn_turtle_lite_slow_hash_v2_multi},
+                };
+
+            for (const auto &[name, hashFunction, multiHashFunction] : multiHashFunctions)
+            {
+                std::cout << name << ": ";
+
+                std::vector<Hash> hashes(inputs.size());
+
+                multiHashFunction(data.data(), inputs[0].size(), hashes.data(), inputs.size());
+
+                for (size_t i = 0; i < inputs.size(); i++)
+                {
+                    Hash hash;
+
+                    hashFunction(inputs[i].data(), inputs[i].size(), hash);
+
+                    if (hashes[i] != hash)
+                    {
+                        std::cout << "failed" << std::endl;
+
+                        exit(1);
+                    }
+                }
+
+                std::cout << "passed" << std::endl;
+            }
+        }
+
+        {
+            std::cout << "CryptoNote::KeyImageFilter: ";
+
+            /* Four times what the filter is sized for, as happens when a node
+               runs long enough without rebuilding it */
+            const uint64_t capacity = 1000;
+
+            std::vector<Crypto::KeyImage> keyImages;
+
+            for (uint64_t i = 0; i < capacity * 4; i++)
+            {
+                Crypto::Hash hash = Crypto::cn_fast_hash(&i, sizeof(i));
+
+                keyImages.push_back(*reinterpret_cast<Crypto::KeyImage *>(&hash));
+            }
+
+            CryptoNote::KeyImageFilter filter(capacity);
+
+            for (size_t i = 0; i < keyImages.size(); i++)
+            {
+                filter.insert(keyImages[i]);
+
+                if (filter.isOverfull() != (i + 1 > capacity))
+                {
+                    std::cout << "failed" << std::endl;
+
+                    exit(1);
+                }
+            }
+
+            /* Rebuilt the way DatabaseBlockchainCache does once it's overfull */
+            CryptoNote::KeyImageFilter regrown(std::max<uint64_t>(keyImages.size() * 2, filter.getCapacity() * 2));
+
+            for (const auto &keyImage : keyImages)
+            {
+                regrown.insert(keyImage);
+            }
+
+            CryptoNote::KeyImageFilter deserialized;
+
+            if (regrown.isOverfull() || !deserialized.deserialize(filter.serialize()))
+            {
+                std::cout << "failed" << std::endl;
+
+                exit(1);
+            }
+
+            /* Past capacity there are more false positives, but never a false
+               negative, which would let a key image be spent twice */
+            for (const auto &keyImage : keyImages)
+            {
+                if (!filter.mightContain(keyImage) || !regrown.mightContain(keyImage)
+                    || !deserialized.mightContain(keyImage))
+                {
+                    std::cout << "failed" << std::endl;
+
+                    exit(1);
+                }
+            }
+
+            std::cout << "passed" << std::endl;
+        }
+
         std::cout << std::endl << "Input: " << INPUT_DATA << std::endl << std::endl;
 
         TEST_HASH_FUNCTION(cn_slow_hash_v0, CN_SLOW_HASH_V0);
@@ -729,35 +1141,29 @@ int main(int argc, char **argv)
         {
             std::cout << "\nPerformance Tests: Please wait, this may take a while depending on your system...\n\n";
 
-            benchmarkUnderivePublicKey();
-            benchmarkGenerateKeyDerivation();
+            /* Allocate the hashing memory up front so it isn't included in the first timings */
+            Crypto::HashingContext::reserve();
 
-            BENCHMARK(cn_slow_hash_v0, o_iterations);
-            BENCHMARK(cn_slow_hash_v1, o_iterations);
-            BENCHMARK(cn_slow_hash_v2, o_iterations);
+            std::cout << "Huge pages: " << (Crypto::HashingContext::usingHugePages() ? "enabled" : "disabled")
+                      << "\n";
 
-            BENCHMARK(cn_lite_slow_hash_v0, o_iterations);
-            BENCHMARK(cn_lite_slow_hash_v1, o_iterations);
-            BENCHMARK(cn_lite_slow_hash_v2, o_iterations);
+            for (const auto &[name, implementation] : Crypto::getHashImplementations())
+            {
+                std::cout << name << ": " << implementation << "\n";
+            }
 
-            BENCHMARK(cn_dark_slow_hash_v0, o_iterations);
-            BENCHMARK(cn_dark_slow_hash_v1, o_iterations);
-            BENCHMARK(cn_dark_slow_hash_v2, o_iterations);
+            std::cout << "\n";
 
-            BENCHMARK(cn_dark_lite_slow_hash_v0, o_iterations);
-            BENCHMARK(cn_dark_lite_slow_hash_v1, o_iterations);
-            BENCHMARK(cn_dark_lite_slow_hash_v2, o_iterations);
+            Benchmark::BenchmarkSuite suite(benchmarkOptions);
 
-            BENCHMARK(cn_turtle_slow_hash_v0, o_iterations_long);
-            BENCHMARK(cn_turtle_slow_hash_v1, o_iterations_long);
-            BENCHMARK(cn_turtle_slow_hash_v2, o_iterations_long);
+            runBenchmarks(suite);
 
-            BENCHMARK(cn_turtle_lite_slow_hash_v0, o_iterations_long);
-            BENCHMARK(cn_turtle_lite_slow_hash_v1, o_iterations_long);
-            BENCHMARK(cn_turtle_lite_slow_hash_v2, o_iterations_long);
+            if (!o_json.empty())
+            {
+                suite.writeJSON(o_json);
 
-            BENCHMARK(chukwa_slow_hash_v1, o_iterations_long);
-            BENCHMARK(chukwa_slow_hash_v2, o_iterations_long);
+                std::cout << "\nWrote results to " << o_json << std::endl;
+            }
         }
     }
     catch (std::exception &e)
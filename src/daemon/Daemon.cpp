@@ -283,6 +283,13 @@ int main(int argc, char *argv[])
 
         logger(INFO) << "Program Working Directory: " << cwdPath;
 
+        /* Pick the hashing implementations for this CPU up front, rather than
+           on the first block we hash */
+        for (const auto &[name, implementation] : Crypto::getHashImplementations())
+        {
+            logger(INFO) << name << ": " << implementation;
+        }
+
         // create objects and link them
         CryptoNote::CurrencyBuilder currencyBuilder(logManager);
         currencyBuilder.isBlockexplorer(config.enableBlockExplorer);
@@ -306,7 +313,12 @@ int main(int argc, char *argv[])
             config.dbWriteBufferSizeMB,
             config.dbReadCacheSizeMB,
             config.dbMaxFileSizeMB,
-            config.enableDbCompression
+            config.enableDbCompression,
+            config.dbKeyImageCacheSizeMB,
+            config.dbRawBlockCacheSizeMB,
+            config.dbRawBlockBlockSizeKB,
+            config.dbBloomBitsPerKey,
+            config.enableDbBlobFiles
         );
 
         /* If we were told to rewind the blockchain to a certain height
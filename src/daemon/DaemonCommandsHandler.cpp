@@ -7,6 +7,7 @@
 #include "JsonHelper.h"
 
 #include <boost/format.hpp>
+#include <crypto/hash.h>
 #include <cryptonotecore/Core.h>
 #include <cryptonotecore/CryptoNoteFormatUtils.h>
 #include <cryptonotecore/Currency.h>
@@ -407,6 +408,11 @@ bool DaemonCommandsHandler::status(const std::vector<std::string> &args)
     statusTable.push_back({"DB Engine",             m_config.enableLevelDB ? "LevelDB" : "RocksDB"});
     statusTable.push_back({"Version", PROJECT_VERSION});
 
+    for (const auto &[name, implementation] : Crypto::getHashImplementations())
+    {
+        statusTable.push_back({name, implementation});
+    }
+
     size_t longestValue = 0;
     size_t longestDescription = 0;
 
@@ -175,6 +175,9 @@ namespace DaemonConfig
             ("db-enable-compression",
              "Enable database compression",
              cxxopts::value<bool>()->default_value("false")->implicit_value("true"))
+            ("db-enable-blob-files",
+             "Store raw blocks in blob files (RocksDB only)",
+             cxxopts::value<bool>()->default_value("false")->implicit_value("true"))
             ("db-max-open-files",
              "Number of files that can be used by the database at one time " + maxOpenFiles,
              cxxopts::value<int>(),
@@ -194,6 +197,22 @@ namespace DaemonConfig
             ("db-max-file-size",
              "Max file size of database files in megabytes (MB) (LevelDB only)",
              cxxopts::value<int>()->default_value(std::to_string(CryptoNote::LEVELDB_MAX_FILE_SIZE_MB)),
+             "#")
+            ("db-key-image-cache-size",
+             "Size of the read cache for spent key images in megabytes (MB) (RocksDB only)",
+             cxxopts::value<int>()->default_value(std::to_string(CryptoNote::ROCKSDB_KEY_IMAGE_CACHE_MB)),
+             "#")
+            ("db-raw-block-cache-size",
+             "Size of the read cache for raw blocks in megabytes (MB) (RocksDB only)",
+             cxxopts::value<int>()->default_value(std::to_string(CryptoNote::ROCKSDB_RAW_BLOCK_CACHE_MB)),
+             "#")
+            ("db-raw-block-block-size",
+             "Size of the table blocks raw blocks are stored in, in kilobytes (KB) (RocksDB only)",
+             cxxopts::value<int>()->default_value(std::to_string(CryptoNote::ROCKSDB_RAW_BLOCK_BLOCK_SIZE_KB)),
+             "#")
+            ("db-bloom-bits-per-key",
+             "Bloom filter bits per key for hash lookups, 0 to disable (RocksDB only)",
+             cxxopts::value<int>()->default_value(std::to_string(CryptoNote::ROCKSDB_BLOOM_BITS_PER_KEY)),
              "#");
 
         options.add_options("Syncing")(
@@ -283,6 +302,11 @@ namespace DaemonConfig
                 config.enableDbCompression = cli["db-enable-compression"].as<bool>();
             }
 
+            if (cli.count("db-enable-blob-files") > 0)
+            {
+                config.enableDbBlobFiles = cli["db-enable-blob-files"].as<bool>();
+            }
+
             if (cli.count("no-console") > 0)
             {
                 config.noConsole = cli["no-console"].as<bool>();
@@ -331,6 +355,26 @@ namespace DaemonConfig
                 config.dbMaxFileSizeMB = cli["db-max-file-size"].as<int>();
             }
 
+            if (cli.count("db-key-image-cache-size") > 0)
+            {
+                config.dbKeyImageCacheSizeMB = cli["db-key-image-cache-size"].as<int>();
+            }
+
+            if (cli.count("db-raw-block-cache-size") > 0)
+            {
+                config.dbRawBlockCacheSizeMB = cli["db-raw-block-cache-size"].as<int>();
+            }
+
+            if (cli.count("db-raw-block-block-size") > 0)
+            {
+                config.dbRawBlockBlockSizeKB = cli["db-raw-block-block-size"].as<int>();
+            }
+
+            if (cli.count("db-bloom-bits-per-key") > 0)
+            {
+                config.dbBloomBitsPerKey = cli["db-bloom-bits-per-key"].as<int>();
+            }
+
             if (cli.count("local-ip") > 0)
             {
                 config.localIp = cli["local-ip"].as<bool>();
@@ -517,6 +561,11 @@ namespace DaemonConfig
                     config.enableDbCompression = cfgValue.at(0) == '1';
                     updated = true;
                 }
+                else if (cfgKey.compare("db-enable-blob-files") == 0)
+                {
+                    config.enableDbBlobFiles = cfgValue.at(0) == '1';
+                    updated = true;
+                }
                 else if (cfgKey.compare("no-console") == 0)
                 {
                     config.noConsole = cfgValue.at(0) == '1';
@@ -570,6 +619,54 @@ namespace DaemonConfig
                         throw std::runtime_error(std::string(e.what()) + " - Invalid value for " + cfgKey);
                     }
                 }
+                else if (cfgKey.compare("db-key-image-cache-size") == 0)
+                {
+                    try
+                    {
+                        config.dbKeyImageCacheSizeMB = std::stoi(cfgValue);
+                        updated = true;
+                    }
+                    catch (std::exception &e)
+                    {
+                        throw std::runtime_error(std::string(e.what()) + " - Invalid value for " + cfgKey);
+                    }
+                }
+                else if (cfgKey.compare("db-raw-block-cache-size") == 0)
+                {
+                    try
+                    {
+                        config.dbRawBlockCacheSizeMB = std::stoi(cfgValue);
+                        updated = true;
+                    }
+                    catch (std::exception &e)
+                    {
+                        throw std::runtime_error(std::string(e.what()) + " - Invalid value for " + cfgKey);
+                    }
+                }
+                else if (cfgKey.compare("db-raw-block-block-size") == 0)
+                {
+                    try
+                    {
+                        config.dbRawBlockBlockSizeKB = std::stoi(cfgValue);
+                        updated = true;
+                    }
+                    catch (std::exception &e)
+                    {
+                        throw std::runtime_error(std::string(e.what()) + " - Invalid value for " + cfgKey);
+                    }
+                }
+                else if (cfgKey.compare("db-bloom-bits-per-key") == 0)
+                {
+                    try
+                    {
+                        config.dbBloomBitsPerKey = std::stoi(cfgValue);
+                        updated = true;
+                    }
+                    catch (std::exception &e)
+                    {
+                        throw std::runtime_error(std::string(e.what()) + " - Invalid value for " + cfgKey);
+                    }
+                }
                 else if (cfgKey.compare("allow-local-ip") == 0)
                 {
                     config.localIp = cfgValue.at(0) == '1';
@@ -790,6 +887,11 @@ namespace DaemonConfig
             config.enableDbCompression = j["db-enable-compression"].GetBool();
         }
 
+        if (j.HasMember("db-enable-blob-files"))
+        {
+            config.enableDbBlobFiles = j["db-enable-blob-files"].GetBool();
+        }
+
         if (j.HasMember("no-console"))
         {
             config.noConsole = j["no-console"].GetBool();
@@ -820,6 +922,26 @@ namespace DaemonConfig
             config.dbMaxFileSizeMB = j["db-max-file-size"].GetInt();
         }
 
+        if (j.HasMember("db-key-image-cache-size"))
+        {
+            config.dbKeyImageCacheSizeMB = j["db-key-image-cache-size"].GetInt();
+        }
+
+        if (j.HasMember("db-raw-block-cache-size"))
+        {
+            config.dbRawBlockCacheSizeMB = j["db-raw-block-cache-size"].GetInt();
+        }
+
+        if (j.HasMember("db-raw-block-block-size"))
+        {
+            config.dbRawBlockBlockSizeKB = j["db-raw-block-block-size"].GetInt();
+        }
+
+        if (j.HasMember("db-bloom-bits-per-key"))
+        {
+            config.dbBloomBitsPerKey = j["db-bloom-bits-per-key"].GetInt();
+        }
+
         if (j.HasMember("allow-local-ip"))
         {
             config.localIp = j["allow-local-ip"].GetBool();
@@ -940,11 +1062,16 @@ namespace DaemonConfig
         j.AddMember("no-console", config.noConsole, alloc);
         j.AddMember("db-enable-level-db", config.enableLevelDB, alloc);
         j.AddMember("db-enable-compression", config.enableDbCompression, alloc);
+        j.AddMember("db-enable-blob-files", config.enableDbBlobFiles, alloc);
         j.AddMember("db-max-open-files", config.dbMaxOpenFiles, alloc);
         j.AddMember("db-read-buffer-size", config.dbReadCacheSizeMB, alloc);
         j.AddMember("db-threads", config.dbThreads, alloc);
         j.AddMember("db-write-buffer-size", config.dbWriteBufferSizeMB, alloc);
         j.AddMember("db-max-file-size", config.dbMaxFileSizeMB, alloc);
+        j.AddMember("db-key-image-cache-size", config.dbKeyImageCacheSizeMB, alloc);
+        j.AddMember("db-raw-block-cache-size", config.dbRawBlockCacheSizeMB, alloc);
+        j.AddMember("db-raw-block-block-size", config.dbRawBlockBlockSizeKB, alloc);
+        j.AddMember("db-bloom-bits-per-key", config.dbBloomBitsPerKey, alloc);
         j.AddMember("allow-local-ip", config.localIp, alloc);
         j.AddMember("hide-my-port", config.hideMyPort, alloc);
         j.AddMember("p2p-bind-ip", config.p2pInterface, alloc);
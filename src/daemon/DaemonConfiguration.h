@@ -49,6 +49,11 @@ namespace DaemonConfig
             enableDbCompression = false;
             resync = false;
             enableLevelDB = false;
+            enableDbBlobFiles = false;
+            dbKeyImageCacheSizeMB = CryptoNote::ROCKSDB_KEY_IMAGE_CACHE_MB;
+            dbRawBlockCacheSizeMB = CryptoNote::ROCKSDB_RAW_BLOCK_CACHE_MB;
+            dbRawBlockBlockSizeKB = CryptoNote::ROCKSDB_RAW_BLOCK_BLOCK_SIZE_KB;
+            dbBloomBitsPerKey = CryptoNote::ROCKSDB_BLOOM_BITS_PER_KEY;
         }
 
         std::string dataDirectory;
@@ -95,6 +100,14 @@ namespace DaemonConfig
 
         uint64_t dbMaxFileSizeMB;
 
+        uint64_t dbKeyImageCacheSizeMB;
+
+        uint64_t dbRawBlockCacheSizeMB;
+
+        uint64_t dbRawBlockBlockSizeKB;
+
+        uint64_t dbBloomBitsPerKey;
+
         uint32_t rewindToHeight;
 
         bool noConsole;
@@ -130,6 +143,8 @@ namespace DaemonConfig
         bool dumpConfig;
 
         bool enableDbCompression;
+
+        bool enableDbBlobFiles;
     };
 
     DaemonConfiguration initConfiguration(const char *path);
@@ -6,8 +6,10 @@
 #include <miner/BlockUtilities.h>
 /////////////////////////////////
 
+#include <algorithm>
 #include <common/CryptoNoteTools.h>
 #include <common/Varint.h>
+#include <cstring>
 #include <serialization/CryptoNoteSerialization.h>
 #include <serialization/SerializationTools.h>
 
@@ -81,11 +83,50 @@ Crypto::Hash getMerkleRoot(const CryptoNote::BlockTemplate &block)
     return CryptoNote::getObjectHash(getBlockHashingBinaryArray(block));
 }
 
+std::vector<uint8_t> getBlockLongHashingBinaryArray(const CryptoNote::BlockTemplate &block)
+{
+    return block.majorVersion == CryptoNote::BLOCK_MAJOR_VERSION_1 ? getBlockHashingBinaryArray(block)
+                                                                    : getParentBlockHashingBinaryArray(block, true);
+}
+
+std::tuple<std::vector<uint8_t>, size_t>
+    getBlockLongHashingBinaryArrayAndNonceOffset(const CryptoNote::BlockTemplate &block)
+{
+    std::vector<uint8_t> rawHashingBlock = getBlockLongHashingBinaryArray(block);
+
+    /* Flip every bit of the nonce, so each of its bytes differs between the
+       two blobs, and nothing else does */
+    CryptoNote::BlockTemplate flippedNonceBlock = block;
+    flippedNonceBlock.nonce = ~block.nonce;
+
+    const std::vector<uint8_t> flippedNonceRawHashingBlock = getBlockLongHashingBinaryArray(flippedNonceBlock);
+
+    if (flippedNonceRawHashingBlock.size() != rawHashingBlock.size())
+    {
+        throw std::runtime_error("Nonce is not a fixed size field of the hashing blob");
+    }
+
+    const auto mismatch = std::mismatch(
+        rawHashingBlock.begin(), rawHashingBlock.end(), flippedNonceRawHashingBlock.begin());
+
+    const size_t nonceOffset = std::distance(rawHashingBlock.begin(), mismatch.first);
+
+    if (nonceOffset + sizeof(block.nonce) > rawHashingBlock.size()
+        || std::memcmp(&rawHashingBlock[nonceOffset], &block.nonce, sizeof(block.nonce)) != 0
+        || !std::equal(
+            rawHashingBlock.begin() + nonceOffset + sizeof(block.nonce),
+            rawHashingBlock.end(),
+            flippedNonceRawHashingBlock.begin() + nonceOffset + sizeof(block.nonce)))
+    {
+        throw std::runtime_error("Can't find the nonce in the hashing blob");
+    }
+
+    return {rawHashingBlock, nonceOffset};
+}
+
 Crypto::Hash getBlockLongHash(const CryptoNote::BlockTemplate &block)
 {
-    const std::vector<uint8_t> rawHashingBlock = block.majorVersion == CryptoNote::BLOCK_MAJOR_VERSION_1
-                                                     ? getBlockHashingBinaryArray(block)
-                                                     : getParentBlockHashingBinaryArray(block, true);
+    const std::vector<uint8_t> rawHashingBlock = getBlockLongHashingBinaryArray(block);
 
     Crypto::Hash hash;
 
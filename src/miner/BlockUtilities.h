@@ -8,6 +8,7 @@
 #include "CryptoTypes.h"
 
 #include <cstdint>
+#include <tuple>
 #include <vector>
 
 std::vector<uint8_t> getParentBlockBinaryArray(const CryptoNote::BlockTemplate &block, const bool headerOnly);
@@ -23,4 +24,13 @@ Crypto::Hash getBlockHash(const CryptoNote::BlockTemplate &block);
 
 Crypto::Hash getMerkleRoot(const CryptoNote::BlockTemplate &block);
 
+/* The blob the proof of work hash of the block is taken over */
+std::vector<uint8_t> getBlockLongHashingBinaryArray(const CryptoNote::BlockTemplate &block);
+
+/* The blob the proof of work hash of the block is taken over, and the offset
+   of the nonce within it, so the nonce can be changed by patching those bytes
+   rather than serializing the block again */
+std::tuple<std::vector<uint8_t>, size_t>
+    getBlockLongHashingBinaryArrayAndNonceOffset(const CryptoNote::BlockTemplate &block);
+
 Crypto::Hash getBlockLongHash(const CryptoNote::BlockTemplate &block);
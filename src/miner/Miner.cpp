@@ -10,8 +10,11 @@
 
 #include <common/CheckDifficulty.h>
 #include <common/StringTools.h>
+#include <config/CryptoNoteConfig.h>
 #include <crypto/crypto.h>
+#include <crypto/hash.h>
 #include <crypto/random.h>
+#include <cstring>
 #include <iostream>
 #include <miner/BlockUtilities.h>
 #include <system/InterruptedException.h>
@@ -26,13 +29,19 @@ namespace CryptoNote
     {
     }
 
-    BlockTemplate Miner::mine(const BlockMiningParameters &blockMiningParameters, size_t threadCount)
+    BlockTemplate
+        Miner::mine(const BlockMiningParameters &blockMiningParameters, size_t threadCount, size_t hashWidth)
     {
         if (threadCount == 0)
         {
             throw std::runtime_error("Miner requires at least one thread");
         }
 
+        if (hashWidth == 0)
+        {
+            throw std::runtime_error("Miner requires a hash width of at least one");
+        }
+
         if (m_state == MiningState::MINING_IN_PROGRESS)
         {
             throw std::runtime_error("Mining is already in progress");
@@ -41,7 +50,7 @@ namespace CryptoNote
         m_state = MiningState::MINING_IN_PROGRESS;
         m_miningStopped.clear();
 
-        runWorkers(blockMiningParameters, threadCount);
+        runWorkers(blockMiningParameters, threadCount, hashWidth);
 
         if (m_state == MiningState::MINING_STOPPED)
         {
@@ -62,7 +71,7 @@ namespace CryptoNote
         }
     }
 
-    void Miner::runWorkers(BlockMiningParameters blockMiningParameters, size_t threadCount)
+    void Miner::runWorkers(BlockMiningParameters blockMiningParameters, size_t threadCount, size_t hashWidth)
     {
         std::cout << InformationMsg("Started mining for difficulty of ")
                   << InformationMsg(blockMiningParameters.difficulty) << InformationMsg(". Good luck! ;)\n");
@@ -80,7 +89,8 @@ namespace CryptoNote
                         this,
                         blockMiningParameters.blockTemplate,
                         blockMiningParameters.difficulty,
-                        static_cast<uint32_t>(threadCount)))));
+                        static_cast<uint32_t>(threadCount),
+                        hashWidth))));
 
                 blockMiningParameters.blockTemplate.nonce++;
             }
@@ -97,29 +107,97 @@ namespace CryptoNote
         m_miningStopped.set();
     }
 
-    void Miner::workerFunc(const BlockTemplate &blockTemplate, uint64_t difficulty, uint32_t nonceStep)
+    void Miner::workerFunc(
+        const BlockTemplate &blockTemplate,
+        uint64_t difficulty,
+        uint32_t nonceStep,
+        size_t hashWidth)
     {
         try
         {
-            BlockTemplate block = blockTemplate;
+            const auto hashingAlgorithm = HASHING_ALGORITHMS_BY_BLOCK_VERSION.find(blockTemplate.majorVersion);
+
+            if (hashingAlgorithm == HASHING_ALGORITHMS_BY_BLOCK_VERSION.end())
+            {
+                throw std::runtime_error("Unknown block major version.");
+            }
+
+            const auto multiHashingAlgorithm =
+                MULTI_HASHING_ALGORITHMS_BY_BLOCK_VERSION.find(blockTemplate.majorVersion);
+
+            /* This block version can only be hashed one nonce at a time */
+            if (multiHashingAlgorithm == MULTI_HASHING_ALGORITHMS_BY_BLOCK_VERSION.end())
+            {
+                hashWidth = 1;
+            }
+
+            /* Allocate this thread's hashing memory once, rather than on every hash.
+               Each nonce hashed at once needs its own scratchpad. */
+            Crypto::HashingContext::reserve(static_cast<uint32_t>(CN_PAGE_SIZE * hashWidth));
+
+            /* Only the nonce changes between hashes, so serialize the block once,
+               and just overwrite the nonce in a copy of the blob for each hash */
+            const auto [rawHashingBlock, nonceOffset] = getBlockLongHashingBinaryArrayAndNonceOffset(blockTemplate);
+
+            /* This thread's nonces are nonce, nonce + nonceStep, nonce + 2 * nonceStep...
+               so each of the blobs takes the next one, and they all skip ahead past the
+               others' once hashed */
+            std::vector<uint32_t> nonces(hashWidth);
+
+            for (size_t i = 0; i < hashWidth; i++)
+            {
+                nonces[i] = blockTemplate.nonce + static_cast<uint32_t>(i) * nonceStep;
+            }
+
+            const uint32_t batchNonceStep = nonceStep * static_cast<uint32_t>(hashWidth);
+
+            std::vector<std::vector<uint8_t>> rawHashingBlocks(hashWidth, rawHashingBlock);
+            std::vector<const void *> rawHashingBlockPointers(hashWidth);
+            std::vector<Crypto::Hash> hashes(hashWidth);
+
+            for (size_t i = 0; i < hashWidth; i++)
+            {
+                rawHashingBlockPointers[i] = rawHashingBlocks[i].data();
+            }
 
             while (m_state == MiningState::MINING_IN_PROGRESS)
             {
-                Crypto::Hash hash = getBlockLongHash(block);
+                for (size_t i = 0; i < hashWidth; i++)
+                {
+                    std::memcpy(&rawHashingBlocks[i][nonceOffset], &nonces[i], sizeof(nonces[i]));
+                }
+
+                if (hashWidth == 1)
+                {
+                    hashingAlgorithm->second(rawHashingBlocks[0].data(), rawHashingBlocks[0].size(), hashes[0]);
+                }
+                else
+                {
+                    multiHashingAlgorithm->second(
+                        rawHashingBlockPointers.data(), rawHashingBlock.size(), hashes.data(), hashWidth);
+                }
 
-                if (check_hash(hash, difficulty))
+                for (size_t i = 0; i < hashWidth; i++)
                 {
-                    if (!setStateBlockFound())
+                    if (check_hash(hashes[i], difficulty))
                     {
+                        if (!setStateBlockFound())
+                        {
+                            return;
+                        }
+
+                        m_block = blockTemplate;
+                        m_block.nonce = nonces[i];
                         return;
                     }
-
-                    m_block = block;
-                    return;
                 }
 
-                incrementHashCount();
-                block.nonce += nonceStep;
+                incrementHashCount(hashWidth);
+
+                for (auto &nonce : nonces)
+                {
+                    nonce += batchNonceStep;
+                }
             }
         }
         catch (const std::exception &e)
@@ -163,9 +241,9 @@ namespace CryptoNote
         }
     }
 
-    void Miner::incrementHashCount()
+    void Miner::incrementHashCount(const uint64_t count)
     {
-        m_hash_count++;
+        m_hash_count += count;
     }
 
     uint64_t Miner::getHashCount()
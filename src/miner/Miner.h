@@ -28,7 +28,8 @@ namespace CryptoNote
       public:
         Miner(System::Dispatcher &dispatcher);
 
-        BlockTemplate mine(const BlockMiningParameters &blockMiningParameters, size_t threadCount);
+        /* Mines with threadCount threads, each hashing hashWidth nonces at once */
+        BlockTemplate mine(const BlockMiningParameters &blockMiningParameters, size_t threadCount, size_t hashWidth = 1);
 
         uint64_t getHashCount();
 
@@ -57,13 +58,13 @@ namespace CryptoNote
 
         std::mutex m_hashes_mutex;
 
-        void runWorkers(BlockMiningParameters blockMiningParameters, size_t threadCount);
+        void runWorkers(BlockMiningParameters blockMiningParameters, size_t threadCount, size_t hashWidth);
 
-        void workerFunc(const BlockTemplate &blockTemplate, uint64_t difficulty, uint32_t nonceStep);
+        void workerFunc(const BlockTemplate &blockTemplate, uint64_t difficulty, uint32_t nonceStep, size_t hashWidth);
 
         bool setStateBlockFound();
 
-        void incrementHashCount();
+        void incrementHashCount(uint64_t count);
     };
 
 } // namespace CryptoNote
@@ -174,7 +174,7 @@ namespace Miner
         m_contextGroup.spawn([this, params]() {
             try
             {
-                m_minedBlock = m_miner.mine(params, m_config.threadCount);
+                m_minedBlock = m_miner.mine(params, m_config.threadCount, m_config.hashWidth);
                 pushEvent(BlockMinedEvent());
             }
             catch (const std::exception &)
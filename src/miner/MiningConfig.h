@@ -28,6 +28,9 @@ namespace CryptoNote
 
         size_t threadCount;
 
+        /* How many nonces each thread hashes at once */
+        size_t hashWidth;
+
         size_t scanPeriod;
 
         size_t blocksLimit;
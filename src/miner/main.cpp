@@ -5,10 +5,15 @@
 
 #include "MinerManager.h"
 
+#include <crypto/hash.h>
 #include <system/Dispatcher.h>
 
 int main(int argc, char **argv)
 {
+    /* Pick the hashing implementations for this CPU before any mining
+       threads start */
+    Crypto::hash_select_impl();
+
     while (true)
     {
         CryptoNote::MiningConfig config;
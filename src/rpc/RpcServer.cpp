@@ -735,29 +735,34 @@ std::tuple<Error, uint16_t> RpcServer::getRandomOuts(
     rapidjson::StringBuffer sb;
     rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
 
+    std::vector<uint64_t> amounts;
+
+    for (const auto &jsonAmount : getArrayFromJSON(body, "amounts"))
+    {
+        amounts.push_back(jsonAmount.GetUint64());
+    }
+
+    std::unordered_map<uint64_t, CryptoNote::RandomOutputs> outputs;
+
+    const auto [success, error] = m_core->getRandomOutputs(amounts, static_cast<uint16_t>(numOutputs), outputs);
+
+    if (!success)
+    {
+        return {Error(CANT_GET_FAKE_OUTPUTS, error), 200};
+    }
+
     writer.StartObject();
 
     writer.Key("outs");
 
     writer.StartArray();
     {
-        for (const auto &jsonAmount : getArrayFromJSON(body, "amounts"))
+        for (const auto amount : amounts)
         {
             writer.StartObject();
 
-            const uint64_t amount = jsonAmount.GetUint64();
-
-            std::vector<uint32_t> globalIndexes;
-            std::vector<Crypto::PublicKey> publicKeys;
-
-            const auto [success, error] = m_core->getRandomOutputs(
-                amount, static_cast<uint16_t>(numOutputs), globalIndexes, publicKeys
-            );
-
-            if (!success)
-            {
-                return {Error(CANT_GET_FAKE_OUTPUTS, error), 200};
-            }
+            const auto &globalIndexes = outputs[amount].globalIndexes;
+            const auto &publicKeys = outputs[amount].publicKeys;
 
             if (globalIndexes.size() != numOutputs)
             {
@@ -1337,16 +1342,7 @@ std::tuple<Error, uint16_t> RpcServer::getLastBlockHeader(
     rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
 
     const auto height = m_core->getTopBlockIndex();
-    const auto hash = m_core->getBlockHashByIndex(height);
-    const auto topBlock = m_core->getBlockByHash(hash);
-    const auto outputs = topBlock.baseTransaction.outputs;
-    const auto extraDetails = m_core->getBlockDetails(hash);
-
-    const uint64_t reward = std::accumulate(outputs.begin(), outputs.end(), 0ull,
-        [](const auto acc, const auto out) {
-            return acc + out.amount;
-        }
-    );
+    const auto header = m_core->getBlockHeaders(height, height + 1).at(0);
 
     writer.StartObject();
 
@@ -1363,22 +1359,23 @@ std::tuple<Error, uint16_t> RpcServer::getLastBlockHeader(
         writer.StartObject();
         {
             writer.Key("major_version");
-            writer.Uint64(topBlock.majorVersion);
+            writer.Uint64(header.majorVersion);
 
             writer.Key("minor_version");
-            writer.Uint64(topBlock.minorVersion);
+            writer.Uint64(header.minorVersion);
 
             writer.Key("timestamp");
-            writer.Uint64(topBlock.timestamp);
+            writer.Uint64(header.timestamp);
 
             writer.Key("prev_hash");
-            writer.String(Common::podToHex(topBlock.previousBlockHash));
+            writer.String(Common::podToHex(header.previousBlockHash));
 
             writer.Key("nonce");
-            writer.Uint64(topBlock.nonce);
+            writer.Uint64(header.nonce);
 
+            /* Headers are only looked up on the main chain */
             writer.Key("orphan_status");
-            writer.Bool(extraDetails.isAlternative);
+            writer.Bool(false);
 
             writer.Key("height");
             writer.Uint64(height);
@@ -1387,19 +1384,19 @@ std::tuple<Error, uint16_t> RpcServer::getLastBlockHeader(
             writer.Uint64(0);
 
             writer.Key("hash");
-            writer.String(Common::podToHex(hash));
+            writer.String(Common::podToHex(header.blockHash));
 
             writer.Key("difficulty");
-            writer.Uint64(m_core->getBlockDifficulty(height));
+            writer.Uint64(header.difficulty);
 
             writer.Key("reward");
-            writer.Uint64(reward);
+            writer.Uint64(header.reward);
 
             writer.Key("num_txes");
-            writer.Uint64(extraDetails.transactions.size());
+            writer.Uint64(header.transactionCount);
 
             writer.Key("block_size");
-            writer.Uint64(extraDetails.blockSize);
+            writer.Uint64(header.blockSize);
         }
         writer.EndObject();
     }
@@ -1437,11 +1434,11 @@ std::tuple<Error, uint16_t> RpcServer::getBlockHeaderByHash(
         return {SUCCESS, 200};
     }
 
-    CryptoNote::BlockTemplate block;
+    CryptoNote::CachedBlockHeader header;
 
     try
     {
-        block = m_core->getBlockByHash(hash);
+        header = m_core->getBlockHeaderByHash(hash);
     }
     catch (const std::runtime_error &)
     {
@@ -1454,17 +1451,7 @@ std::tuple<Error, uint16_t> RpcServer::getBlockHeaderByHash(
         return {SUCCESS, 200};
     }
 
-    CryptoNote::CachedBlock cachedBlock(block);
-
-    const auto height = cachedBlock.getBlockIndex();
-    const auto outputs = block.baseTransaction.outputs;
-    const auto extraDetails = m_core->getBlockDetails(hash);
-
-    const uint64_t reward = std::accumulate(outputs.begin(), outputs.end(), 0ull,
-        [](const auto acc, const auto out) {
-            return acc + out.amount;
-        }
-    );
+    const auto height = header.blockIndex;
 
     writer.StartObject();
 
@@ -1481,22 +1468,23 @@ std::tuple<Error, uint16_t> RpcServer::getBlockHeaderByHash(
         writer.StartObject();
         {
             writer.Key("major_version");
-            writer.Uint64(block.majorVersion);
+            writer.Uint64(header.majorVersion);
 
             writer.Key("minor_version");
-            writer.Uint64(block.minorVersion);
+            writer.Uint64(header.minorVersion);
 
             writer.Key("timestamp");
-            writer.Uint64(block.timestamp);
+            writer.Uint64(header.timestamp);
 
             writer.Key("prev_hash");
-            writer.String(Common::podToHex(block.previousBlockHash));
+            writer.String(Common::podToHex(header.previousBlockHash));
 
             writer.Key("nonce");
-            writer.Uint64(block.nonce);
+            writer.Uint64(header.nonce);
 
+            /* Headers are only looked up on the main chain */
             writer.Key("orphan_status");
-            writer.Bool(extraDetails.isAlternative);
+            writer.Bool(false);
 
             writer.Key("height");
             writer.Uint64(height);
@@ -1505,19 +1493,19 @@ std::tuple<Error, uint16_t> RpcServer::getBlockHeaderByHash(
             writer.Uint64(topHeight - height);
 
             writer.Key("hash");
-            writer.String(Common::podToHex(hash));
+            writer.String(Common::podToHex(header.blockHash));
 
             writer.Key("difficulty");
-            writer.Uint64(m_core->getBlockDifficulty(height));
+            writer.Uint64(header.difficulty);
 
             writer.Key("reward");
-            writer.Uint64(reward);
+            writer.Uint64(header.reward);
 
             writer.Key("num_txes");
-            writer.Uint64(extraDetails.transactions.size());
+            writer.Uint64(header.transactionCount);
 
             writer.Key("block_size");
-            writer.Uint64(extraDetails.blockSize);
+            writer.Uint64(header.blockSize);
         }
         writer.EndObject();
     }
@@ -1554,17 +1542,7 @@ std::tuple<Error, uint16_t> RpcServer::getBlockHeaderByHeight(
         return {SUCCESS, 200};
     }
 
-    const auto hash = m_core->getBlockHashByIndex(height);
-    const auto block = m_core->getBlockByHash(hash);
-
-    const auto outputs = block.baseTransaction.outputs;
-    const auto extraDetails = m_core->getBlockDetails(hash);
-
-    const uint64_t reward = std::accumulate(outputs.begin(), outputs.end(), 0ull,
-        [](const auto acc, const auto out) {
-            return acc + out.amount;
-        }
-    );
+    const auto header = m_core->getBlockHeaders(height, height + 1).at(0);
 
     writer.StartObject();
 
@@ -1581,22 +1559,23 @@ std::tuple<Error, uint16_t> RpcServer::getBlockHeaderByHeight(
         writer.StartObject();
         {
             writer.Key("major_version");
-            writer.Uint64(block.majorVersion);
+            writer.Uint64(header.majorVersion);
 
             writer.Key("minor_version");
-            writer.Uint64(block.minorVersion);
+            writer.Uint64(header.minorVersion);
 
             writer.Key("timestamp");
-            writer.Uint64(block.timestamp);
+            writer.Uint64(header.timestamp);
 
             writer.Key("prev_hash");
-            writer.String(Common::podToHex(block.previousBlockHash));
+            writer.String(Common::podToHex(header.previousBlockHash));
 
             writer.Key("nonce");
-            writer.Uint64(block.nonce);
+            writer.Uint64(header.nonce);
 
+            /* Headers are only looked up on the main chain */
             writer.Key("orphan_status");
-            writer.Bool(extraDetails.isAlternative);
+            writer.Bool(false);
 
             writer.Key("height");
             writer.Uint64(height);
@@ -1605,19 +1584,19 @@ std::tuple<Error, uint16_t> RpcServer::getBlockHeaderByHeight(
             writer.Uint64(topHeight - height);
 
             writer.Key("hash");
-            writer.String(Common::podToHex(hash));
+            writer.String(Common::podToHex(header.blockHash));
 
             writer.Key("difficulty");
-            writer.Uint64(m_core->getBlockDifficulty(height));
+            writer.Uint64(header.difficulty);
 
             writer.Key("reward");
-            writer.Uint64(reward);
+            writer.Uint64(header.reward);
 
             writer.Key("num_txes");
-            writer.Uint64(extraDetails.transactions.size());
+            writer.Uint64(header.transactionCount);
 
             writer.Key("block_size");
-            writer.Uint64(extraDetails.blockSize);
+            writer.Uint64(header.blockSize);
         }
         writer.EndObject();
     }
@@ -1668,35 +1647,33 @@ std::tuple<Error, uint16_t> RpcServer::getBlocksByHeight(
         const uint64_t MAX_BLOCKS_COUNT = 30;
         const uint64_t startHeight = height < MAX_BLOCKS_COUNT ? 0 : height - MAX_BLOCKS_COUNT;
 
+        const auto headers = m_core->getBlockHeaders(startHeight, height + 1);
+
         writer.Key("blocks");
         writer.StartArray();
         {
-            for (uint64_t i = height; i >= startHeight; i--)
+            for (auto header = headers.rbegin(); header != headers.rend(); header++)
             {
                 writer.StartObject();
 
-                const auto hash = m_core->getBlockHashByIndex(i);
-                const auto block = m_core->getBlockByHash(hash);
-                const auto extraDetails = m_core->getBlockDetails(hash);
-
                 writer.Key("cumul_size");
-                writer.Uint64(extraDetails.blockSize);
+                writer.Uint64(header->blockSize);
 
                 writer.Key("difficulty");
-                writer.Uint64(extraDetails.difficulty);
+                writer.Uint64(header->difficulty);
 
                 writer.Key("hash");
-                writer.String(Common::podToHex(hash));
+                writer.String(Common::podToHex(header->blockHash));
 
                 writer.Key("height");
-                writer.Uint64(i);
+                writer.Uint64(header->blockIndex);
 
                 writer.Key("timestamp");
-                writer.Uint64(block.timestamp);
+                writer.Uint64(header->timestamp);
 
-                /* Plus one for coinbase tx */
+                /* Includes the coinbase tx */
                 writer.Key("tx_count");
-                writer.Uint64(block.transactionHashes.size() + 1);
+                writer.Uint64(header->transactionCount);
 
                 writer.EndObject();
             }
@@ -15,6 +15,7 @@
 #include "cryptonotecore/CryptoNoteFormatUtils.h"
 #include "cryptonotecore/TransactionApi.h"
 
+#include <algorithm>
 #include <config/Constants.h>
 #include <future>
 #include <numeric>
@@ -66,18 +67,10 @@ namespace
 
     void findMyOutputs(
         const ITransactionReader &tx,
-        const SecretKey &viewSecretKey,
+        const KeyDerivation &derivation,
         const std::unordered_set<PublicKey> &spendKeys,
         std::unordered_map<PublicKey, std::vector<uint32_t>> &outputs)
     {
-        auto txPublicKey = tx.getTransactionPublicKey();
-        KeyDerivation derivation;
-
-        if (!generate_key_derivation(txPublicKey, viewSecretKey, derivation))
-        {
-            return;
-        }
-
         size_t keyIndex = 0;
         size_t outputCount = tx.getOutputCount();
 
@@ -253,12 +246,26 @@ namespace CryptoNote
             workers = 2;
         }
 
-        BlockingQueue<Tx> inputQueue(workers * 2);
+        size_t transactionCount = 0;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            transactionCount += blocks[i].transactions.size();
+        }
+
+        /* Transactions are handed to the workers in batches, so their key
+           derivations can be computed together. Keep the batches small enough
+           that every worker gets some. */
+        const size_t transactionsPerBatch = std::clamp<size_t>(transactionCount / workers, 1, 64);
+
+        BlockingQueue<std::vector<Tx>> inputQueue(workers * 2);
 
         std::atomic<bool> stopProcessing(false);
         std::atomic<size_t> emptyBlockCount(0);
 
         auto pushingThread = std::async(std::launch::async, [&] {
+            std::vector<Tx> batch;
+
             for (uint32_t i = 0; i < count && !stopProcessing; ++i)
             {
                 const auto &block = blocks[i].block;
@@ -296,31 +303,62 @@ namespace CryptoNote
                     }
 
                     Tx item = {blockInfo, tx.get(), isLastTransactionInBlock};
-                    inputQueue.push(item);
+                    batch.push_back(item);
                     ++blockInfo.transactionIndex;
+
+                    if (batch.size() >= transactionsPerBatch)
+                    {
+                        inputQueue.push(std::move(batch));
+                        batch.clear();
+                    }
                 }
             }
 
+            if (!batch.empty())
+            {
+                inputQueue.push(std::move(batch));
+            }
+
             inputQueue.close();
         });
 
         auto processingFunction = [&] {
-            Tx item;
+            std::vector<Tx> batch;
             std::error_code ec;
-            while (!stopProcessing && inputQueue.pop(item))
+            while (!stopProcessing && !ec && inputQueue.pop(batch))
             {
-                PreprocessedTx output;
-                static_cast<Tx &>(output) = item;
+                std::vector<PublicKey> transactionPublicKeys;
 
-                ec = preprocessOutputs(item.blockInfo, *item.tx, output);
-                if (ec)
+                for (const auto &item : batch)
                 {
-                    stopProcessing = true;
-                    break;
+                    transactionPublicKeys.push_back(item.tx->getTransactionPublicKey());
                 }
 
-                std::lock_guard<std::mutex> lk(preprocessedTransactionsMutex);
-                preprocessedTransactions.push_back(std::move(output));
+                std::vector<KeyDerivation> derivations;
+                std::vector<bool> validDerivations;
+
+                crypto_ops::generateKeyDerivations(
+                    transactionPublicKeys, m_viewSecret, derivations, validDerivations);
+
+                for (size_t i = 0; i < batch.size(); ++i)
+                {
+                    PreprocessedTx output;
+                    static_cast<Tx &>(output) = batch[i];
+
+                    /* An invalid transaction public key can't have any of our outputs */
+                    if (validDerivations[i])
+                    {
+                        ec = preprocessOutputs(batch[i].blockInfo, *batch[i].tx, derivations[i], output);
+                        if (ec)
+                        {
+                            stopProcessing = true;
+                            break;
+                        }
+                    }
+
+                    std::lock_guard<std::mutex> lk(preprocessedTransactionsMutex);
+                    preprocessedTransactions.push_back(std::move(output));
+                }
             }
             return ec;
         };
@@ -577,11 +615,27 @@ namespace CryptoNote
         const TransactionBlockInfo &blockInfo,
         const ITransactionReader &tx,
         PreprocessInfo &info)
+    {
+        KeyDerivation derivation;
+
+        if (!generate_key_derivation(tx.getTransactionPublicKey(), m_viewSecret, derivation))
+        {
+            return std::error_code();
+        }
+
+        return preprocessOutputs(blockInfo, tx, derivation, info);
+    }
+
+    std::error_code TransfersConsumer::preprocessOutputs(
+        const TransactionBlockInfo &blockInfo,
+        const ITransactionReader &tx,
+        const KeyDerivation &derivation,
+        PreprocessInfo &info)
     {
         std::unordered_map<PublicKey, std::vector<uint32_t>> outputs;
         try
         {
-            findMyOutputs(tx, m_viewSecret, m_spendKeys, outputs);
+            findMyOutputs(tx, derivation, m_spendKeys, outputs);
         }
         catch (const std::exception &e)
         {
@@ -80,6 +80,12 @@ namespace CryptoNote
             const ITransactionReader &tx,
             PreprocessInfo &info);
 
+        std::error_code preprocessOutputs(
+            const TransactionBlockInfo &blockInfo,
+            const ITransactionReader &tx,
+            const Crypto::KeyDerivation &derivation,
+            PreprocessInfo &info);
+
         std::error_code processTransaction(const TransactionBlockInfo &blockInfo, const ITransactionReader &tx);
 
         void processTransaction(
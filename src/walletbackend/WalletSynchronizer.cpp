@@ -225,12 +225,16 @@ void WalletSynchronizer::blockProcessingThread()
         /* Process blocks while we've got more to process */
         while (!chunk.empty() && !m_shouldStop)
         {
-            for (const auto &[block, arrivalIndex] : chunk)
+            const auto derivations = generateKeyDerivations(chunk);
+
+            for (size_t i = 0; i < chunk.size(); i++)
             {
+                const auto &[block, arrivalIndex] = chunk[i];
+
                 Logger::logger.log(
                     "Processing block " + std::to_string(block.blockHeight), Logger::DEBUG, {Logger::SYNC});
 
-                auto ourInputs = processBlockOutputs(block);
+                auto ourInputs = processBlockOutputs(block, derivations[i]);
 
                 std::unordered_map<Crypto::Hash, std::vector<uint64_t>> globalIndexes;
 
@@ -299,23 +303,93 @@ void WalletSynchronizer::blockProcessingThread()
     }
 }
 
-std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>>
-    WalletSynchronizer::processBlockOutputs(const WalletTypes::WalletBlockInfo &block) const
+std::vector<std::vector<std::optional<Crypto::KeyDerivation>>> WalletSynchronizer::generateKeyDerivations(
+    const std::vector<std::tuple<WalletTypes::WalletBlockInfo, uint32_t>> &blocks) const
+{
+    std::vector<Crypto::PublicKey> transactionPublicKeys;
+
+    for (const auto &[block, arrivalIndex] : blocks)
+    {
+        if (!Config::config.wallet.skipCoinbaseTransactions && block.coinbaseTransaction)
+        {
+            transactionPublicKeys.push_back(block.coinbaseTransaction->transactionPublicKey);
+        }
+
+        for (const auto &tx : block.transactions)
+        {
+            transactionPublicKeys.push_back(tx.transactionPublicKey);
+        }
+    }
+
+    /* Derive every transaction in the chunk at once, which is much cheaper
+       than deriving them one by one */
+    std::vector<Crypto::KeyDerivation> derivations;
+    std::vector<bool> valid;
+
+    Crypto::crypto_ops::generateKeyDerivations(transactionPublicKeys, m_privateViewKey, derivations, valid);
+
+    std::vector<std::vector<std::optional<Crypto::KeyDerivation>>> result(blocks.size());
+
+    size_t derivationIndex = 0;
+
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        const auto &block = std::get<0>(blocks[i]);
+
+        size_t transactionCount = block.transactions.size();
+
+        if (!Config::config.wallet.skipCoinbaseTransactions && block.coinbaseTransaction)
+        {
+            transactionCount++;
+        }
+
+        for (size_t j = 0; j < transactionCount; j++, derivationIndex++)
+        {
+            if (valid[derivationIndex])
+            {
+                result[i].push_back(derivations[derivationIndex]);
+            }
+            else
+            {
+                result[i].push_back(std::nullopt);
+            }
+        }
+    }
+
+    return result;
+}
+
+std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> WalletSynchronizer::processBlockOutputs(
+    const WalletTypes::WalletBlockInfo &block,
+    const std::vector<std::optional<Crypto::KeyDerivation>> &derivations) const
 {
     std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> inputs;
 
+    auto derivation = derivations.begin();
+
     if (!Config::config.wallet.skipCoinbaseTransactions && block.coinbaseTransaction)
     {
-        const auto newInputs = processTransactionOutputs(*(block.coinbaseTransaction), block.blockHeight);
+        if (*derivation)
+        {
+            const auto newInputs =
+                processTransactionOutputs(*(block.coinbaseTransaction), **derivation, block.blockHeight);
+
+            inputs.insert(inputs.end(), newInputs.begin(), newInputs.end());
+        }
 
-        inputs.insert(inputs.end(), newInputs.begin(), newInputs.end());
+        derivation++;
     }
 
     for (const auto &tx : block.transactions)
     {
-        const auto newInputs = processTransactionOutputs(tx, block.blockHeight);
+        if (*derivation)
+        {
+            const auto newInputs = processTransactionOutputs(tx, **derivation, block.blockHeight);
+
+            inputs.insert(inputs.end(), newInputs.begin(), newInputs.end());
+        }
 
-        inputs.insert(inputs.end(), newInputs.begin(), newInputs.end());
+        derivation++;
     }
 
     return inputs;
@@ -536,14 +610,11 @@ std::tuple<std::optional<WalletTypes::Transaction>, std::vector<std::tuple<Crypt
 
 std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> WalletSynchronizer::processTransactionOutputs(
     const WalletTypes::RawCoinbaseTransaction &rawTX,
+    const Crypto::KeyDerivation &derivation,
     const uint64_t blockHeight) const
 {
     std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> inputs;
 
-    Crypto::KeyDerivation derivation;
-
-    Crypto::generate_key_derivation(rawTX.transactionPublicKey, m_privateViewKey, derivation);
-
     const std::vector<Crypto::PublicKey> spendKeys = m_subWallets->m_publicSpendKeys;
 
     uint64_t outputIndex = 0;
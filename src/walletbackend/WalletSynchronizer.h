@@ -117,8 +117,16 @@ class WalletSynchronizer
 
     void blockProcessingThread();
 
-    std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>>
-        processBlockOutputs(const WalletTypes::WalletBlockInfo &block) const;
+    /* Generates the key derivation of every transaction we scan in the given
+       blocks. Returns the derivations of each block, in the order
+       processBlockOutputs scans them, with nullopt for invalid transaction
+       public keys */
+    std::vector<std::vector<std::optional<Crypto::KeyDerivation>>> generateKeyDerivations(
+        const std::vector<std::tuple<WalletTypes::WalletBlockInfo, uint32_t>> &blocks) const;
+
+    std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> processBlockOutputs(
+        const WalletTypes::WalletBlockInfo &block,
+        const std::vector<std::optional<Crypto::KeyDerivation>> &derivations) const;
 
     void completeBlockProcessing(
         const WalletTypes::WalletBlockInfo &block,
@@ -139,7 +147,10 @@ class WalletSynchronizer
             const WalletTypes::RawTransaction &tx) const;
 
     std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>>
-        processTransactionOutputs(const WalletTypes::RawCoinbaseTransaction &rawTX, const uint64_t blockHeight) const;
+        processTransactionOutputs(
+            const WalletTypes::RawCoinbaseTransaction &rawTX,
+            const Crypto::KeyDerivation &derivation,
+            const uint64_t blockHeight) const;
 
     std::unordered_map<Crypto::Hash, std::vector<uint64_t>> getGlobalIndexes(const uint64_t blockHeight) const;
 